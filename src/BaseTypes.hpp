@@ -1,6 +1,7 @@
 #ifndef _GPS_BASE_BASETYPES_HPP_
 #define _GPS_BASE_BASETYPES_HPP_
 
+#include <cstdint>
 #include <vector>
 #include <base/Time.hpp>
 #include <base/Pose.hpp>
@@ -104,31 +105,73 @@ namespace gps_base
         CONSTELLATION_GLONASS,
         CONSTELLATION_GALILEO,
         CONSTELLATION_BEIDOU,
-        CONSTELLATION_QZSS
+        CONSTELLATION_QZSS,
+        CONSTELLATION_UNKNOWN
     };
+
+    namespace details {
+        /** Size of the PRN-to-constellation lookup table */
+        static const int PRN_TABLE_SIZE = 512;
+
+        struct PRNConstellationTable {
+            unsigned char constellations[PRN_TABLE_SIZE];
+        };
+
+        constexpr CONSTELLATIONS getConstellationFromPRNRanges(int prn)
+        {
+            return
+                (prn >= 1 && prn <= 32) ? CONSTELLATION_GPS :
+                ((prn >= 33 && prn <= 64) || (prn >= 152 && prn <= 158)) ? CONSTELLATION_SBAS :
+                (prn >= 65 && prn <= 96) ? CONSTELLATION_GLONASS :
+                (prn >= 301 && prn <= 336) ? CONSTELLATION_GALILEO :
+                (prn >= 401 && prn <= 437) ? CONSTELLATION_BEIDOU :
+                (prn >= 193 && prn <= 202) ? CONSTELLATION_QZSS :
+                CONSTELLATION_UNKNOWN;
+        }
+
+        constexpr PRNConstellationTable makePRNConstellationTable()
+        {
+            PRNConstellationTable table {};
+            for (int prn = 0; prn < PRN_TABLE_SIZE; ++prn)
+                table.constellations[prn] = getConstellationFromPRNRanges(prn);
+            return table;
+        }
+
+        /** Holder for the lookup table
+         *
+         * It is a template so that the table can be defined in the header
+         * while having a single definition program-wide
+         */
+        template<typename T = void>
+        struct PRNConstellations {
+            static constexpr PRNConstellationTable table = makePRNConstellationTable();
+        };
+
+        template<typename T>
+        constexpr PRNConstellationTable PRNConstellations<T>::table;
+    }
+
     struct Satellite {
         int PRN;
         int elevation;
         int azimuth;
         double SNR;
 
-        static CONSTELLATIONS getConstellationFromPRN(int prn)
+        /** Constellation of a satellite given its (NMEA) PRN
+         *
+         * Returns CONSTELLATION_UNKNOWN for PRNs that are not assigned to
+         * any known constellation
+         */
+        static constexpr CONSTELLATIONS getConstellationFromPRN(int prn)
         {
-            if (prn < 33)
-                return CONSTELLATION_GPS;
-            else if ((prn < 65) || ((prn >= 152) && (prn <= 158)))
-                return CONSTELLATION_SBAS;
-            else if ((prn >= 301) && (prn <= 336))
-                return CONSTELLATION_GALILEO;
-            else if ((prn >= 401) && (prn <= 437))
-                return CONSTELLATION_BEIDOU;
-            else if ((prn >= 193) && (prn <= 202))
-                return CONSTELLATION_QZSS;
-            else
-                return CONSTELLATION_GLONASS;
+            return (prn < 0 || prn >= details::PRN_TABLE_SIZE) ?
+                CONSTELLATION_UNKNOWN :
+                static_cast<CONSTELLATIONS>(
+                    details::PRNConstellations<>::table.constellations[prn]
+                );
         }
 
-        CONSTELLATIONS getConstellation() const
+        constexpr CONSTELLATIONS getConstellation() const
         {
             return getConstellationFromPRN(PRN);
         }
@@ -155,6 +198,13 @@ namespace gps_base
         gps_base::SatelliteInfo  satellites;
     };
 
+    /** Reference of the heights computed by the UTM conversions */
+    enum HEIGHT_REFERENCE
+    {
+        HEIGHT_ORTHOMETRIC = 0, //! Height above the geoid, i.e. above mean sea level
+        HEIGHT_ELLIPSOIDAL = 1  //! Height above the WGS84 ellipsoid
+    };
+
     /**
      * Set of parameters used to setup GPS-to-local cartesian coordinates
      * conversion
@@ -169,6 +219,85 @@ namespace gps_base
         /** North or south of the equator
          */
         bool utm_north = true;
+        /** Reference of the output heights
+         *
+         * See UTMConverter::setGeoidModel for how the heights are computed
+         */
+        HEIGHT_REFERENCE height_reference = HEIGHT_ORTHOMETRIC;
+    };
+
+    /** Usage and cost of the UTMConverter conversions
+     *
+     * The counters are process-wide, i.e. cover all converters. They are
+     * only updated if the library is built with the GPS_BASE_INSTRUMENTATION
+     * CMake option, and are otherwise zero.
+     *
+     * Conversions that call other conversions are counted once, in the
+     * direction of the outermost call. Batch conversions count each point.
+     */
+    struct UTMConverterStatistics {
+        base::Time time;
+        /** Whether the library was built with instrumentation */
+        bool enabled = false;
+
+        /** Number of points converted from GPS to UTM */
+        std::uint64_t gpsToUTM = 0;
+        /** Number of points converted from GPS to NWU */
+        std::uint64_t gpsToNWU = 0;
+        /** Number of points converted from UTM to GPS */
+        std::uint64_t utmToGPS = 0;
+        /** Number of points converted from NWU to GPS */
+        std::uint64_t nwuToGPS = 0;
+        /** Number of times the GDAL coordinate transformations were created */
+        std::uint64_t transformRebuilds = 0;
+        /** Number of failures reported by GDAL, when creating the coordinate
+         * transformations or transforming points
+         */
+        std::uint64_t transformFailures = 0;
+        /** Number of invalid states returned because the input had no
+         * solution
+         */
+        std::uint64_t invalidSamples = 0;
+
+        /** Number of calls whose cost was measured
+         *
+         * One call in UTMConverter::COST_SAMPLING_PERIOD is measured, per
+         * thread
+         */
+        std::uint64_t sampledCalls = 0;
+        /** Histogram of the cost per converted point of the sampled calls
+         *
+         * Element i counts the calls whose cost was in [2^i, 2^(i+1))
+         * nanoseconds, the first element also counting costs below one
+         * nanosecond.
+         */
+        std::vector<std::uint64_t> costHistogram;
+    };
+
+    /** Outcome of a conversion into single-precision coordinates
+     *
+     * See UTMConverter::convertToNWUFloat
+     */
+    struct FloatConversionReport {
+        /** Number of converted points */
+        std::size_t count = 0;
+        /** Largest absolute coordinate that is stored within the requested
+         * tolerance
+         */
+        double range = 0;
+        /** Largest absolute coordinate of the valid points */
+        double maxCoordinate = 0;
+        /** Number of points that have non-finite coordinates */
+        std::size_t invalid = 0;
+        /** Number of valid points with a coordinate beyond range, i.e. whose
+         * precision may be worse than the requested tolerance
+         */
+        std::size_t outOfRange = 0;
+        /** Index of the first point beyond range, or count if there is none */
+        std::size_t firstOutOfRange = 0;
+
+        /** Whether all valid points are stored within the tolerance */
+        bool isWithinTolerance() const { return outOfRange == 0; }
     };
 
 }
@@ -0,0 +1,180 @@
+#include <gps_base/CompactTypes.hpp>
+
+#include <base/Float.hpp>
+#include <stdexcept>
+
+using namespace gps_base;
+using namespace std;
+
+PRNSet::PRNSet()
+{
+}
+
+PRNSet::PRNSet(vector<int> const& prns)
+{
+    for (int prn : prns) {
+        insert(prn);
+    }
+}
+
+void PRNSet::insert(int prn)
+{
+    if (prn < 0 || prn >= MAX_PRN) {
+        throw std::out_of_range("PRNSet::insert: PRN " + to_string(prn) +
+                                " is out of range");
+    }
+    mBits.set(prn);
+}
+
+void PRNSet::erase(int prn)
+{
+    if (prn >= 0 && prn < MAX_PRN) {
+        mBits.reset(prn);
+    }
+}
+
+bool PRNSet::contains(int prn) const
+{
+    return prn >= 0 && prn < MAX_PRN && mBits.test(prn);
+}
+
+size_t PRNSet::size() const
+{
+    return mBits.count();
+}
+
+bool PRNSet::empty() const
+{
+    return mBits.none();
+}
+
+void PRNSet::clear()
+{
+    mBits.reset();
+}
+
+vector<int> PRNSet::toVector() const
+{
+    vector<int> result;
+    result.reserve(size());
+    for (int prn = 0; prn < MAX_PRN; ++prn) {
+        if (mBits.test(prn)) {
+            result.push_back(prn);
+        }
+    }
+    return result;
+}
+
+bool PRNSet::operator ==(PRNSet const& other) const
+{
+    return mBits == other.mBits;
+}
+
+bool PRNSet::operator !=(PRNSet const& other) const
+{
+    return mBits != other.mBits;
+}
+
+CompactSatelliteInfo::CompactSatelliteInfo()
+    : count(0)
+{
+}
+
+CompactSatelliteInfo::CompactSatelliteInfo(SatelliteInfo const& info)
+    : time(info.time)
+    , count(0)
+{
+    if (info.knownSatellites.size() > MAX_SATELLITES) {
+        throw std::length_error(
+            "CompactSatelliteInfo: cannot hold " +
+            to_string(info.knownSatellites.size()) + " satellites, the maximum is " +
+            to_string(MAX_SATELLITES)
+        );
+    }
+
+    for (auto const& satellite : info.knownSatellites) {
+        add(satellite);
+    }
+}
+
+size_t CompactSatelliteInfo::size() const
+{
+    return count;
+}
+
+bool CompactSatelliteInfo::empty() const
+{
+    return count == 0;
+}
+
+bool CompactSatelliteInfo::full() const
+{
+    return count == MAX_SATELLITES;
+}
+
+void CompactSatelliteInfo::clear()
+{
+    count = 0;
+}
+
+bool CompactSatelliteInfo::add(Satellite const& satellite)
+{
+    if (full()) {
+        return false;
+    }
+
+    prn[count] = satellite.PRN;
+    elevation[count] = satellite.elevation;
+    azimuth[count] = satellite.azimuth;
+    snr[count] = satellite.SNR;
+    ++count;
+    return true;
+}
+
+Satellite CompactSatelliteInfo::get(size_t i) const
+{
+    Satellite satellite;
+    satellite.PRN = prn[i];
+    satellite.elevation = elevation[i];
+    satellite.azimuth = azimuth[i];
+    satellite.SNR = snr[i];
+    return satellite;
+}
+
+SatelliteInfo CompactSatelliteInfo::toSatelliteInfo() const
+{
+    SatelliteInfo info;
+    info.time = time;
+    info.knownSatellites.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        info.knownSatellites[i] = get(i);
+    }
+    return info;
+}
+
+CompactSolutionQuality::CompactSolutionQuality()
+    : pdop(base::unknown<double>())
+    , hdop(base::unknown<double>())
+    , vdop(base::unknown<double>())
+{
+}
+
+CompactSolutionQuality::CompactSolutionQuality(SolutionQuality const& quality)
+    : time(quality.time)
+    , usedSatellites(quality.usedSatellites)
+    , pdop(quality.pdop)
+    , hdop(quality.hdop)
+    , vdop(quality.vdop)
+{
+}
+
+SolutionQuality CompactSolutionQuality::toSolutionQuality() const
+{
+    SolutionQuality quality;
+    quality.time = time;
+    quality.usedSatellites = usedSatellites.toVector();
+    quality.pdop = pdop;
+    quality.hdop = hdop;
+    quality.vdop = vdop;
+    return quality;
+}
@@ -0,0 +1,115 @@
+#ifndef GPS_BASE_COMPACTTYPES_HPP
+#define GPS_BASE_COMPACTTYPES_HPP
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <gps_base/BaseTypes.hpp>
+
+namespace gps_base
+{
+    /** Maximum number of satellites a CompactSatelliteInfo can hold */
+    static const int MAX_SATELLITES = 128;
+    /** Upper bound (exclusive) of the PRNs a PRNSet can hold */
+    static const int MAX_PRN = 512;
+
+    /** Set of satellite PRNs, as a bitset over the PRN space
+     *
+     * Allocation-free replacement for SolutionQuality::usedSatellites
+     */
+    class PRNSet
+    {
+        std::bitset<MAX_PRN> mBits;
+
+    public:
+        PRNSet();
+        explicit PRNSet(std::vector<int> const& prns);
+
+        /** Add a PRN to the set
+         *
+         * @throw std::out_of_range if the PRN is not within [0, MAX_PRN)
+         */
+        void insert(int prn);
+        /** Remove a PRN from the set, does nothing if it is not in it */
+        void erase(int prn);
+        /** Whether the PRN is in the set. Out-of-range PRNs are never in it */
+        bool contains(int prn) const;
+        /** Number of PRNs in the set */
+        std::size_t size() const;
+        bool empty() const;
+        void clear();
+
+        /** The PRNs in the set, in increasing order */
+        std::vector<int> toVector() const;
+
+        bool operator ==(PRNSet const& other) const;
+        bool operator !=(PRNSet const& other) const;
+    };
+
+    /** Fixed-capacity version of SatelliteInfo
+     *
+     * The satellites are stored as a structure of arrays, in the smallest
+     * types that can represent each field. It does not allocate, and can
+     * hold up to MAX_SATELLITES satellites.
+     */
+    struct CompactSatelliteInfo
+    {
+        base::Time time;
+        /** Number of valid entries in the arrays */
+        std::uint16_t count;
+        std::int16_t prn[MAX_SATELLITES];
+        /** Elevation in degrees */
+        std::int8_t elevation[MAX_SATELLITES];
+        /** Azimuth in degrees */
+        std::int16_t azimuth[MAX_SATELLITES];
+        float snr[MAX_SATELLITES];
+
+        CompactSatelliteInfo();
+        /** Convert a SatelliteInfo
+         *
+         * @throw std::length_error if it has more than MAX_SATELLITES
+         *   satellites
+         */
+        explicit CompactSatelliteInfo(SatelliteInfo const& info);
+
+        std::size_t size() const;
+        bool empty() const;
+        bool full() const;
+        void clear();
+
+        /** Append a satellite
+         *
+         * @return false if the container is full, in which case the satellite
+         *   is not added
+         */
+        bool add(Satellite const& satellite);
+
+        /** Return the i-th satellite */
+        Satellite get(std::size_t i) const;
+
+        SatelliteInfo toSatelliteInfo() const;
+    };
+
+    /** SolutionQuality with the used satellites stored as a PRNSet */
+    struct CompactSolutionQuality
+    {
+        base::Time time;
+        PRNSet usedSatellites;
+        double pdop;
+        double hdop;
+        double vdop;
+
+        CompactSolutionQuality();
+        /** Convert a SolutionQuality
+         *
+         * @throw std::out_of_range if one of the used satellites' PRN is
+         *   not within [0, MAX_PRN)
+         */
+        explicit CompactSolutionQuality(SolutionQuality const& quality);
+
+        SolutionQuality toSolutionQuality() const;
+    };
+}
+
+#endif
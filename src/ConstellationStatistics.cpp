@@ -0,0 +1,99 @@
+#include <gps_base/ConstellationStatistics.hpp>
+
+#include <algorithm>
+#include <base/Float.hpp>
+#include <limits>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    /** Accumulators for all constellations, stored as arrays so that the
+     * per-satellite update has no branches
+     */
+    struct Accumulator {
+        int count[CONSTELLATION_COUNT];
+        int usedCount[CONSTELLATION_COUNT];
+        double sumSNR[CONSTELLATION_COUNT];
+        double minSNR[CONSTELLATION_COUNT];
+        double maxSNR[CONSTELLATION_COUNT];
+        double sumElevation[CONSTELLATION_COUNT];
+
+        Accumulator() {
+            for (int i = 0; i < CONSTELLATION_COUNT; ++i) {
+                count[i] = 0;
+                usedCount[i] = 0;
+                sumSNR[i] = 0;
+                minSNR[i] = numeric_limits<double>::infinity();
+                maxSNR[i] = -numeric_limits<double>::infinity();
+                sumElevation[i] = 0;
+            }
+        }
+
+        void add(int prn, double elevation, double snr, bool used) {
+            int c = Satellite::getConstellationFromPRN(prn);
+            count[c] += 1;
+            usedCount[c] += used;
+            sumSNR[c] += snr;
+            minSNR[c] = std::min(minSNR[c], snr);
+            maxSNR[c] = std::max(maxSNR[c], snr);
+            sumElevation[c] += elevation;
+        }
+
+        PerConstellationStatistics result() const {
+            PerConstellationStatistics stats;
+            for (int i = 0; i < CONSTELLATION_COUNT; ++i) {
+                ConstellationStatistics& s = stats.constellations[i];
+                s.count = count[i];
+                s.usedCount = usedCount[i];
+                if (count[i]) {
+                    s.meanSNR = sumSNR[i] / count[i];
+                    s.minSNR = minSNR[i];
+                    s.maxSNR = maxSNR[i];
+                    s.meanElevation = sumElevation[i] / count[i];
+                }
+                else {
+                    s.meanSNR = base::unknown<double>();
+                    s.minSNR = base::unknown<double>();
+                    s.maxSNR = base::unknown<double>();
+                    s.meanElevation = base::unknown<double>();
+                }
+            }
+            return stats;
+        }
+    };
+}
+
+PerConstellationStatistics gps_base::computeConstellationStatistics(
+    SatelliteInfo const& info, PRNSet const& used)
+{
+    Accumulator acc;
+    for (auto const& satellite : info.knownSatellites) {
+        acc.add(satellite.PRN, satellite.elevation, satellite.SNR,
+                used.contains(satellite.PRN));
+    }
+    return acc.result();
+}
+
+PerConstellationStatistics gps_base::computeConstellationStatistics(
+    SatelliteInfo const& info, SolutionQuality const& quality)
+{
+    PRNSet used;
+    for (int prn : quality.usedSatellites) {
+        if (prn >= 0 && prn < MAX_PRN) {
+            used.insert(prn);
+        }
+    }
+    return computeConstellationStatistics(info, used);
+}
+
+PerConstellationStatistics gps_base::computeConstellationStatistics(
+    CompactSatelliteInfo const& info, PRNSet const& used)
+{
+    Accumulator acc;
+    for (size_t i = 0; i < info.count; ++i) {
+        acc.add(info.prn[i], info.elevation[i], info.snr[i],
+                used.contains(info.prn[i]));
+    }
+    return acc.result();
+}
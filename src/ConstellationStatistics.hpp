@@ -0,0 +1,54 @@
+#ifndef GPS_BASE_CONSTELLATIONSTATISTICS_HPP
+#define GPS_BASE_CONSTELLATIONSTATISTICS_HPP
+
+#include <gps_base/BaseTypes.hpp>
+#include <gps_base/CompactTypes.hpp>
+
+namespace gps_base
+{
+    /** Number of values in CONSTELLATIONS, including CONSTELLATION_UNKNOWN */
+    static const int CONSTELLATION_COUNT = CONSTELLATION_UNKNOWN + 1;
+
+    /** Statistics about the satellites of a single constellation
+     *
+     * The SNR and elevation fields are NaN if count is zero
+     */
+    struct ConstellationStatistics {
+        /** Number of known satellites */
+        int count;
+        /** Number of satellites used in the solution */
+        int usedCount;
+        double meanSNR;
+        double minSNR;
+        double maxSNR;
+        /** Mean elevation in degrees */
+        double meanElevation;
+    };
+
+    /** ConstellationStatistics for every CONSTELLATIONS value */
+    struct PerConstellationStatistics {
+        ConstellationStatistics constellations[CONSTELLATION_COUNT];
+
+        ConstellationStatistics const& operator[](CONSTELLATIONS constellation) const
+        {
+            return constellations[constellation];
+        }
+    };
+
+    /** Compute per-constellation statistics in a single pass over the satellites
+     *
+     * @param used the satellites used in the solution
+     */
+    PerConstellationStatistics computeConstellationStatistics(
+        SatelliteInfo const& info, PRNSet const& used);
+
+    /** @overload */
+    PerConstellationStatistics computeConstellationStatistics(
+        SatelliteInfo const& info, SolutionQuality const& quality);
+
+    /** @overload */
+    PerConstellationStatistics computeConstellationStatistics(
+        CompactSatelliteInfo const& info, PRNSet const& used);
+}
+
+#endif
@@ -0,0 +1,550 @@
+#include <gps_base/CoverageMap.hpp>
+
+#include "Parallel.hpp"
+#include "Varint.hpp"
+#include <algorithm>
+#include <atomic>
+#include <base/Float.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    typedef chrono::steady_clock Clock;
+
+    const char FILE_MAGIC[8] = { 'G', 'P', 'S', 'C', 'O', 'V', 'E', 'R' };
+    const uint32_t FILE_VERSION = 1;
+
+    /** Cell index of a coordinate, false if it does not fit in 32 bits */
+    bool toCellIndex(double value, double cellSize, int32_t& index) {
+        double cell = std::floor(value / cellSize);
+        if (!(cell >= numeric_limits<int32_t>::min() &&
+              cell <= numeric_limits<int32_t>::max())) {
+            return false;
+        }
+        index = static_cast<int32_t>(cell);
+        return true;
+    }
+
+    /** Normalize a longitude in [-180, 180) */
+    double normalizeLongitude(double longitude) {
+        double normalized = std::fmod(longitude + 180, 360);
+        if (normalized < 0) {
+            normalized += 360;
+        }
+        return normalized - 180;
+    }
+
+    double mean(double sum, uint64_t samples) {
+        if (samples == 0) {
+            return base::unknown<double>();
+        }
+        return sum / samples;
+    }
+
+    void invalidData() {
+        throw runtime_error("CoverageMap: invalid data");
+    }
+
+    int32_t readCellIndex(uint8_t const*& cursor, uint8_t const* end, int64_t previous) {
+        int64_t index = previous + varint::readSigned(cursor, end);
+        if (index < numeric_limits<int32_t>::min() ||
+            index > numeric_limits<int32_t>::max()) {
+            invalidData();
+        }
+        return static_cast<int32_t>(index);
+    }
+
+    /** Iterator over the qualities associated with a sequence of solutions
+     *
+     * It is optimized for solutions sorted by time, which is the common
+     * case within a log block
+     */
+    class QualityMatcher {
+        vector<SolutionQuality> const& mQualities;
+        base::Time mMaxAge;
+        /** Index of the first quality after the last requested time */
+        size_t mNext = 0;
+        base::Time mLastTime;
+
+    public:
+        QualityMatcher(vector<SolutionQuality> const& qualities, base::Time maxAge)
+            : mQualities(qualities)
+            , mMaxAge(maxAge) {}
+
+        SolutionQuality const* find(base::Time const& time) {
+            if (mQualities.empty()) {
+                return nullptr;
+            }
+
+            if (time < mLastTime || mNext == 0) {
+                mNext = upper_bound(mQualities.begin(), mQualities.end(), time,
+                    [](base::Time const& t, SolutionQuality const& q) {
+                        return t < q.time;
+                    }) - mQualities.begin();
+            }
+            else {
+                while (mNext < mQualities.size() && !(time < mQualities[mNext].time)) {
+                    ++mNext;
+                }
+            }
+            mLastTime = time;
+
+            if (mNext == 0) {
+                return nullptr;
+            }
+            SolutionQuality const& quality = mQualities[mNext - 1];
+            if (time - quality.time > mMaxAge) {
+                return nullptr;
+            }
+            return &quality;
+        }
+    };
+}
+
+double CoverageCell::getFixedRatio() const
+{
+    return mean(fixed, solutions);
+}
+
+double CoverageCell::getMeanSatellites() const
+{
+    return mean(satelliteSum, satelliteSamples);
+}
+
+double CoverageCell::getMeanHDOP() const
+{
+    return mean(hdopSum, hdopSamples);
+}
+
+double CoverageCell::getMeanCorrectionAge() const
+{
+    return mean(correctionAgeSum, correctionAgeSamples);
+}
+
+void CoverageCell::merge(CoverageCell const& other)
+{
+    solutions += other.solutions;
+    fixed += other.fixed;
+    satelliteSamples += other.satelliteSamples;
+    satelliteSum += other.satelliteSum;
+    hdopSamples += other.hdopSamples;
+    hdopSum += other.hdopSum;
+    correctionAgeSamples += other.correctionAgeSamples;
+    correctionAgeSum += other.correctionAgeSum;
+}
+
+CoverageMap::CoverageMap(COVERAGE_CELL_SCHEME scheme, double cellSize,
+                         int utmZone, bool utmNorth)
+    : mScheme(scheme)
+    , mCellSize(cellSize)
+    , mUTMZone(scheme == COVERAGE_CELLS_UTM ? utmZone : 0)
+    , mUTMNorth(scheme == COVERAGE_CELLS_UTM ? utmNorth : true)
+{
+    if (!(cellSize > 0) || std::isinf(cellSize)) {
+        throw invalid_argument("CoverageMap: the cell size must be strictly positive");
+    }
+}
+
+COVERAGE_CELL_SCHEME CoverageMap::getScheme() const
+{
+    return mScheme;
+}
+
+double CoverageMap::getCellSize() const
+{
+    return mCellSize;
+}
+
+int CoverageMap::getUTMZone() const
+{
+    return mUTMZone;
+}
+
+bool CoverageMap::getUTMNorth() const
+{
+    return mUTMNorth;
+}
+
+bool CoverageMap::isCompatible(CoverageMap const& other) const
+{
+    return mScheme == other.mScheme && mCellSize == other.mCellSize &&
+           mUTMZone == other.mUTMZone && mUTMNorth == other.mUTMNorth;
+}
+
+size_t CoverageMap::size() const
+{
+    return mCells.size();
+}
+
+bool CoverageMap::empty() const
+{
+    return mCells.empty();
+}
+
+void CoverageMap::clear()
+{
+    mCells.clear();
+}
+
+void CoverageMap::add(CoverageCell const& cell)
+{
+    auto it = mCells.find(getKey(cell.column, cell.row));
+    if (it == mCells.end()) {
+        mCells.emplace(getKey(cell.column, cell.row), cell);
+    }
+    else {
+        it->second.merge(cell);
+    }
+}
+
+void CoverageMap::merge(CoverageMap const& other)
+{
+    if (!isCompatible(other)) {
+        throw invalid_argument("CoverageMap: cannot merge maps with different cells");
+    }
+    for (auto const& entry : other.mCells) {
+        add(entry.second);
+    }
+}
+
+CoverageCell CoverageMap::getCell(int32_t column, int32_t row) const
+{
+    auto it = mCells.find(getKey(column, row));
+    if (it != mCells.end()) {
+        return it->second;
+    }
+    CoverageCell cell;
+    cell.column = column;
+    cell.row = row;
+    return cell;
+}
+
+vector<CoverageCell> CoverageMap::getCells() const
+{
+    vector<CoverageCell> cells;
+    cells.reserve(mCells.size());
+    for (auto const& entry : mCells) {
+        cells.push_back(entry.second);
+    }
+    sort(cells.begin(), cells.end(), [](CoverageCell const& a, CoverageCell const& b) {
+        return a.row < b.row || (a.row == b.row && a.column < b.column);
+    });
+    return cells;
+}
+
+string CoverageMap::encode() const
+{
+    string out(FILE_MAGIC, sizeof(FILE_MAGIC));
+    varint::writeFixed<uint32_t>(out, FILE_VERSION);
+    out.push_back(static_cast<char>(mScheme));
+    varint::writeFixed<int32_t>(out, mUTMZone);
+    out.push_back(mUTMNorth ? 1 : 0);
+    varint::writeFixed<double>(out, mCellSize);
+
+    auto cells = getCells();
+    varint::write(out, cells.size());
+    int64_t previousRow = 0;
+    int64_t previousColumn = 0;
+    for (auto const& cell : cells) {
+        // Columns are delta-encoded within a row, and absolute otherwise
+        if (cell.row != previousRow) {
+            previousColumn = 0;
+        }
+        varint::writeSigned(out, cell.row - previousRow);
+        varint::writeSigned(out, cell.column - previousColumn);
+        previousRow = cell.row;
+        previousColumn = cell.column;
+
+        varint::write(out, cell.solutions);
+        varint::write(out, cell.fixed);
+        varint::write(out, cell.satelliteSamples);
+        varint::write(out, cell.satelliteSum);
+        varint::write(out, cell.hdopSamples);
+        varint::write(out, cell.correctionAgeSamples);
+        if (cell.hdopSamples) {
+            varint::writeFixed<float>(out, cell.getMeanHDOP());
+        }
+        if (cell.correctionAgeSamples) {
+            varint::writeFixed<float>(out, cell.getMeanCorrectionAge());
+        }
+    }
+    return out;
+}
+
+CoverageMap CoverageMap::decode(uint8_t const* data, size_t size)
+{
+    uint8_t const* end = data + size;
+    if (size < sizeof(FILE_MAGIC) ||
+        memcmp(data, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+        throw runtime_error("CoverageMap: not a coverage map");
+    }
+    uint8_t const* cursor = data + sizeof(FILE_MAGIC);
+    if (varint::readFixed<uint32_t>(cursor, end) != FILE_VERSION) {
+        throw runtime_error("CoverageMap: unsupported version");
+    }
+
+    uint8_t scheme = varint::readFixed<uint8_t>(cursor, end);
+    int32_t zone = varint::readFixed<int32_t>(cursor, end);
+    uint8_t north = varint::readFixed<uint8_t>(cursor, end);
+    double cellSize = varint::readFixed<double>(cursor, end);
+    if (scheme > COVERAGE_CELLS_GEODETIC || north > 1 ||
+        !(cellSize > 0) || std::isinf(cellSize)) {
+        invalidData();
+    }
+
+    CoverageMap map(static_cast<COVERAGE_CELL_SCHEME>(scheme), cellSize, zone, north);
+    uint64_t count = varint::read(cursor, end);
+    // Each cell takes at least 8 bytes, which protects the reserve() below
+    if (count > static_cast<uint64_t>(end - cursor) / 8) {
+        invalidData();
+    }
+    map.mCells.reserve(count);
+
+    int64_t previousRow = 0;
+    int64_t previousColumn = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        CoverageCell cell;
+        cell.row = readCellIndex(cursor, end, previousRow);
+        if (cell.row != previousRow) {
+            previousColumn = 0;
+        }
+        cell.column = readCellIndex(cursor, end, previousColumn);
+        previousRow = cell.row;
+        previousColumn = cell.column;
+
+        cell.solutions = varint::read(cursor, end);
+        cell.fixed = varint::read(cursor, end);
+        cell.satelliteSamples = varint::read(cursor, end);
+        cell.satelliteSum = varint::read(cursor, end);
+        cell.hdopSamples = varint::read(cursor, end);
+        cell.correctionAgeSamples = varint::read(cursor, end);
+        if (cell.hdopSamples) {
+            cell.hdopSum = varint::readFixed<float>(cursor, end) *
+                           static_cast<double>(cell.hdopSamples);
+        }
+        if (cell.correctionAgeSamples) {
+            cell.correctionAgeSum = varint::readFixed<float>(cursor, end) *
+                                    static_cast<double>(cell.correctionAgeSamples);
+        }
+        if (!map.mCells.emplace(getKey(cell.column, cell.row), cell).second) {
+            invalidData();
+        }
+    }
+    if (cursor != end) {
+        invalidData();
+    }
+    return map;
+}
+
+void CoverageMap::save(string const& path) const
+{
+    ofstream file(path, ios::binary);
+    string data = encode();
+    file.write(data.data(), data.size());
+    file.close();
+    if (!file) {
+        throw runtime_error("CoverageMap: failed to write " + path);
+    }
+}
+
+CoverageMap CoverageMap::load(string const& path)
+{
+    ifstream file(path, ios::binary);
+    if (!file) {
+        throw runtime_error("CoverageMap: cannot open " + path);
+    }
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    return decode(reinterpret_cast<uint8_t const*>(data.data()), data.size());
+}
+
+CoverageAggregator::CoverageAggregator(
+    UTMConverter const& converter,
+    CoverageAggregatorConfiguration const& configuration)
+    : mConverter(converter)
+    , mConfiguration(configuration)
+    , mMap(configuration.scheme, configuration.cellSize,
+           converter.getUTMZone(), converter.getUTMNorth())
+{
+}
+
+bool CoverageAggregator::getCellPosition(double latitude, double longitude,
+                                         int32_t& column, int32_t& row) const
+{
+    double x = normalizeLongitude(longitude);
+    double y = latitude;
+    if (mConfiguration.scheme == COVERAGE_CELLS_UTM) {
+        double altitude = 0, z;
+        mConverter.convertToUTM(1, &latitude, &longitude, &altitude, &x, &y, &z);
+    }
+    return toCellIndex(x, mConfiguration.cellSize, column) &&
+           toCellIndex(y, mConfiguration.cellSize, row);
+}
+
+CoverageAggregatorStatistics CoverageAggregator::add(
+    SolutionLogReader const& log, vector<SolutionQuality> const& qualities)
+{
+    return run(log.getBlockCount(), [&log](size_t chunk, SolutionColumns& columns) {
+        log.readBlock(chunk, columns);
+    }, qualities);
+}
+
+CoverageAggregatorStatistics CoverageAggregator::add(
+    vector<Solution> const& solutions, vector<SolutionQuality> const& qualities)
+{
+    size_t chunkSize = max<size_t>(1, mConfiguration.chunkSize);
+    size_t chunkCount = (solutions.size() + chunkSize - 1) / chunkSize;
+    return run(chunkCount, [&solutions, chunkSize](size_t chunk, SolutionColumns& columns) {
+        size_t begin = chunk * chunkSize;
+        size_t end = min(solutions.size(), begin + chunkSize);
+        columns.resize(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            columns.set(i - begin, solutions[i]);
+        }
+    }, qualities);
+}
+
+CoverageMap const& CoverageAggregator::getMap() const
+{
+    return mMap;
+}
+
+void CoverageAggregator::clear()
+{
+    mMap.clear();
+}
+
+CoverageAggregatorStatistics CoverageAggregator::run(
+    size_t chunkCount, Source const& source, vector<SolutionQuality> const& qualities)
+{
+    auto start = Clock::now();
+    unsigned int threadCount = min<size_t>(
+        details::getThreadCount(mConfiguration.threads), max<size_t>(chunkCount, 1));
+    size_t maxLocalCells = max<size_t>(1, mConfiguration.maxLocalCells);
+
+    // Chunks are handed out dynamically, as their cost depends on the
+    // filter and on the cell locality
+    atomic<size_t> nextChunk(0);
+    mutex lock;
+    CoverageAggregatorStatistics statistics;
+
+    details::parallelFor(threadCount, threadCount, [&](size_t, size_t) {
+        // The coordinate transformations are not thread-safe
+        UTMConverter converter(mConverter);
+        QualityMatcher matcher(qualities, mConfiguration.maxQualityAge);
+        SolutionColumns columns;
+        vector<size_t> selected;
+        vector<double> latitudes, longitudes, altitudes, x, y, z;
+        unordered_map<uint64_t, CoverageCell> local;
+        CoverageAggregatorStatistics localStatistics;
+
+        auto flush = [&]() {
+            unique_lock<mutex> guard(lock);
+            for (auto const& entry : local) {
+                mMap.add(entry.second);
+            }
+            localStatistics.merges++;
+            guard.unlock();
+            local.clear();
+        };
+
+        while (true) {
+            size_t chunk = nextChunk++;
+            if (chunk >= chunkCount) {
+                break;
+            }
+
+            source(chunk, columns);
+            selected.clear();
+            for (size_t i = 0; i < columns.size(); ++i) {
+                if (mConfiguration.filter.accepts(columns, i)) {
+                    selected.push_back(i);
+                }
+            }
+            localStatistics.solutions += columns.size();
+            localStatistics.accepted += selected.size();
+
+            size_t count = selected.size();
+            x.resize(count);
+            y.resize(count);
+            if (mConfiguration.scheme == COVERAGE_CELLS_UTM) {
+                latitudes.resize(count);
+                longitudes.resize(count);
+                altitudes.resize(count);
+                z.resize(count);
+                for (size_t i = 0; i < count; ++i) {
+                    latitudes[i] = columns.latitude[selected[i]];
+                    longitudes[i] = columns.longitude[selected[i]];
+                    altitudes[i] = columns.altitude[selected[i]];
+                }
+                converter.convertToUTM(count, latitudes.data(), longitudes.data(),
+                                       altitudes.data(), x.data(), y.data(), z.data());
+            }
+            else {
+                for (size_t i = 0; i < count; ++i) {
+                    x[i] = normalizeLongitude(columns.longitude[selected[i]]);
+                    y[i] = columns.latitude[selected[i]];
+                }
+            }
+
+            for (size_t i = 0; i < count; ++i) {
+                int32_t column, row;
+                if (!toCellIndex(x[i], mConfiguration.cellSize, column) ||
+                    !toCellIndex(y[i], mConfiguration.cellSize, row)) {
+                    localStatistics.outside++;
+                    continue;
+                }
+
+                CoverageCell& cell = local[CoverageMap::getKey(column, row)];
+                cell.column = column;
+                cell.row = row;
+
+                size_t in = selected[i];
+                cell.solutions++;
+                if (columns.positionType[in] == RTK_FIXED) {
+                    cell.fixed++;
+                }
+                // 255 encodes an unknown satellite count (see SolutionColumns)
+                if (columns.noOfSatellites[in] != 255) {
+                    cell.satelliteSamples++;
+                    cell.satelliteSum += columns.noOfSatellites[in];
+                }
+                double age = columns.ageOfDifferentialCorrections[in];
+                if (std::isfinite(age)) {
+                    cell.correctionAgeSamples++;
+                    cell.correctionAgeSum += age;
+                }
+                SolutionQuality const* quality = matcher.find(columns.time[in]);
+                if (quality && std::isfinite(quality->hdop)) {
+                    cell.hdopSamples++;
+                    cell.hdopSum += quality->hdop;
+                }
+
+                if (local.size() >= maxLocalCells) {
+                    flush();
+                }
+            }
+        }
+
+        if (!local.empty()) {
+            flush();
+        }
+        unique_lock<mutex> guard(lock);
+        statistics.solutions += localStatistics.solutions;
+        statistics.accepted += localStatistics.accepted;
+        statistics.outside += localStatistics.outside;
+        statistics.merges += localStatistics.merges;
+    });
+
+    statistics.time = base::Time::fromMicroseconds(
+        chrono::duration_cast<chrono::microseconds>(Clock::now() - start).count());
+    return statistics;
+}
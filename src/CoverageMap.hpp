@@ -0,0 +1,250 @@
+#ifndef GPS_BASE_COVERAGEMAP_HPP
+#define GPS_BASE_COVERAGEMAP_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <gps_base/BaseTypes.hpp>
+#include <gps_base/SolutionLog.hpp>
+#include <gps_base/TrajectoryPipeline.hpp>
+#include <gps_base/UTMConverter.hpp>
+
+namespace gps_base
+{
+    /** How a CoverageMap splits the ground into cells */
+    enum COVERAGE_CELL_SCHEME {
+        /** Square cells on the UTM grid of a single zone, sized in meters */
+        COVERAGE_CELLS_UTM = 0,
+        /** Latitude/longitude cells, sized in degrees, for data that spans
+         * several UTM zones
+         */
+        COVERAGE_CELLS_GEODETIC = 1
+    };
+
+    /** Statistics of the solutions that fell in a cell of a CoverageMap
+     *
+     * The cell covers [column, column + 1) * cellSize along the easting (or
+     * longitude) and [row, row + 1) * cellSize along the northing (or
+     * latitude). The means are NaN if there are no samples.
+     */
+    struct CoverageCell {
+        std::int32_t column = 0;
+        std::int32_t row = 0;
+        /** Number of solutions */
+        std::uint64_t solutions = 0;
+        /** Number of RTK_FIXED solutions */
+        std::uint64_t fixed = 0;
+        /** Number of solutions with a known number of satellites */
+        std::uint64_t satelliteSamples = 0;
+        std::uint64_t satelliteSum = 0;
+        /** Number of solutions that were associated with a HDOP */
+        std::uint64_t hdopSamples = 0;
+        double hdopSum = 0;
+        /** Number of solutions with a known age of corrections */
+        std::uint64_t correctionAgeSamples = 0;
+        double correctionAgeSum = 0;
+
+        double getFixedRatio() const;
+        double getMeanSatellites() const;
+        double getMeanHDOP() const;
+        double getMeanCorrectionAge() const;
+
+        /** Add the statistics of another cell to this one */
+        void merge(CoverageCell const& other);
+    };
+
+    /** Sparse grid of per-cell fix quality statistics
+     *
+     * Only the cells that received solutions are stored. CoverageAggregator
+     * builds it from solution logs.
+     */
+    class CoverageMap
+    {
+        COVERAGE_CELL_SCHEME mScheme;
+        double mCellSize;
+        int mUTMZone;
+        bool mUTMNorth;
+        std::unordered_map<std::uint64_t, CoverageCell> mCells;
+
+    public:
+        /**
+         * @param cellSize the size of the cells, in meters for UTM cells and
+         *   degrees for geodetic cells
+         * @param utmZone the UTM zone of UTM cells, ignored for geodetic cells
+         * @throw std::invalid_argument if the cell size is not strictly
+         *   positive
+         */
+        CoverageMap(COVERAGE_CELL_SCHEME scheme, double cellSize,
+                    int utmZone = 0, bool utmNorth = true);
+
+        COVERAGE_CELL_SCHEME getScheme() const;
+        double getCellSize() const;
+        int getUTMZone() const;
+        bool getUTMNorth() const;
+
+        /** Whether the other map's cells are the same as this map's */
+        bool isCompatible(CoverageMap const& other) const;
+
+        /** Number of cells that received solutions */
+        std::size_t size() const;
+        bool empty() const;
+        void clear();
+
+        /** Merge a cell's statistics with the ones of the cell at the same
+         * position
+         */
+        void add(CoverageCell const& cell);
+
+        /** Merge another map into this one
+         *
+         * @throw std::invalid_argument if the maps are not compatible
+         */
+        void merge(CoverageMap const& other);
+
+        /** The cell at the given position, empty if it received no solutions */
+        CoverageCell getCell(std::int32_t column, std::int32_t row) const;
+
+        /** All cells, sorted by row and then column */
+        std::vector<CoverageCell> getCells() const;
+
+        /** Encode the map in a compact binary format
+         *
+         * The cells are stored sorted, with their positions delta-encoded
+         * and their counts as varints. The HDOP and age of corrections are
+         * stored as 32-bit float means, i.e. their sums only round-trip
+         * with single precision.
+         */
+        std::string encode() const;
+
+        /** Decode a map encoded with encode()
+         *
+         * @throw std::runtime_error if the data is not a valid map
+         */
+        static CoverageMap decode(std::uint8_t const* data, std::size_t size);
+
+        /** Write the encoded map to a file */
+        void save(std::string const& path) const;
+
+        /** Read a map written with save() */
+        static CoverageMap load(std::string const& path);
+
+        /** Key of a cell in the map's hash table */
+        static std::uint64_t getKey(std::int32_t column, std::int32_t row)
+        {
+            return static_cast<std::uint64_t>(static_cast<std::uint32_t>(row)) << 32 |
+                   static_cast<std::uint32_t>(column);
+        }
+    };
+
+    struct CoverageAggregatorConfiguration {
+        COVERAGE_CELL_SCHEME scheme = COVERAGE_CELLS_UTM;
+        /** Size of the cells, in meters for UTM cells and degrees for
+         * geodetic cells
+         */
+        double cellSize = 10;
+        /** Selection of the solutions that are aggregated */
+        TrajectoryFilter filter;
+        /** Maximum time between a solution and the SolutionQuality it is
+         * associated with
+         */
+        base::Time maxQualityAge = base::Time::fromSeconds(1.0);
+        /** Number of worker threads, zero meaning one per hardware thread */
+        unsigned int threads = 0;
+        /** Maximum number of cells in a worker's local table
+         *
+         * Full tables are merged into the shared map. This bounds the memory
+         * used by the workers regardless of the amount of solutions.
+         */
+        std::size_t maxLocalCells = 65536;
+        /** Number of solutions per chunk when the input is not a log
+         *
+         * Logs are split along their blocks
+         */
+        std::size_t chunkSize = SolutionLogWriter::DEFAULT_BLOCK_SIZE;
+    };
+
+    struct CoverageAggregatorStatistics {
+        /** Number of solutions read */
+        std::size_t solutions = 0;
+        /** Number of solutions that passed the filter */
+        std::size_t accepted = 0;
+        /** Number of accepted solutions that could not be assigned a cell */
+        std::size_t outside = 0;
+        /** Number of times a worker's local table was merged into the map */
+        std::size_t merges = 0;
+        /** Wall-clock time of the run */
+        base::Time time;
+    };
+
+    /** Parallel aggregation of solutions into a CoverageMap
+     *
+     * The input is split in chunks, which are processed by a pool of worker
+     * threads. Each worker accumulates in its own hash table, merged into
+     * the map when it is full and at the end of the run, so that the
+     * workers only contend on the map once per maxLocalCells cells.
+     *
+     * The memory used is therefore bounded by the number of distinct cells,
+     * not by the number of solutions. Logs are memory-mapped and decoded
+     * block by block.
+     */
+    class CoverageAggregator
+    {
+    public:
+        /**
+         * @param converter the converter whose zone defines the UTM cells.
+         *   It is ignored for geodetic cells
+         * @throw std::invalid_argument if the cell size is not strictly
+         *   positive
+         */
+        CoverageAggregator(UTMConverter const& converter,
+                           CoverageAggregatorConfiguration const& configuration =
+                               CoverageAggregatorConfiguration());
+
+        /** Position of the cell that contains the given point
+         *
+         * @return false if the point cannot be assigned a cell, i.e. is not
+         *   finite or too far away
+         */
+        bool getCellPosition(double latitude, double longitude,
+                             std::int32_t& column, std::int32_t& row) const;
+
+        /** Aggregate the solutions of a log
+         *
+         * @param qualities quality information sorted by time. A solution
+         *   is associated with the last quality at or before its own time,
+         *   if it is not older than maxQualityAge. It is the source of the
+         *   HDOP.
+         *
+         * If an exception is thrown, the map may contain part of the input
+         */
+        CoverageAggregatorStatistics add(
+            SolutionLogReader const& log,
+            std::vector<SolutionQuality> const& qualities = std::vector<SolutionQuality>());
+
+        /** @overload */
+        CoverageAggregatorStatistics add(
+            std::vector<Solution> const& solutions,
+            std::vector<SolutionQuality> const& qualities = std::vector<SolutionQuality>());
+
+        /** The map aggregated so far */
+        CoverageMap const& getMap() const;
+
+        /** Remove all cells from the map */
+        void clear();
+
+    private:
+        /** Fill the columns with the given chunk of the input */
+        typedef std::function<void (std::size_t, SolutionColumns&)> Source;
+
+        UTMConverter mConverter;
+        CoverageAggregatorConfiguration mConfiguration;
+        CoverageMap mMap;
+
+        CoverageAggregatorStatistics run(std::size_t chunkCount, Source const& source,
+                                         std::vector<SolutionQuality> const& qualities);
+    };
+}
+
+#endif
@@ -0,0 +1,125 @@
+#include <gps_base/DOP.hpp>
+
+#include "Parallel.hpp"
+#include <base/Eigen.hpp>
+#include <base/Float.hpp>
+#include <cmath>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    /** Line-of-sight unit vector in the local ENU frame */
+    struct LineOfSight {
+        double e;
+        double n;
+        double u;
+    };
+
+    LineOfSight lineOfSight(double elevation, double azimuth) {
+        double el = elevation * M_PI / 180;
+        double az = azimuth * M_PI / 180;
+        double cosEl = cos(el);
+        return LineOfSight { cosEl * sin(az), cosEl * cos(az), sin(el) };
+    }
+
+    /** Accumulates the normal matrix H^T H of the geometry matrix H, whose
+     * rows are (-e, -n, -u, 1)
+     */
+    struct NormalMatrix {
+        Eigen::Matrix4d matrix = Eigen::Matrix4d::Zero();
+        int count = 0;
+
+        void add(LineOfSight const& los) {
+            Eigen::Vector4d row(-los.e, -los.n, -los.u, 1);
+            matrix.selfadjointView<Eigen::Upper>().rankUpdate(row);
+            ++count;
+        }
+
+        DilutionOfPrecision solve() const {
+            DilutionOfPrecision dop;
+            dop.gdop = dop.pdop = dop.hdop = dop.vdop = dop.tdop =
+                base::unknown<double>();
+            if (count < 4) {
+                return dop;
+            }
+
+            Eigen::Matrix4d full = matrix.selfadjointView<Eigen::Upper>();
+            Eigen::Matrix4d q;
+            bool invertible = false;
+            full.computeInverseWithCheck(q, invertible);
+            if (!invertible) {
+                return dop;
+            }
+
+            dop.hdop = sqrt(q(0, 0) + q(1, 1));
+            dop.vdop = sqrt(q(2, 2));
+            dop.pdop = sqrt(q(0, 0) + q(1, 1) + q(2, 2));
+            dop.tdop = sqrt(q(3, 3));
+            dop.gdop = sqrt(q.trace());
+            return dop;
+        }
+    };
+}
+
+DilutionOfPrecision gps_base::computeDOP(SatelliteInfo const& info,
+                                         SatelliteMask const& mask)
+{
+    NormalMatrix normal;
+    for (auto const& satellite : info.knownSatellites) {
+        if (mask.accepts(satellite.PRN, satellite.elevation)) {
+            normal.add(lineOfSight(satellite.elevation, satellite.azimuth));
+        }
+    }
+    return normal.solve();
+}
+
+DilutionOfPrecision gps_base::computeDOP(CompactSatelliteInfo const& info,
+                                         SatelliteMask const& mask)
+{
+    NormalMatrix normal;
+    for (size_t i = 0; i < info.count; ++i) {
+        if (mask.accepts(info.prn[i], info.elevation[i])) {
+            normal.add(lineOfSight(info.elevation[i], info.azimuth[i]));
+        }
+    }
+    return normal.solve();
+}
+
+vector<DilutionOfPrecision> gps_base::computeDOP(
+    SatelliteInfo const& info, vector<SatelliteMask> const& masks)
+{
+    vector<LineOfSight> los;
+    los.reserve(info.knownSatellites.size());
+    for (auto const& satellite : info.knownSatellites) {
+        los.push_back(lineOfSight(satellite.elevation, satellite.azimuth));
+    }
+
+    vector<DilutionOfPrecision> result;
+    result.reserve(masks.size());
+    for (auto const& mask : masks) {
+        NormalMatrix normal;
+        for (size_t i = 0; i < los.size(); ++i) {
+            auto const& satellite = info.knownSatellites[i];
+            if (mask.accepts(satellite.PRN, satellite.elevation)) {
+                normal.add(los[i]);
+            }
+        }
+        result.push_back(normal.solve());
+    }
+    return result;
+}
+
+vector<DilutionOfPrecision> gps_base::computeDOP(
+    vector<SatelliteInfo> const& epochs, SatelliteMask const& mask,
+    unsigned int threads)
+{
+    vector<DilutionOfPrecision> result(epochs.size());
+    details::parallelFor(epochs.size(), threads,
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                result[i] = computeDOP(epochs[i], mask);
+            }
+        });
+    return result;
+}
@@ -0,0 +1,80 @@
+#ifndef GPS_BASE_DOP_HPP
+#define GPS_BASE_DOP_HPP
+
+#include <vector>
+#include <gps_base/BaseTypes.hpp>
+#include <gps_base/CompactTypes.hpp>
+
+namespace gps_base
+{
+    /** Dilution of precision values
+     *
+     * All fields are NaN if the geometry does not allow to compute a
+     * solution (less than 4 satellites, or degenerate geometry)
+     */
+    struct DilutionOfPrecision {
+        double gdop;
+        double pdop;
+        double hdop;
+        double vdop;
+        double tdop;
+    };
+
+    /** Selection of the satellites that should be used to compute the DOP */
+    struct SatelliteMask {
+        /** Bitmask that accepts all constellations */
+        static const unsigned int ALL_CONSTELLATIONS = ~0u;
+
+        /** Minimum elevation, in degrees */
+        double minElevation = 0;
+        /** Accepted constellations
+         *
+         * Bit N is set if the constellation whose CONSTELLATIONS value is N
+         * is accepted. Use constellationBit() to build it.
+         */
+        unsigned int constellations = ALL_CONSTELLATIONS;
+
+        static unsigned int constellationBit(CONSTELLATIONS constellation)
+        {
+            return 1u << constellation;
+        }
+
+        bool accepts(int prn, double elevation) const
+        {
+            return elevation >= minElevation &&
+                (constellations &
+                 constellationBit(Satellite::getConstellationFromPRN(prn)));
+        }
+    };
+
+    /** Compute the DOP from the satellites' elevation and azimuth
+     *
+     * The geometry matrix has a single receiver clock term, i.e. it does
+     * not model inter-system biases
+     */
+    DilutionOfPrecision computeDOP(SatelliteInfo const& info,
+                                   SatelliteMask const& mask = SatelliteMask());
+
+    /** @overload */
+    DilutionOfPrecision computeDOP(CompactSatelliteInfo const& info,
+                                   SatelliteMask const& mask = SatelliteMask());
+
+    /** Compute the DOP of a single epoch for several masks
+     *
+     * The line-of-sight vectors are computed only once for all masks
+     */
+    std::vector<DilutionOfPrecision> computeDOP(
+        SatelliteInfo const& info, std::vector<SatelliteMask> const& masks);
+
+    /** Compute the DOP of many epochs in parallel
+     *
+     * @param threads how many threads should be used, zero meaning one per
+     *   hardware thread
+     */
+    std::vector<DilutionOfPrecision> computeDOP(
+        std::vector<SatelliteInfo> const& epochs,
+        SatelliteMask const& mask = SatelliteMask(),
+        unsigned int threads = 0);
+}
+
+#endif
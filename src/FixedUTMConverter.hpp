@@ -0,0 +1,408 @@
+#ifndef GPS_BASE_FIXEDUTMCONVERTER_HPP
+#define GPS_BASE_FIXEDUTMCONVERTER_HPP
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gps_base/UTMConverter.hpp>
+#include <gps_base/UTMFrames.hpp>
+
+namespace gps_base
+{
+    /** UTM converter for a zone and hemisphere known at compile time
+     *
+     * It has the same interface as UTMConverter, but the central meridian,
+     * false northing and projection coefficients are compile-time constants
+     * and the conversions are inline, so that they can be folded into the
+     * caller. It does not allocate, and is cheap to copy.
+     *
+     * All conversions use the analytic projection of TransverseMercator.hpp,
+     * i.e. give the same results as UTMConverter's *WithGrid methods, and
+     * differ by a few nanometers from UTMConverter::convertToUTM, which goes
+     * through GDAL. The covariances and orientations are otherwise handled
+     * as by the corresponding UTMConverter methods.
+     *
+     * Setting a zone or hemisphere other than the template's, e.g. through
+     * setParameters, throws std::invalid_argument.
+     */
+    template<int Zone, bool North>
+    class FixedUTMConverter
+    {
+        static_assert(Zone >= 1 && Zone <= 60, "UTM zones are numbered from 1 to 60");
+
+    public:
+        static constexpr int ZONE = Zone;
+        static constexpr bool NORTH = North;
+        static constexpr double CENTRAL_MERIDIAN = tmerc::getUTMCentralMeridian(Zone);
+        static constexpr double FALSE_NORTHING = utm::getFalseNorthing(North);
+
+    private:
+        base::Position origin;
+        HEIGHT_REFERENCE height_reference;
+        std::shared_ptr<GeoidModel const> geoid;
+
+        static void validate(int zone, bool north)
+        {
+            if (zone != Zone || north != North)
+            {
+                throw std::invalid_argument(
+                    "FixedUTMConverter: this converter is specialized for zone " +
+                    std::to_string(Zone) + (North ? "N" : "S") + ", cannot set zone " +
+                    std::to_string(zone) + (north ? "N" : "S"));
+            }
+        }
+
+        static tmerc::Projection project(double latitude, double longitude)
+        {
+            return utm::project(CENTRAL_MERIDIAN, FALSE_NORTHING, latitude, longitude);
+        }
+
+    public:
+        FixedUTMConverter()
+            : origin(base::Position::Zero())
+            , height_reference(HEIGHT_ORTHOMETRIC) {}
+
+        /** @throw std::invalid_argument if the parameters' zone or hemisphere
+         *   differ from the template's
+         */
+        FixedUTMConverter(UTMConversionParameters const& parameters)
+            : origin(parameters.nwu_origin)
+            , height_reference(parameters.height_reference)
+        {
+            validate(parameters.utm_zone, parameters.utm_north);
+        }
+
+        /** @throw std::invalid_argument if the parameters' zone or hemisphere
+         *   differ from the template's
+         */
+        void setParameters(UTMConversionParameters const& parameters)
+        {
+            validate(parameters.utm_zone, parameters.utm_north);
+            origin = parameters.nwu_origin;
+            height_reference = parameters.height_reference;
+        }
+
+        UTMConversionParameters getParameters() const
+        {
+            UTMConversionParameters parameters;
+            parameters.utm_zone = Zone;
+            parameters.utm_north = North;
+            parameters.nwu_origin = origin;
+            parameters.height_reference = height_reference;
+            return parameters;
+        }
+
+        /** @throw std::invalid_argument if @a zone is not the template's */
+        void setUTMZone(int zone)
+        {
+            validate(zone, North);
+        }
+
+        /** @throw std::invalid_argument if @a north is not the template's */
+        void setUTMNorth(bool north)
+        {
+            validate(Zone, north);
+        }
+
+        int getUTMZone() const
+        {
+            return Zone;
+        }
+
+        bool getUTMNorth() const
+        {
+            return North;
+        }
+
+        /** @see UTMConverter::setHeightReference */
+        void setHeightReference(HEIGHT_REFERENCE reference)
+        {
+            height_reference = reference;
+        }
+
+        HEIGHT_REFERENCE getHeightReference() const
+        {
+            return height_reference;
+        }
+
+        /** @see UTMConverter::setGeoidModel */
+        void setGeoidModel(std::shared_ptr<GeoidModel const> model)
+        {
+            geoid = model;
+        }
+
+        std::shared_ptr<GeoidModel const> getGeoidModel() const
+        {
+            return geoid;
+        }
+
+        /** @see UTMConverter::convertHeights */
+        void convertHeights(std::size_t count,
+                            double const* latitudes,
+                            double const* longitudes,
+                            double const* altitudes,
+                            double const* separations,
+                            double* heights) const
+        {
+            utm::convertHeights(height_reference, geoid.get(), count,
+                                latitudes, longitudes, altitudes, separations, heights);
+        }
+
+        void setNWUOrigin(base::Position origin)
+        {
+            this->origin = origin;
+        }
+
+        base::Position getNWUOrigin() const
+        {
+            return origin;
+        }
+
+        /** @see UTMConverter::convertToUTM(Solution) */
+        base::samples::RigidBodyState convertToUTM(gps_base::Solution const& solution) const
+        {
+            if (solution.positionType == gps_base::NO_SOLUTION)
+                return utm::makeEmptyState(solution);
+
+            tmerc::Projection projection = project(solution.latitude, solution.longitude);
+            return utm::makeUTMState(solution, projection.x, projection.y,
+                utm::toOutputHeight(height_reference, geoid.get(), solution));
+        }
+
+        std::vector<base::samples::RigidBodyState> convertToUTM(
+            std::vector<gps_base::Solution> const& solutions) const
+        {
+            std::vector<base::samples::RigidBodyState> result;
+            result.reserve(solutions.size());
+            for (auto const& solution : solutions)
+                result.push_back(convertToUTM(solution));
+            return result;
+        }
+
+        /** @see UTMConverter::convertToUTM(std::size_t, ...) */
+        void convertToUTM(std::size_t count,
+                          double const* latitudes,
+                          double const* longitudes,
+                          double const* altitudes,
+                          double* eastings,
+                          double* northings,
+                          double* heights) const
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                tmerc::Projection projection = project(latitudes[i], longitudes[i]);
+                eastings[i] = projection.x;
+                northings[i] = projection.y;
+                heights[i] = altitudes[i];
+            }
+        }
+
+        UTMGridProperties getGridProperties(double latitude, double longitude) const
+        {
+            tmerc::Projection projection = project(latitude, longitude);
+            UTMGridProperties grid;
+            grid.convergence = projection.convergence;
+            grid.scale = projection.scale;
+            return grid;
+        }
+
+        /** @see UTMConverter::convertToUTMWithGrid */
+        base::samples::RigidBodyState convertToUTMWithGrid(
+            gps_base::Solution const& solution,
+            base::Orientation const& orientation = base::Orientation::Identity()) const
+        {
+            if (solution.positionType == gps_base::NO_SOLUTION)
+                return utm::makeEmptyState(solution);
+
+            tmerc::Projection projection = project(solution.latitude, solution.longitude);
+            double height = utm::toOutputHeight(height_reference, geoid.get(), solution);
+            return utm::makeGridState(solution, projection, height, orientation);
+        }
+
+        std::vector<base::samples::RigidBodyState> convertToUTMWithGrid(
+            std::vector<gps_base::Solution> const& solutions) const
+        {
+            std::vector<base::samples::RigidBodyState> result;
+            result.reserve(solutions.size());
+            for (auto const& solution : solutions)
+                result.push_back(convertToUTMWithGrid(solution));
+            return result;
+        }
+
+        void convertToUTMWithGrid(std::size_t count,
+                                  double const* latitudes,
+                                  double const* longitudes,
+                                  double const* altitudes,
+                                  double* eastings,
+                                  double* northings,
+                                  double* heights,
+                                  double* convergences,
+                                  double* scales) const
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                tmerc::Projection projection = project(latitudes[i], longitudes[i]);
+                eastings[i] = projection.x;
+                northings[i] = projection.y;
+                heights[i] = altitudes[i];
+                convergences[i] = projection.convergence;
+                scales[i] = projection.scale;
+            }
+        }
+
+        /** @see UTMConverter::convertToNWUWithGrid */
+        base::samples::RigidBodyState convertToNWUWithGrid(
+            gps_base::Solution const& solution,
+            base::Orientation const& orientation = base::Orientation::Identity()) const
+        {
+            if (solution.positionType == gps_base::NO_SOLUTION)
+                return utm::makeEmptyState(solution);
+            return convertToNWU(convertToUTMWithGrid(solution, utm::rotateZ90(orientation, false)));
+        }
+
+        std::vector<base::samples::RigidBodyState> convertToNWUWithGrid(
+            std::vector<gps_base::Solution> const& solutions) const
+        {
+            std::vector<base::samples::RigidBodyState> result;
+            result.reserve(solutions.size());
+            for (auto const& solution : solutions)
+                result.push_back(convertToNWUWithGrid(solution));
+            return result;
+        }
+
+        /** @see UTMConverter::convertUTMToGPSWithGrid */
+        gps_base::Solution convertUTMToGPSWithGrid(
+            base::samples::RigidBodyState const& state,
+            base::Orientation* orientation = nullptr) const
+        {
+            tmerc::Geodetic geodetic = utm::unproject(
+                CENTRAL_MERIDIAN, FALSE_NORTHING, state.position.x(), state.position.y());
+            tmerc::Projection projection = project(geodetic.latitude, geodetic.longitude);
+
+            gps_base::Solution solution =
+                utm::makeGridSolution(state, geodetic, projection, orientation);
+            utm::fromOutputHeight(height_reference, geoid.get(), solution, state.position.z());
+            return solution;
+        }
+
+        /** @see UTMConverter::convertNWUToGPSWithGrid */
+        gps_base::Solution convertNWUToGPSWithGrid(
+            base::samples::RigidBodyState const& nwu,
+            base::Orientation* orientation = nullptr) const
+        {
+            gps_base::Solution solution = convertUTMToGPSWithGrid(convertNWUToUTM(nwu), orientation);
+            if (orientation)
+                *orientation = utm::rotateZ90(*orientation, true);
+            return solution;
+        }
+
+        /** @see UTMConverter::convertUTMToGPS */
+        gps_base::Solution convertUTMToGPS(base::samples::RigidBodyState const& state) const
+        {
+            tmerc::Geodetic geodetic = utm::unproject(
+                CENTRAL_MERIDIAN, FALSE_NORTHING, state.position.x(), state.position.y());
+
+            gps_base::Solution solution;
+            solution.time = state.time;
+            solution.latitude = geodetic.latitude;
+            solution.longitude = geodetic.longitude;
+            utm::fromOutputHeight(height_reference, geoid.get(), solution, state.position.z());
+            solution.deviationLongitude = std::sqrt(state.cov_position(0, 0));
+            solution.deviationLatitude = std::sqrt(state.cov_position(1, 1));
+            solution.deviationAltitude = std::sqrt(state.cov_position(2, 2));
+            return solution;
+        }
+
+        /** @see UTMConverter::convertToNWU(Solution) */
+        base::samples::RigidBodyState convertToNWU(gps_base::Solution const& solution) const
+        {
+            return convertToNWU(convertToUTM(solution));
+        }
+
+        std::vector<base::samples::RigidBodyState> convertToNWU(
+            std::vector<gps_base::Solution> const& solutions) const
+        {
+            std::vector<base::samples::RigidBodyState> result;
+            result.reserve(solutions.size());
+            for (auto const& solution : solutions)
+                result.push_back(convertToNWU(solution));
+            return result;
+        }
+
+        /** @see UTMConverter::convertToNWU(std::size_t, ...) */
+        void convertToNWU(std::size_t count,
+                          double const* latitudes,
+                          double const* longitudes,
+                          double const* altitudes,
+                          double* x,
+                          double* y,
+                          double* z) const
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                tmerc::Projection projection = project(latitudes[i], longitudes[i]);
+                base::Position nwu = utm::toNWU(projection.x, projection.y, altitudes[i], origin);
+                x[i] = nwu.x();
+                y[i] = nwu.y();
+                z[i] = nwu.z();
+            }
+        }
+
+        /** @see UTMConverter::convertToNWUFloat */
+        FloatConversionReport convertToNWUFloat(
+            std::size_t count,
+            double const* latitudes,
+            double const* longitudes,
+            double const* altitudes,
+            float* xyz,
+            double tolerance,
+            base::Position const& anchor = base::Position::Zero()) const
+        {
+            if (!(tolerance > 0))
+                throw std::invalid_argument(
+                    "FixedUTMConverter: the float tolerance must be strictly positive");
+
+            FloatConversionReport report;
+            report.count = count;
+            report.range = utm::getFloatRange(tolerance);
+            report.firstOutOfRange = count;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                tmerc::Projection projection = project(latitudes[i], longitudes[i]);
+                base::Position nwu = utm::toNWU(projection.x, projection.y, altitudes[i], origin);
+                utm::packFloats(1, i, &nwu.x(), &nwu.y(), &nwu.z(), anchor,
+                                xyz + 3 * i, report);
+            }
+            return report;
+        }
+
+        gps_base::Solution convertNWUToGPS(base::samples::RigidBodyState const& nwu) const
+        {
+            return convertUTMToGPS(convertNWUToUTM(nwu));
+        }
+
+        /** @see UTMConverter::convertToNWU(RigidBodyState) */
+        base::samples::RigidBodyState convertToNWU(base::samples::RigidBodyState const& state) const
+        {
+            return utm::toNWU(state, origin);
+        }
+
+        /** @see UTMConverter::convertNWUToUTM */
+        base::samples::RigidBodyState convertNWUToUTM(base::samples::RigidBodyState const& nwu) const
+        {
+            return utm::fromNWU(nwu, origin);
+        }
+    };
+
+    template<int Zone, bool North>
+    constexpr int FixedUTMConverter<Zone, North>::ZONE;
+    template<int Zone, bool North>
+    constexpr bool FixedUTMConverter<Zone, North>::NORTH;
+    template<int Zone, bool North>
+    constexpr double FixedUTMConverter<Zone, North>::CENTRAL_MERIDIAN;
+    template<int Zone, bool North>
+    constexpr double FixedUTMConverter<Zone, North>::FALSE_NORTHING;
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include <gps_base/GPSTime.hpp>
+
+#include <cmath>
+#include <limits>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    const int64_t USEC_PER_SEC = 1000000;
+
+    int64_t floorSeconds(base::Time const& time)
+    {
+        int64_t us = time.toMicroseconds();
+        int64_t seconds = us / USEC_PER_SEC;
+        return (us % USEC_PER_SEC < 0) ? seconds - 1 : seconds;
+    }
+
+    base::Time offset(base::Time const& time, int seconds)
+    {
+        if (seconds >= 0) {
+            return time + base::Time::fromMicroseconds(seconds * USEC_PER_SEC);
+        }
+        return time - base::Time::fromMicroseconds(-seconds * USEC_PER_SEC);
+    }
+
+    base::Time weekTimeToGPS(gpstime::WeekTime const& time)
+    {
+        int64_t us = (gpstime::GPS_EPOCH +
+                      static_cast<int64_t>(time.week) * gpstime::SECONDS_PER_WEEK) *
+                     USEC_PER_SEC + llround(time.tow * USEC_PER_SEC);
+        return base::Time::fromMicroseconds(us);
+    }
+
+    /** Cache of the GPS-time interval over which GPS - UTC is constant */
+    struct LeapSecondInterval {
+        int64_t start = 1;
+        int64_t end = 0;
+        int gpsMinusUTC = 0;
+
+        int get(int64_t gps)
+        {
+            if (gps >= start && gps < end) {
+                return gpsMinusUTC;
+            }
+
+            int i = gpstime::LEAP_SECOND_COUNT - 1;
+            while (i > 0 && gps < gpsStart(i)) {
+                --i;
+            }
+            gpsMinusUTC = gpstime::LEAP_SECONDS[i].taiMinusUTC - gpstime::TAI_MINUS_GPS;
+            start = (i == 0) ? numeric_limits<int64_t>::min() : gpsStart(i);
+            end = (i == gpstime::LEAP_SECOND_COUNT - 1) ?
+                  numeric_limits<int64_t>::max() : gpsStart(i + 1);
+            return gpsMinusUTC;
+        }
+
+        static int64_t gpsStart(int i)
+        {
+            return gpstime::LEAP_SECONDS[i].utc +
+                   gpstime::LEAP_SECONDS[i].taiMinusUTC - gpstime::TAI_MINUS_GPS;
+        }
+    };
+}
+
+base::Time gpstime::utcToGPS(base::Time const& utc)
+{
+    return offset(utc, getGPSMinusUTC(floorSeconds(utc)));
+}
+
+base::Time gpstime::gpsToUTC(base::Time const& gps)
+{
+    return offset(gps, -getGPSMinusUTCFromGPS(floorSeconds(gps)));
+}
+
+base::Time gpstime::utcToTAI(base::Time const& utc)
+{
+    return offset(utc, getTAIMinusUTC(floorSeconds(utc)));
+}
+
+base::Time gpstime::taiToUTC(base::Time const& tai)
+{
+    return gpsToUTC(taiToGPS(tai));
+}
+
+base::Time gpstime::gpsToTAI(base::Time const& gps)
+{
+    return offset(gps, TAI_MINUS_GPS);
+}
+
+base::Time gpstime::taiToGPS(base::Time const& tai)
+{
+    return offset(tai, -TAI_MINUS_GPS);
+}
+
+base::Time gpstime::weekTimeToUTC(WeekTime const& time)
+{
+    return gpsToUTC(weekTimeToGPS(time));
+}
+
+gpstime::WeekTime gpstime::utcToWeekTime(base::Time const& utc)
+{
+    int64_t us = utcToGPS(utc).toMicroseconds() - GPS_EPOCH * USEC_PER_SEC;
+    int64_t usPerWeek = static_cast<int64_t>(SECONDS_PER_WEEK) * USEC_PER_SEC;
+    int64_t week = us / usPerWeek;
+    int64_t remainder = us % usPerWeek;
+    if (remainder < 0) {
+        week -= 1;
+        remainder += usPerWeek;
+    }
+
+    WeekTime result;
+    result.week = week;
+    result.tow = static_cast<double>(remainder) / USEC_PER_SEC;
+    return result;
+}
+
+vector<base::Time> gpstime::weekTimeToUTC(vector<WeekTime> const& times)
+{
+    LeapSecondInterval interval;
+    vector<base::Time> result;
+    result.reserve(times.size());
+    for (auto const& time : times) {
+        base::Time gps = weekTimeToGPS(time);
+        result.push_back(offset(gps, -interval.get(floorSeconds(gps))));
+    }
+    return result;
+}
+
+vector<base::Time> gpstime::gpsToUTC(vector<base::Time> const& times)
+{
+    LeapSecondInterval interval;
+    vector<base::Time> result;
+    result.reserve(times.size());
+    for (auto const& gps : times) {
+        result.push_back(offset(gps, -interval.get(floorSeconds(gps))));
+    }
+    return result;
+}
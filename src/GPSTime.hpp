@@ -0,0 +1,120 @@
+#ifndef GPS_BASE_GPSTIME_HPP
+#define GPS_BASE_GPSTIME_HPP
+
+#include <cstdint>
+#include <vector>
+#include <base/Time.hpp>
+
+namespace gps_base {
+    /** Conversions between the UTC, GPS and TAI time scales
+     *
+     * Unless specified otherwise, times are represented by base::Time,
+     * counted from the Unix epoch but in the given time scale. For instance,
+     * utcToGPS(t) is 18s ahead of t since 2017.
+     *
+     * The leap second table is only valid from the GPS epoch (1980-01-06)
+     * onwards, and needs to be updated when new leap seconds are announced.
+     */
+    namespace gpstime {
+        /** A change in the TAI - UTC offset */
+        struct LeapSecond {
+            /** UTC time at which the offset applies, in seconds since the
+             * Unix epoch
+             */
+            std::int64_t utc;
+            /** TAI - UTC, in seconds */
+            int taiMinusUTC;
+        };
+
+        constexpr LeapSecond LEAP_SECONDS[] = {
+            { 315964800, 19 }, // 1980-01-06, GPS epoch
+            { 362793600, 20 }, // 1981-07-01
+            { 394329600, 21 }, // 1982-07-01
+            { 425865600, 22 }, // 1983-07-01
+            { 489024000, 23 }, // 1985-07-01
+            { 567993600, 24 }, // 1988-01-01
+            { 631152000, 25 }, // 1990-01-01
+            { 662688000, 26 }, // 1991-01-01
+            { 709948800, 27 }, // 1992-07-01
+            { 741484800, 28 }, // 1993-07-01
+            { 773020800, 29 }, // 1994-07-01
+            { 820454400, 30 }, // 1996-01-01
+            { 867715200, 31 }, // 1997-07-01
+            { 915148800, 32 }, // 1999-01-01
+            { 1136073600, 33 }, // 2006-01-01
+            { 1230768000, 34 }, // 2009-01-01
+            { 1341100800, 35 }, // 2012-07-01
+            { 1435708800, 36 }, // 2015-07-01
+            { 1483228800, 37 }  // 2017-01-01
+        };
+        constexpr int LEAP_SECOND_COUNT = sizeof(LEAP_SECONDS) / sizeof(LEAP_SECONDS[0]);
+
+        /** TAI - GPS, in seconds. This offset is constant */
+        constexpr int TAI_MINUS_GPS = 19;
+        /** The GPS epoch (1980-01-06) in seconds since the Unix epoch */
+        constexpr std::int64_t GPS_EPOCH = 315964800;
+        constexpr int SECONDS_PER_WEEK = 604800;
+
+        /** TAI - UTC at the given UTC time, in seconds since the Unix epoch */
+        constexpr int getTAIMinusUTC(std::int64_t utc)
+        {
+            int i = LEAP_SECOND_COUNT - 1;
+            while (i > 0 && utc < LEAP_SECONDS[i].utc)
+                --i;
+            return LEAP_SECONDS[i].taiMinusUTC;
+        }
+
+        /** GPS - UTC at the given UTC time, in seconds since the Unix epoch */
+        constexpr int getGPSMinusUTC(std::int64_t utc)
+        {
+            return getTAIMinusUTC(utc) - TAI_MINUS_GPS;
+        }
+
+        /** GPS - UTC at the given GPS time, in seconds since the Unix epoch */
+        constexpr int getGPSMinusUTCFromGPS(std::int64_t gps)
+        {
+            int i = LEAP_SECOND_COUNT - 1;
+            while (i > 0 && gps < LEAP_SECONDS[i].utc +
+                                  LEAP_SECONDS[i].taiMinusUTC - TAI_MINUS_GPS)
+                --i;
+            return LEAP_SECONDS[i].taiMinusUTC - TAI_MINUS_GPS;
+        }
+
+        static_assert(getGPSMinusUTC(1483228800) == 18, "GPS - UTC is 18s since 2017");
+
+        /** A time in GPS week and time of week */
+        struct WeekTime {
+            /** Full week number since the GPS epoch, i.e. not modulo 1024 */
+            int week;
+            /** Time of week in seconds */
+            double tow;
+        };
+
+        base::Time utcToGPS(base::Time const& utc);
+        base::Time gpsToUTC(base::Time const& gps);
+        base::Time utcToTAI(base::Time const& utc);
+        base::Time taiToUTC(base::Time const& tai);
+        base::Time gpsToTAI(base::Time const& gps);
+        base::Time taiToGPS(base::Time const& tai);
+
+        /** Convert a GPS week and time of week into UTC */
+        base::Time weekTimeToUTC(WeekTime const& time);
+        /** Convert a UTC time into GPS week and time of week */
+        WeekTime utcToWeekTime(base::Time const& utc);
+
+        /** Convert many GPS week and time of week into UTC
+         *
+         * The leap second interval of the previous entry is reused, making
+         * it faster than calling weekTimeToUTC on each entry
+         */
+        std::vector<base::Time> weekTimeToUTC(std::vector<WeekTime> const& times);
+
+        /** Convert many GPS times (on the GPS time scale) into UTC
+         *
+         * Batch version of gpsToUTC
+         */
+        std::vector<base::Time> gpsToUTC(std::vector<base::Time> const& times);
+    }
+}
+
+#endif
@@ -0,0 +1,190 @@
+#include <gps_base/Geodesic.hpp>
+
+#include <geodesic.h>
+#include <cmath>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    geod_geodesic const& wgs84() {
+        static geod_geodesic const geod = [] {
+            geod_geodesic g;
+            geod_init(&g, geodesic::WGS84_A, geodesic::WGS84_F);
+            return g;
+        }();
+        return geod;
+    }
+
+    /** Reduced (parametric) latitude of a point, in radians */
+    struct ReducedLatitude {
+        double beta;
+        double sin;
+        double cos;
+
+        explicit ReducedLatitude(double latitude) {
+            double phi = latitude * M_PI / 180;
+            beta = atan2((1 - geodesic::WGS84_F) * std::sin(phi), std::cos(phi));
+            sin = std::sin(beta);
+            cos = std::cos(beta);
+        }
+    };
+
+    /** Above this value of the haversine of the central angle (i.e. 90
+     * degrees of arc), the Andoyer-Lambert approximation is not within
+     * its documented bounds anymore
+     */
+    double const APPROXIMATION_MAX_HAVERSINE = 0.5;
+
+    double exactDistance(double lat1, double lon1, double lat2, double lon2) {
+        double s12;
+        geod_inverse(&wgs84(), lat1, lon1, lat2, lon2, &s12, nullptr, nullptr);
+        return s12;
+    }
+
+    double approximateDistance(ReducedLatitude const& r1, ReducedLatitude const& r2,
+                               double lat1, double lon1, double lat2, double lon2) {
+        double sinHalfDBeta = sin((r2.beta - r1.beta) / 2);
+        double sinHalfDLon = sin((lon2 - lon1) * M_PI / 360);
+        double h = sinHalfDBeta * sinHalfDBeta +
+                   r1.cos * r2.cos * sinHalfDLon * sinHalfDLon;
+        if (h == 0) {
+            return 0;
+        }
+        else if (!(h < APPROXIMATION_MAX_HAVERSINE)) {
+            return exactDistance(lat1, lon1, lat2, lon2);
+        }
+
+        // sin^2(sigma/2) = h, cos^2(sigma/2) = 1 - h
+        double sigma = 2 * asin(sqrt(h));
+        double sinSigma = 2 * sqrt(h * (1 - h));
+        double sinPcosQ = (r1.sin + r2.sin) / 2;
+        double cosPsinQ = (r2.sin - r1.sin) / 2;
+        double x = (sigma - sinSigma) * sinPcosQ * sinPcosQ / (1 - h);
+        double y = (sigma + sinSigma) * cosPsinQ * cosPsinQ / h;
+        return geodesic::WGS84_A * (sigma - geodesic::WGS84_F / 2 * (x + y));
+    }
+}
+
+geodesic::Inverse geodesic::inverse(double latitude1, double longitude1,
+                                    double latitude2, double longitude2) {
+    Inverse result;
+    geod_inverse(&wgs84(), latitude1, longitude1, latitude2, longitude2,
+                 &result.distance, &result.azimuth1, &result.azimuth2);
+    return result;
+}
+
+geodesic::Inverse geodesic::inverse(Solution const& from, Solution const& to) {
+    return inverse(from.latitude, from.longitude, to.latitude, to.longitude);
+}
+
+geodesic::Direct geodesic::direct(double latitude, double longitude,
+                                  double azimuth, double distance) {
+    Direct result;
+    geod_direct(&wgs84(), latitude, longitude, azimuth, distance,
+                &result.latitude, &result.longitude, &result.azimuth);
+    return result;
+}
+
+geodesic::Direct geodesic::direct(Solution const& from, double azimuth, double distance) {
+    return direct(from.latitude, from.longitude, azimuth, distance);
+}
+
+double geodesic::approximateDistance(double latitude1, double longitude1,
+                                     double latitude2, double longitude2) {
+    return ::approximateDistance(ReducedLatitude(latitude1), ReducedLatitude(latitude2),
+                                 latitude1, longitude1, latitude2, longitude2);
+}
+
+double geodesic::distance(double latitude1, double longitude1,
+                          double latitude2, double longitude2, Mode mode) {
+    if (mode == MODE_APPROXIMATE) {
+        return approximateDistance(latitude1, longitude1, latitude2, longitude2);
+    }
+    return exactDistance(latitude1, longitude1, latitude2, longitude2);
+}
+
+double geodesic::distance(Solution const& from, Solution const& to, Mode mode) {
+    return distance(from.latitude, from.longitude, to.latitude, to.longitude, mode);
+}
+
+void geodesic::distances(double latitude, double longitude, size_t count,
+                         double const* latitudes, double const* longitudes,
+                         double* distances, Mode mode) {
+    if (mode == MODE_APPROXIMATE) {
+        ReducedLatitude reference(latitude);
+        for (size_t i = 0; i < count; ++i) {
+            distances[i] = ::approximateDistance(
+                reference, ReducedLatitude(latitudes[i]),
+                latitude, longitude, latitudes[i], longitudes[i]);
+        }
+    }
+    else {
+        for (size_t i = 0; i < count; ++i) {
+            distances[i] = exactDistance(latitude, longitude,
+                                         latitudes[i], longitudes[i]);
+        }
+    }
+}
+
+vector<double> geodesic::distances(Solution const& from,
+                                   vector<Solution> const& to, Mode mode) {
+    vector<double> latitudes(to.size());
+    vector<double> longitudes(to.size());
+    for (size_t i = 0; i < to.size(); ++i) {
+        latitudes[i] = to[i].latitude;
+        longitudes[i] = to[i].longitude;
+    }
+
+    vector<double> result(to.size());
+    distances(from.latitude, from.longitude, to.size(),
+              latitudes.data(), longitudes.data(), result.data(), mode);
+    return result;
+}
+
+void geodesic::consecutiveDistances(size_t count,
+                                    double const* latitudes,
+                                    double const* longitudes,
+                                    double* distances, Mode mode) {
+    if (count < 2) {
+        return;
+    }
+
+    if (mode == MODE_APPROXIMATE) {
+        // Each reduced latitude is computed once and reused as the start
+        // of the next segment
+        ReducedLatitude previous(latitudes[0]);
+        for (size_t i = 1; i < count; ++i) {
+            ReducedLatitude current(latitudes[i]);
+            distances[i - 1] = ::approximateDistance(
+                previous, current, latitudes[i - 1], longitudes[i - 1],
+                latitudes[i], longitudes[i]);
+            previous = current;
+        }
+    }
+    else {
+        for (size_t i = 1; i < count; ++i) {
+            distances[i - 1] = exactDistance(latitudes[i - 1], longitudes[i - 1],
+                                             latitudes[i], longitudes[i]);
+        }
+    }
+}
+
+vector<double> geodesic::consecutiveDistances(vector<Solution> const& trajectory,
+                                              Mode mode) {
+    if (trajectory.size() < 2) {
+        return vector<double>();
+    }
+
+    vector<double> latitudes(trajectory.size());
+    vector<double> longitudes(trajectory.size());
+    for (size_t i = 0; i < trajectory.size(); ++i) {
+        latitudes[i] = trajectory[i].latitude;
+        longitudes[i] = trajectory[i].longitude;
+    }
+
+    vector<double> result(trajectory.size() - 1);
+    consecutiveDistances(trajectory.size(), latitudes.data(), longitudes.data(),
+                         result.data(), mode);
+    return result;
+}
@@ -0,0 +1,126 @@
+#ifndef GPS_BASE_GEODESIC_HPP
+#define GPS_BASE_GEODESIC_HPP
+
+#include <cstddef>
+#include <vector>
+#include <gps_base/BaseTypes.hpp>
+
+namespace gps_base {
+    /** Distances and bearings on the WGS84 ellipsoid
+     *
+     * Unlike going through UTMConverter, these are valid across UTM zones
+     * and over arbitrary distances. The exact computations use Karney's
+     * algorithms (as shipped with PROJ), which are accurate to a few
+     * nanometers.
+     *
+     * Latitudes, longitudes and azimuths are in degrees, azimuths being
+     * measured clockwise from north. Distances are in meters. NaN inputs
+     * produce NaN outputs.
+     */
+    namespace geodesic {
+        /** WGS84 semi-major axis, in meters */
+        constexpr double WGS84_A = 6378137.0;
+        /** WGS84 flattening */
+        constexpr double WGS84_F = 1 / 298.257223563;
+
+        enum Mode {
+            /** Solve the geodesic problem exactly */
+            MODE_EXACT,
+            /** Use a closed-form approximation
+             *
+             * See approximateDistance for the error bounds. Only distance
+             * computations have an approximate mode
+             */
+            MODE_APPROXIMATE
+        };
+
+        /** Result of the inverse geodesic problem */
+        struct Inverse {
+            /** Distance between the two points */
+            double distance;
+            /** Azimuth of the geodesic at the first point */
+            double azimuth1;
+            /** Azimuth of the geodesic at the second point */
+            double azimuth2;
+        };
+
+        /** Result of the direct geodesic problem */
+        struct Direct {
+            double latitude;
+            double longitude;
+            /** Azimuth of the geodesic at the end point */
+            double azimuth;
+        };
+
+        /** Compute the shortest path between two points */
+        Inverse inverse(double latitude1, double longitude1,
+                        double latitude2, double longitude2);
+
+        /** @overload */
+        Inverse inverse(Solution const& from, Solution const& to);
+
+        /** Compute the point reached by following the geodesic that starts
+         * at the given point and azimuth for the given distance
+         */
+        Direct direct(double latitude, double longitude,
+                      double azimuth, double distance);
+
+        /** @overload */
+        Direct direct(Solution const& from, double azimuth, double distance);
+
+        /** Fast approximation of the distance between two points
+         *
+         * This is Andoyer-Lambert's first-order correction of the
+         * great-circle distance on the reduced latitudes. Its relative
+         * error is below 1.5e-6 (1.5mm per km) when the points are less
+         * than a quarter of the earth's circumference apart. The exact
+         * solver is used beyond that, where the approximation degrades.
+         */
+        double approximateDistance(double latitude1, double longitude1,
+                                   double latitude2, double longitude2);
+
+        /** Distance between two points */
+        double distance(double latitude1, double longitude1,
+                        double latitude2, double longitude2,
+                        Mode mode = MODE_EXACT);
+
+        /** @overload */
+        double distance(Solution const& from, Solution const& to,
+                        Mode mode = MODE_EXACT);
+
+        /** Distances from one point to many points
+         *
+         * The output array must hold @a count elements. In approximate
+         * mode, the terms that depend only on the reference point are
+         * computed once.
+         */
+        void distances(double latitude, double longitude,
+                       std::size_t count,
+                       double const* latitudes, double const* longitudes,
+                       double* distances,
+                       Mode mode = MODE_EXACT);
+
+        /** @overload */
+        std::vector<double> distances(Solution const& from,
+                                      std::vector<Solution> const& to,
+                                      Mode mode = MODE_EXACT);
+
+        /** Distances between consecutive points of a trajectory
+         *
+         * Element i of the output is the distance between points i and
+         * i + 1, i.e. the output array must hold @a count - 1 elements
+         */
+        void consecutiveDistances(std::size_t count,
+                                  double const* latitudes,
+                                  double const* longitudes,
+                                  double* distances,
+                                  Mode mode = MODE_EXACT);
+
+        /** @overload */
+        std::vector<double> consecutiveDistances(
+            std::vector<Solution> const& trajectory,
+            Mode mode = MODE_EXACT);
+    }
+}
+
+#endif
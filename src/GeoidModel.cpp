@@ -0,0 +1,338 @@
+#include <gps_base/GeoidModel.hpp>
+
+#include <base/Float.hpp>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    /** Minimal reader for the header of a binary PGM file
+     *
+     * It collects the comments, as GeographicLib stores the grid's offset
+     * and scale in them
+     */
+    class PGMHeader {
+        uint8_t const* mCursor;
+        uint8_t const* mEnd;
+        string const& mPath;
+
+    public:
+        bool hasOffset = false;
+        bool hasScale = false;
+        double offset = 0;
+        double scale = 0;
+
+        PGMHeader(uint8_t const* begin, uint8_t const* end, string const& path)
+            : mCursor(begin)
+            , mEnd(end)
+            , mPath(path) {}
+
+        uint8_t const* getCursor() const {
+            return mCursor;
+        }
+
+        void fail(string const& message) const {
+            throw runtime_error("GeoidModel: " + mPath + ": " + message);
+        }
+
+        void skipSpacesAndComments() {
+            while (mCursor != mEnd) {
+                if (*mCursor == '#') {
+                    uint8_t const* line = mCursor + 1;
+                    while (mCursor != mEnd && *mCursor != '\n') {
+                        ++mCursor;
+                    }
+                    parseComment(string(line, mCursor));
+                }
+                else if (isspace(*mCursor)) {
+                    ++mCursor;
+                }
+                else {
+                    return;
+                }
+            }
+        }
+
+        void parseComment(string const& comment) {
+            char const* text = comment.c_str();
+            while (*text == ' ') {
+                ++text;
+            }
+            if (strncmp(text, "Offset ", 7) == 0) {
+                offset = parseNumber(text + 7);
+                hasOffset = true;
+            }
+            else if (strncmp(text, "Scale ", 6) == 0) {
+                scale = parseNumber(text + 6);
+                hasScale = true;
+            }
+        }
+
+        double parseNumber(char const* text) const {
+            char* end;
+            double value = strtod(text, &end);
+            if (end == text) {
+                fail("invalid offset or scale");
+            }
+            return value;
+        }
+
+        string readToken() {
+            skipSpacesAndComments();
+            uint8_t const* start = mCursor;
+            while (mCursor != mEnd && !isspace(*mCursor) && *mCursor != '#') {
+                ++mCursor;
+            }
+            if (start == mCursor) {
+                fail("truncated header");
+            }
+            return string(start, mCursor);
+        }
+
+        size_t readUnsigned() {
+            string token = readToken();
+            char* end;
+            unsigned long value = strtoul(token.c_str(), &end, 10);
+            if (*end != '\0' || token[0] == '-') {
+                fail("invalid header value '" + token + "'");
+            }
+            return value;
+        }
+
+        /** Skip the single whitespace character that ends the header */
+        void endHeader() {
+            if (mCursor == mEnd || !isspace(*mCursor)) {
+                fail("truncated header");
+            }
+            ++mCursor;
+        }
+    };
+
+    /** Weights of the cubic convolution kernel (a = -1/2) */
+    void cubicWeights(double t, double weights[4]) {
+        double t2 = t * t;
+        double t3 = t2 * t;
+        weights[0] = -0.5 * t3 + t2 - 0.5 * t;
+        weights[1] = 1.5 * t3 - 2.5 * t2 + 1;
+        weights[2] = -1.5 * t3 + 2 * t2 + 0.5 * t;
+        weights[3] = 0.5 * t3 - 0.5 * t2;
+    }
+}
+
+GeoidModel::GeoidModel(string const& path, Interpolation interpolation)
+    : mMapping(nullptr)
+    , mMappingSize(0)
+    , mData(nullptr)
+    , mWidth(0)
+    , mHeight(0)
+    , mOffset(0)
+    , mScale(0)
+    , mInterpolation(interpolation)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw runtime_error("GeoidModel: cannot open " + path);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == -1) {
+        ::close(fd);
+        throw runtime_error("GeoidModel: cannot stat " + path);
+    }
+    mMappingSize = info.st_size;
+    if (mMappingSize == 0) {
+        ::close(fd);
+        throw runtime_error("GeoidModel: " + path + " is empty");
+    }
+
+    void* data = mmap(nullptr, mMappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw runtime_error("GeoidModel: cannot map " + path);
+    }
+    mMapping = static_cast<uint8_t const*>(data);
+
+    try {
+        PGMHeader header(mMapping, mMapping + mMappingSize, path);
+        if (header.readToken() != "P5") {
+            header.fail("not a binary PGM file");
+        }
+        mWidth = header.readUnsigned();
+        mHeight = header.readUnsigned();
+        size_t maxValue = header.readUnsigned();
+        header.endHeader();
+
+        if (maxValue != 65535) {
+            header.fail("expected 16-bit samples");
+        }
+        if (!header.hasOffset || !header.hasScale) {
+            header.fail("missing the Offset or Scale comment");
+        }
+        if (mWidth < 1 || mHeight < 2) {
+            header.fail("invalid grid size");
+        }
+        mOffset = header.offset;
+        mScale = header.scale;
+        mData = header.getCursor();
+        size_t available = mMapping + mMappingSize - mData;
+        if (available / 2 / mWidth < mHeight) {
+            header.fail("truncated data");
+        }
+    }
+    catch(...) {
+        munmap(const_cast<uint8_t*>(mMapping), mMappingSize);
+        throw;
+    }
+}
+
+GeoidModel::~GeoidModel()
+{
+    munmap(const_cast<uint8_t*>(mMapping), mMappingSize);
+}
+
+GeoidModel::Interpolation GeoidModel::getInterpolation() const
+{
+    return mInterpolation;
+}
+
+size_t GeoidModel::getWidth() const
+{
+    return mWidth;
+}
+
+size_t GeoidModel::getHeight() const
+{
+    return mHeight;
+}
+
+double GeoidModel::getLatitudeResolution() const
+{
+    return 180.0 / (mHeight - 1);
+}
+
+double GeoidModel::getLongitudeResolution() const
+{
+    return 360.0 / mWidth;
+}
+
+double GeoidModel::getSample(size_t row, size_t column) const
+{
+    uint8_t const* sample = mData + 2 * (row * mWidth + column);
+    return mOffset + mScale * ((static_cast<unsigned int>(sample[0]) << 8) | sample[1]);
+}
+
+bool GeoidModel::locate(double latitude, double longitude,
+                        size_t& row, size_t& column,
+                        double& u, double& v) const
+{
+    if (!(std::abs(latitude) <= 90) || !std::isfinite(longitude)) {
+        return false;
+    }
+
+    double y = (90 - latitude) / getLatitudeResolution();
+    row = min<size_t>(floor(y), mHeight - 2);
+    v = y - row;
+
+    double wrapped = fmod(longitude, 360.0);
+    if (wrapped < 0) {
+        wrapped += 360;
+    }
+    double x = wrapped / getLongitudeResolution();
+    column = floor(x);
+    u = x - column;
+    if (column >= mWidth) {
+        column -= mWidth;
+    }
+    return true;
+}
+
+void GeoidModel::load(Stencil& stencil, size_t row, size_t column) const
+{
+    stencil.row = row;
+    stencil.column = column;
+
+    // The bilinear interpolation only needs the inner 2x2 samples
+    int first = 1;
+    int last = 2;
+    if (mInterpolation == INTERPOLATION_BICUBIC) {
+        first = 0;
+        last = 3;
+    }
+
+    for (int i = first; i <= last; ++i) {
+        long r = static_cast<long>(row) + i - 1;
+        size_t clampedRow = min<long>(max<long>(r, 0), mHeight - 1);
+        for (int j = first; j <= last; ++j) {
+            size_t c = (column + mWidth + j - 1) % mWidth;
+            stencil.values[i][j] = getSample(clampedRow, c);
+        }
+    }
+}
+
+double GeoidModel::interpolate(Stencil const& stencil, double u, double v) const
+{
+    if (mInterpolation == INTERPOLATION_BILINEAR) {
+        double top = (1 - u) * stencil.values[1][1] + u * stencil.values[1][2];
+        double bottom = (1 - u) * stencil.values[2][1] + u * stencil.values[2][2];
+        return (1 - v) * top + v * bottom;
+    }
+
+    double wu[4];
+    double wv[4];
+    cubicWeights(u, wu);
+    cubicWeights(v, wv);
+    double result = 0;
+    for (int i = 0; i < 4; ++i) {
+        double row = 0;
+        for (int j = 0; j < 4; ++j) {
+            row += wu[j] * stencil.values[i][j];
+        }
+        result += wv[i] * row;
+    }
+    return result;
+}
+
+double GeoidModel::getSeparation(double latitude, double longitude) const
+{
+    size_t row, column;
+    double u, v;
+    if (!locate(latitude, longitude, row, column, u, v)) {
+        return base::unknown<double>();
+    }
+
+    Stencil stencil;
+    load(stencil, row, column);
+    return interpolate(stencil, u, v);
+}
+
+void GeoidModel::getSeparations(size_t count,
+                                double const* latitudes,
+                                double const* longitudes,
+                                double* separations) const
+{
+    Stencil stencil;
+    bool loaded = false;
+    for (size_t i = 0; i < count; ++i) {
+        size_t row, column;
+        double u, v;
+        if (!locate(latitudes[i], longitudes[i], row, column, u, v)) {
+            separations[i] = base::unknown<double>();
+            continue;
+        }
+
+        if (!loaded || stencil.row != row || stencil.column != column) {
+            load(stencil, row, column);
+            loaded = true;
+        }
+        separations[i] = interpolate(stencil, u, v);
+    }
+}
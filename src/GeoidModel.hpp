@@ -0,0 +1,113 @@
+#ifndef GPS_BASE_GEOIDMODEL_HPP
+#define GPS_BASE_GEOIDMODEL_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace gps_base
+{
+    /** Geoid height grid, used to compute the geoidal separation
+     *
+     * It reads the geoid grids distributed by GeographicLib (e.g. egm96-5.pgm
+     * or egm2008-2_5.pgm). These are binary PGM (P5) images whose header has
+     * the "# Offset" and "# Scale" comments that convert the big-endian
+     * 16-bit pixels into geoid heights in meters. Row 0 is the north pole,
+     * the last row the south pole, and column 0 the Greenwich meridian. The
+     * grid wraps around in longitude.
+     *
+     * The file is memory-mapped, i.e. only the pages that are queried are
+     * loaded. The model is immutable once loaded, and can therefore be
+     * shared between threads.
+     *
+     * The bicubic interpolation is a cubic convolution on the 4x4
+     * neighbourhood of the point. It is smooth, but is not the 12-point fit
+     * used by GeographicLib, from which it differs by a few millimeters on
+     * the 5' grids. Near the poles, the stencil is clamped to the first and
+     * last rows.
+     */
+    class GeoidModel
+    {
+    public:
+        enum Interpolation {
+            INTERPOLATION_BILINEAR,
+            INTERPOLATION_BICUBIC
+        };
+
+        /** Load a grid
+         *
+         * @throw std::runtime_error if the file cannot be opened or is not a
+         *   valid geoid grid
+         */
+        explicit GeoidModel(std::string const& path,
+                            Interpolation interpolation = INTERPOLATION_BILINEAR);
+        GeoidModel(GeoidModel const&) = delete;
+        GeoidModel& operator=(GeoidModel const&) = delete;
+        ~GeoidModel();
+
+        Interpolation getInterpolation() const;
+
+        /** Number of columns, i.e. of samples along a parallel */
+        std::size_t getWidth() const;
+        /** Number of rows, i.e. of samples along a meridian, both poles
+         * included
+         */
+        std::size_t getHeight() const;
+
+        /** Grid spacing in latitude, in degrees */
+        double getLatitudeResolution() const;
+        /** Grid spacing in longitude, in degrees */
+        double getLongitudeResolution() const;
+
+        /** Height of the geoid above the WGS84 ellipsoid, in meters
+         *
+         * This is the value expected in Solution::geoidalSeparation. It is
+         * NaN if either coordinate is NaN.
+         *
+         * @param latitude latitude in degrees
+         * @param longitude longitude in degrees
+         */
+        double getSeparation(double latitude, double longitude) const;
+
+        /** Geoid heights of arrays of coordinates
+         *
+         * Consecutive points that fall in the same grid cell reuse the
+         * samples read for the previous one, which makes this considerably
+         * faster than repeated calls to getSeparation() on trajectories.
+         */
+        void getSeparations(std::size_t count,
+                            double const* latitudes,
+                            double const* longitudes,
+                            double* separations) const;
+
+    private:
+        /** Samples around a grid cell, already scaled to meters */
+        struct Stencil {
+            std::size_t row;
+            std::size_t column;
+            double values[4][4];
+        };
+
+        std::uint8_t const* mMapping;
+        std::size_t mMappingSize;
+        std::uint8_t const* mData;
+        std::size_t mWidth;
+        std::size_t mHeight;
+        double mOffset;
+        double mScale;
+        Interpolation mInterpolation;
+
+        double getSample(std::size_t row, std::size_t column) const;
+
+        /** Cell of the given coordinates, and offsets within it in [0, 1)
+         *
+         * @return false if the coordinates are NaN
+         */
+        bool locate(double latitude, double longitude,
+                    std::size_t& row, std::size_t& column,
+                    double& u, double& v) const;
+        void load(Stencil& stencil, std::size_t row, std::size_t column) const;
+        double interpolate(Stencil const& stencil, double u, double v) const;
+    };
+}
+
+#endif
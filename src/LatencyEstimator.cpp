@@ -0,0 +1,84 @@
+#include <gps_base/LatencyEstimator.hpp>
+
+#include <cmath>
+#include <stdexcept>
+
+using namespace gps_base;
+using namespace std;
+
+LatencyEstimator::LatencyEstimator(base::Time const& window, double alpha)
+    : mWindow(window)
+    , mAlpha(alpha)
+{
+    if (alpha <= 0 || alpha > 1) {
+        throw invalid_argument("LatencyEstimator: alpha must be in (0, 1]");
+    }
+    reset();
+}
+
+void LatencyEstimator::reset()
+{
+    mMinima.clear();
+    mSampleCount = 0;
+    mMean = 0;
+    mVariance = 0;
+}
+
+void LatencyEstimator::update(base::Time const& solutionTime,
+                              base::Time const& arrivalTime)
+{
+    base::Time latency = arrivalTime - solutionTime;
+
+    while (!mMinima.empty() && mMinima.back().latency >= latency) {
+        mMinima.pop_back();
+    }
+    mMinima.push_back(Sample { arrivalTime, latency });
+    while (mMinima.front().arrival + mWindow < arrivalTime) {
+        mMinima.pop_front();
+    }
+
+    double value = latency.toSeconds();
+    if (mSampleCount == 0) {
+        mMean = value;
+        mVariance = 0;
+    }
+    else {
+        double delta = value - mMean;
+        mMean += mAlpha * delta;
+        mVariance = (1 - mAlpha) * (mVariance + mAlpha * delta * delta);
+    }
+    ++mSampleCount;
+}
+
+void LatencyEstimator::update(Solution const& solution, base::Time const& arrivalTime)
+{
+    update(solution.time, arrivalTime);
+}
+
+size_t LatencyEstimator::getSampleCount() const
+{
+    return mSampleCount;
+}
+
+base::Time LatencyEstimator::getLatency() const
+{
+    if (mMinima.empty()) {
+        return base::Time();
+    }
+    return mMinima.front().latency;
+}
+
+base::Time LatencyEstimator::getMeanLatency() const
+{
+    return base::Time::fromSeconds(mMean);
+}
+
+base::Time LatencyEstimator::getJitter() const
+{
+    return base::Time::fromSeconds(sqrt(mVariance));
+}
+
+base::Time LatencyEstimator::toCPUTime(base::Time const& solutionTime) const
+{
+    return solutionTime + getLatency();
+}
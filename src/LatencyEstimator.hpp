@@ -0,0 +1,75 @@
+#ifndef GPS_BASE_LATENCYESTIMATOR_HPP
+#define GPS_BASE_LATENCYESTIMATOR_HPP
+
+#include <deque>
+#include <base/Time.hpp>
+#include <gps_base/BaseTypes.hpp>
+
+namespace gps_base
+{
+    /** Online estimation of the latency between the time of a solution and
+     * its arrival on the CPU
+     *
+     * The latency is estimated as the minimum of the observed latencies
+     * over a sliding window. Since delays only ever add to the transport
+     * latency, the minimum is a robust estimate of its fixed part. The mean
+     * and standard deviation are tracked as exponentially-weighted moving
+     * averages.
+     *
+     * The solution times must be in UTC, see gpstime::gpsToUTC
+     */
+    class LatencyEstimator
+    {
+        struct Sample {
+            base::Time arrival;
+            base::Time latency;
+        };
+
+        base::Time mWindow;
+        double mAlpha;
+        /** Samples whose latency is a candidate for the minimum over the
+         * window, ordered by arrival time and latency
+         */
+        std::deque<Sample> mMinima;
+        std::size_t mSampleCount;
+        double mMean;
+        double mVariance;
+
+    public:
+        /**
+         * @param window duration of the sliding window for the minimum
+         * @param alpha smoothing factor of the moving averages, in (0, 1]
+         */
+        explicit LatencyEstimator(
+            base::Time const& window = base::Time::fromSeconds(10.0),
+            double alpha = 0.05);
+
+        void reset();
+
+        /** Add an observation */
+        void update(base::Time const& solutionTime, base::Time const& arrivalTime);
+
+        /** @overload */
+        void update(Solution const& solution, base::Time const& arrivalTime);
+
+        /** Number of observations since construction or the last reset */
+        std::size_t getSampleCount() const;
+
+        /** Minimum latency over the window
+         *
+         * Returns a null time if there has been no observations
+         */
+        base::Time getLatency() const;
+
+        /** Moving average of the latency */
+        base::Time getMeanLatency() const;
+
+        /** Moving standard deviation of the latency */
+        base::Time getJitter() const;
+
+        /** Estimate the CPU time at which the given solution time happened */
+        base::Time toCPUTime(base::Time const& solutionTime) const;
+    };
+}
+
+#endif
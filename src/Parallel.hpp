@@ -0,0 +1,64 @@
+#ifndef GPS_BASE_PARALLEL_HPP
+#define GPS_BASE_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace gps_base {
+    namespace details {
+        /** Number of threads to use when the caller asked for @a requested
+         *
+         * Zero means "one per hardware thread"
+         */
+        inline unsigned int getThreadCount(unsigned int requested)
+        {
+            if (requested != 0)
+                return requested;
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        /** Call f(begin, end) on contiguous ranges of [0, count) in parallel
+         *
+         * The ranges are processed by at most @a threads threads (zero
+         * meaning one per hardware thread). The first exception thrown by
+         * @a f is rethrown once all threads finished.
+         */
+        template<typename F>
+        void parallelFor(std::size_t count, unsigned int threads, F f)
+        {
+            std::size_t n = std::min<std::size_t>(getThreadCount(threads), count);
+            if (n <= 1) {
+                if (count)
+                    f(std::size_t(0), count);
+                return;
+            }
+
+            std::vector<std::exception_ptr> errors(n);
+            std::vector<std::thread> workers;
+            workers.reserve(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                std::size_t begin = count * i / n;
+                std::size_t end = count * (i + 1) / n;
+                workers.emplace_back([&f, &errors, i, begin, end]() {
+                    try {
+                        f(begin, end);
+                    }
+                    catch(...) {
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+            for (auto& worker : workers)
+                worker.join();
+            for (auto const& error : errors) {
+                if (error)
+                    std::rethrow_exception(error);
+            }
+        }
+    }
+}
+
+#endif
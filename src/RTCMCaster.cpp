@@ -0,0 +1,538 @@
+#include <gps_base/RTCMCaster.hpp>
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <unordered_map>
+
+using namespace gps_base;
+using namespace std;
+
+const size_t RTCMCaster::MAX_FRAME_SIZE;
+
+namespace {
+    /** Maximum number of frames written by a single sendmsg call */
+    const size_t MAX_IOV = 64;
+    /** Maximum number of events processed per epoll_wait call */
+    const int MAX_EVENTS = 256;
+
+    void fail(string const& message) {
+        throw runtime_error("RTCMCaster: " + message + ": " + strerror(errno));
+    }
+}
+
+class RTCMCaster::Reactor {
+    struct Client {
+        int fd;
+        deque<Frame> queue;
+        /** Number of bytes of the first frame in the queue already sent */
+        size_t offset = 0;
+        size_t queuedBytes = 0;
+        /** Whether the client is registered for EPOLLOUT */
+        bool waitingOutput = false;
+
+        explicit Client(int fd)
+            : fd(fd) {}
+    };
+
+    RTCMCaster& mCaster;
+    int mEpollFD = -1;
+    int mWakeFD = -1;
+    /** The listening socket, or -1 if this reactor does not accept */
+    int mListenFD = -1;
+    /** Descriptor released to accept and close connections when the process
+     * runs out of file descriptors
+     */
+    int mSpareFD = -1;
+    size_t mNextReactor = 0;
+    unordered_map<int, Client> mClients;
+
+    mutex mInboxLock;
+    vector<Frame> mInboxFrames;
+    vector<int> mInboxClients;
+    bool mWakePending = false;
+    bool mStop = false;
+
+    void addToEpoll(int fd, uint32_t events) {
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = events;
+        event.data.fd = fd;
+        if (epoll_ctl(mEpollFD, EPOLL_CTL_ADD, fd, &event) != 0) {
+            fail("cannot add a descriptor to epoll");
+        }
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        ssize_t written = ::write(mWakeFD, &one, sizeof(one));
+        (void)written;
+    }
+
+    /** Queue a notification from another thread */
+    template<typename F>
+    void post(F const& f) {
+        bool needsWake;
+        {
+            lock_guard<mutex> lock(mInboxLock);
+            f();
+            needsWake = !mWakePending;
+            mWakePending = true;
+        }
+        if (needsWake) {
+            wake();
+        }
+    }
+
+    void registerClient(int fd) {
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(mEpollFD, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            mCaster.mCounters.clients--;
+            mCaster.mCounters.disconnectedClients++;
+            return;
+        }
+        mClients.emplace(fd, Client(fd));
+    }
+
+    void closeClient(int fd) {
+        epoll_ctl(mEpollFD, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        mClients.erase(fd);
+        mCaster.mCounters.clients--;
+        mCaster.mCounters.disconnectedClients++;
+    }
+
+    /** Accept and close a connection while out of file descriptors
+     *
+     * @return false if it could not be done
+     */
+    bool rejectClient() {
+        if (mSpareFD < 0) {
+            return false;
+        }
+        ::close(mSpareFD);
+        int fd = ::accept(mListenFD, nullptr, nullptr);
+        if (fd >= 0) {
+            ::close(fd);
+            mCaster.mCounters.rejectedClients++;
+        }
+        mSpareFD = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+        return fd >= 0;
+    }
+
+    void acceptClients() {
+        while (true) {
+            int fd = ::accept4(mListenFD, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                }
+                else if ((errno == EMFILE || errno == ENFILE) && rejectClient()) {
+                    continue;
+                }
+                return;
+            }
+
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            mCaster.mCounters.acceptedClients++;
+            mCaster.mCounters.clients++;
+
+            auto& reactors = mCaster.mReactors;
+            Reactor& target = *reactors[mNextReactor++ % reactors.size()];
+            if (&target == this) {
+                registerClient(fd);
+            }
+            else {
+                target.post([&target, fd]() { target.mInboxClients.push_back(fd); });
+            }
+        }
+    }
+
+    void setWaitingOutput(Client& client, bool enable) {
+        if (client.waitingOutput == enable) {
+            return;
+        }
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = enable ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        event.data.fd = client.fd;
+        epoll_ctl(mEpollFD, EPOLL_CTL_MOD, client.fd, &event);
+        client.waitingOutput = enable;
+    }
+
+    /** Write as much of the client's queue as the socket accepts
+     *
+     * @return false if the client must be disconnected
+     */
+    bool flush(Client& client) {
+        while (!client.queue.empty()) {
+            iovec iov[MAX_IOV];
+            size_t count = 0;
+            for (auto it = client.queue.begin();
+                 it != client.queue.end() && count < MAX_IOV; ++it, ++count) {
+                size_t offset = (count == 0) ? client.offset : 0;
+                iov[count].iov_base = const_cast<uint8_t*>((*it)->data() + offset);
+                iov[count].iov_len = (*it)->size() - offset;
+            }
+
+            msghdr message;
+            memset(&message, 0, sizeof(message));
+            message.msg_iov = iov;
+            message.msg_iovlen = count;
+            // MSG_NOSIGNAL avoids SIGPIPE on disconnected clients without
+            // having to change the process' signal handling
+            ssize_t sent = ::sendmsg(client.fd, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (sent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                return false;
+            }
+
+            mCaster.mCounters.sentBytes += sent;
+            client.queuedBytes -= sent;
+            size_t remaining = sent;
+            while (remaining != 0) {
+                size_t left = client.queue.front()->size() - client.offset;
+                if (remaining < left) {
+                    client.offset += remaining;
+                    break;
+                }
+                remaining -= left;
+                client.offset = 0;
+                client.queue.pop_front();
+            }
+        }
+        setWaitingOutput(client, !client.queue.empty());
+        return true;
+    }
+
+    /** Read and discard whatever the client sent
+     *
+     * @return false if the client must be disconnected
+     */
+    bool drainInput(Client& client) {
+        uint8_t buffer[4096];
+        while (true) {
+            ssize_t size = ::read(client.fd, buffer, sizeof(buffer));
+            if (size > 0) {
+                continue;
+            }
+            else if (size == 0) {
+                return false;
+            }
+            else if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+    }
+
+    /** Process the frames and clients handed over by the other threads
+     *
+     * @return false if the reactor must stop
+     */
+    bool processInbox() {
+        uint64_t value;
+        ssize_t size = ::read(mWakeFD, &value, sizeof(value));
+        (void)size;
+
+        vector<Frame> frames;
+        vector<int> clients;
+        {
+            lock_guard<mutex> lock(mInboxLock);
+            if (mStop) {
+                return false;
+            }
+            frames.swap(mInboxFrames);
+            clients.swap(mInboxClients);
+            mWakePending = false;
+        }
+
+        for (int fd : clients) {
+            registerClient(fd);
+        }
+        if (frames.empty()) {
+            return true;
+        }
+
+        size_t maxQueuedBytes = mCaster.mConfiguration.maxQueuedBytes;
+        vector<int> disconnected;
+        for (auto& entry : mClients) {
+            Client& client = entry.second;
+            for (auto const& frame : frames) {
+                if (client.queuedBytes + frame->size() > maxQueuedBytes) {
+                    mCaster.mCounters.droppedFrames++;
+                    continue;
+                }
+                client.queue.push_back(frame);
+                client.queuedBytes += frame->size();
+            }
+            // A client waiting for EPOLLOUT will be flushed when the socket
+            // is writable again
+            if (!client.waitingOutput && !flush(client)) {
+                disconnected.push_back(client.fd);
+            }
+        }
+        for (int fd : disconnected) {
+            closeClient(fd);
+        }
+        return true;
+    }
+
+    void processClient(int fd, uint32_t events) {
+        auto it = mClients.find(fd);
+        if (it == mClients.end()) {
+            return;
+        }
+        Client& client = it->second;
+        bool keep = !(events & (EPOLLERR | EPOLLHUP));
+        if (keep && (events & EPOLLIN)) {
+            keep = drainInput(client);
+        }
+        if (keep && (events & EPOLLOUT)) {
+            keep = flush(client);
+        }
+        if (!keep) {
+            closeClient(fd);
+        }
+    }
+
+public:
+    Reactor(RTCMCaster& caster, int listenFD)
+        : mCaster(caster)
+        , mListenFD(listenFD) {
+        mEpollFD = epoll_create1(EPOLL_CLOEXEC);
+        if (mEpollFD < 0) {
+            fail("cannot create the epoll descriptor");
+        }
+        mWakeFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (mWakeFD < 0) {
+            ::close(mEpollFD);
+            fail("cannot create the event descriptor");
+        }
+
+        try {
+            addToEpoll(mWakeFD, EPOLLIN);
+            if (mListenFD >= 0) {
+                addToEpoll(mListenFD, EPOLLIN);
+                mSpareFD = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+            }
+        }
+        catch(...) {
+            ::close(mWakeFD);
+            ::close(mEpollFD);
+            throw;
+        }
+    }
+
+    ~Reactor() {
+        if (mSpareFD >= 0) {
+            ::close(mSpareFD);
+        }
+        ::close(mWakeFD);
+        ::close(mEpollFD);
+    }
+
+    void broadcast(Frame const& frame) {
+        post([this, &frame]() { mInboxFrames.push_back(frame); });
+    }
+
+    void requestStop() {
+        post([this]() { mStop = true; });
+    }
+
+    void run() {
+        epoll_event events[MAX_EVENTS];
+        bool running = true;
+        while (running) {
+            int count = epoll_wait(mEpollFD, events, MAX_EVENTS, -1);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+
+            for (int i = 0; i < count && running; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == mWakeFD) {
+                    running = processInbox();
+                }
+                else if (fd == mListenFD) {
+                    acceptClients();
+                }
+                else {
+                    processClient(fd, events[i].events);
+                }
+            }
+        }
+        disconnectAll();
+    }
+
+    void disconnectAll() {
+        while (!mClients.empty()) {
+            closeClient(mClients.begin()->first);
+        }
+
+        lock_guard<mutex> lock(mInboxLock);
+        for (int fd : mInboxClients) {
+            ::close(fd);
+            mCaster.mCounters.clients--;
+            mCaster.mCounters.disconnectedClients++;
+        }
+        mInboxClients.clear();
+        mInboxFrames.clear();
+    }
+};
+
+RTCMCaster::Counters::Counters()
+    : clients(0)
+    , acceptedClients(0)
+    , disconnectedClients(0)
+    , rejectedClients(0)
+    , frames(0)
+    , sentBytes(0)
+    , droppedFrames(0) {
+}
+
+RTCMCaster::RTCMCaster(RTCMCasterConfiguration const& configuration)
+    : mConfiguration(configuration)
+    , mStopped(false)
+    , mListenFD(-1)
+    , mPort(0) {
+    if (configuration.reactors == 0) {
+        throw invalid_argument("RTCMCaster: needs at least one reactor");
+    }
+    else if (configuration.maxQueuedBytes < MAX_FRAME_SIZE) {
+        throw invalid_argument("RTCMCaster: maxQueuedBytes must be at least "
+                               "MAX_FRAME_SIZE");
+    }
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(configuration.port);
+    if (inet_pton(AF_INET, configuration.address.c_str(), &address.sin_addr) != 1) {
+        throw invalid_argument("RTCMCaster: invalid address '" +
+                               configuration.address + "'");
+    }
+
+    mListenFD = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (mListenFD < 0) {
+        fail("cannot create the listening socket");
+    }
+    try {
+        int one = 1;
+        setsockopt(mListenFD, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (::bind(mListenFD, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            fail("cannot bind to " + configuration.address + ":" +
+                 to_string(configuration.port));
+        }
+        if (::listen(mListenFD, configuration.backlog) != 0) {
+            fail("cannot listen");
+        }
+        socklen_t length = sizeof(address);
+        if (getsockname(mListenFD, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            fail("cannot get the listening port");
+        }
+        mPort = ntohs(address.sin_port);
+
+        for (unsigned int i = 0; i < configuration.reactors; ++i) {
+            mReactors.emplace_back(new Reactor(*this, i == 0 ? mListenFD : -1));
+        }
+        for (auto& reactor : mReactors) {
+            Reactor* r = reactor.get();
+            mThreads.emplace_back([r]() { r->run(); });
+        }
+    }
+    catch(...) {
+        stop();
+        throw;
+    }
+}
+
+RTCMCaster::~RTCMCaster() {
+    stop();
+}
+
+uint16_t RTCMCaster::getPort() const {
+    return mPort;
+}
+
+size_t RTCMCaster::push(uint8_t const* data, size_t size) {
+    return push(vector<uint8_t>(data, data + size));
+}
+
+size_t RTCMCaster::push(vector<uint8_t> const& data) {
+    lock_guard<mutex> lock(mPushLock);
+    mReassembly.push(data);
+
+    size_t count = 0;
+    while (true) {
+        auto frame = mReassembly.pull();
+        if (frame.empty()) {
+            return count;
+        }
+        broadcast(make_shared<vector<uint8_t> const>(move(frame)));
+        ++count;
+    }
+}
+
+void RTCMCaster::broadcast(Frame const& frame) {
+    if (mStopped) {
+        return;
+    }
+    mCounters.frames++;
+    for (auto& reactor : mReactors) {
+        reactor->broadcast(frame);
+    }
+}
+
+RTCMCasterStatistics RTCMCaster::getStatistics() const {
+    RTCMCasterStatistics statistics;
+    statistics.clients = mCounters.clients;
+    statistics.acceptedClients = mCounters.acceptedClients;
+    statistics.disconnectedClients = mCounters.disconnectedClients;
+    statistics.rejectedClients = mCounters.rejectedClients;
+    statistics.frames = mCounters.frames;
+    statistics.sentBytes = mCounters.sentBytes;
+    statistics.droppedFrames = mCounters.droppedFrames;
+    return statistics;
+}
+
+void RTCMCaster::stop() {
+    if (mStopped.exchange(true)) {
+        return;
+    }
+
+    for (auto& reactor : mReactors) {
+        reactor->requestStop();
+    }
+    for (auto& thread : mThreads) {
+        thread.join();
+    }
+    mThreads.clear();
+    if (mListenFD >= 0) {
+        ::close(mListenFD);
+        mListenFD = -1;
+    }
+}
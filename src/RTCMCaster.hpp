@@ -0,0 +1,147 @@
+#ifndef GPS_BASE_RTCMCASTER_HPP
+#define GPS_BASE_RTCMCASTER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gps_base/RTCMReassembly.hpp>
+
+namespace gps_base
+{
+    struct RTCMCasterConfiguration {
+        /** Address the caster listens on */
+        std::string address = "0.0.0.0";
+        /** Port the caster listens on, zero meaning any free port
+         *
+         * @see RTCMCaster::getPort
+         */
+        std::uint16_t port = 2101;
+        /** Number of reactor threads the clients are spread over */
+        unsigned int reactors = 1;
+        /** Maximum number of bytes queued for a single client
+         *
+         * Frames that would make a client's queue exceed this are dropped
+         * for that client. Frames are always dropped whole, i.e. clients
+         * only ever receive complete RTCM frames. It must be at least
+         * RTCMCaster::MAX_FRAME_SIZE.
+         */
+        std::size_t maxQueuedBytes = 65536;
+        /** Backlog of the listening socket */
+        int backlog = 1024;
+    };
+
+    struct RTCMCasterStatistics {
+        /** Number of currently connected clients */
+        std::uint64_t clients = 0;
+        std::uint64_t acceptedClients = 0;
+        std::uint64_t disconnectedClients = 0;
+        /** Connections that were closed right away because the process ran
+         * out of file descriptors
+         */
+        std::uint64_t rejectedClients = 0;
+        /** Number of frames broadcast */
+        std::uint64_t frames = 0;
+        /** Number of bytes sent, summed over all clients */
+        std::uint64_t sentBytes = 0;
+        /** Number of frames dropped, summed over all clients */
+        std::uint64_t droppedFrames = 0;
+    };
+
+    /** TCP server that fans a stream of RTCM frames out to many clients
+     *
+     * The caster is event-driven: each of the configured reactor threads
+     * multiplexes its share of the clients with epoll, and the first one
+     * also accepts the new connections. Clients are assigned to the
+     * reactors round-robin.
+     *
+     * A broadcast frame is allocated once and shared by the queues of all
+     * clients. Each client's queue is flushed with a single scatter-gather
+     * write. A client whose queue is full (see
+     * RTCMCasterConfiguration::maxQueuedBytes) misses the frames broadcast
+     * until it catches up.
+     *
+     * The data sent by the clients (e.g. NTRIP requests) is read and
+     * ignored.
+     *
+     * This is Linux-specific.
+     */
+    class RTCMCaster
+    {
+    public:
+        typedef std::shared_ptr<std::vector<std::uint8_t> const> Frame;
+
+        /** Size of the largest RTCM frame */
+        static const std::size_t MAX_FRAME_SIZE = 1029;
+
+        /** Bind the listening socket and start the reactors
+         *
+         * @throw std::runtime_error if the socket cannot be set up
+         * @throw std::invalid_argument if the configuration is invalid
+         */
+        explicit RTCMCaster(RTCMCasterConfiguration const& configuration);
+        RTCMCaster(RTCMCaster const&) = delete;
+        RTCMCaster& operator=(RTCMCaster const&) = delete;
+        ~RTCMCaster();
+
+        /** Port the caster listens on */
+        std::uint16_t getPort() const;
+
+        /** Push raw data from the base station
+         *
+         * The data is framed with RTCMReassembly, and the complete frames
+         * are broadcast. It is thread-safe.
+         *
+         * @return the number of frames broadcast
+         */
+        std::size_t push(std::uint8_t const* data, std::size_t size);
+
+        /** @overload */
+        std::size_t push(std::vector<std::uint8_t> const& data);
+
+        /** Send a single, already framed, message to all clients
+         *
+         * It is thread-safe.
+         */
+        void broadcast(Frame const& frame);
+
+        RTCMCasterStatistics getStatistics() const;
+
+        /** Disconnect all clients and stop the reactors
+         *
+         * It is called by the destructor
+         */
+        void stop();
+
+    private:
+        class Reactor;
+
+        struct Counters {
+            std::atomic<std::uint64_t> clients;
+            std::atomic<std::uint64_t> acceptedClients;
+            std::atomic<std::uint64_t> disconnectedClients;
+            std::atomic<std::uint64_t> rejectedClients;
+            std::atomic<std::uint64_t> frames;
+            std::atomic<std::uint64_t> sentBytes;
+            std::atomic<std::uint64_t> droppedFrames;
+
+            Counters();
+        };
+
+        RTCMCasterConfiguration mConfiguration;
+        std::atomic<bool> mStopped;
+        int mListenFD;
+        std::uint16_t mPort;
+        Counters mCounters;
+        std::vector<std::unique_ptr<Reactor>> mReactors;
+        std::vector<std::thread> mThreads;
+
+        std::mutex mPushLock;
+        RTCMReassembly mReassembly;
+    };
+}
+
+#endif
@@ -0,0 +1,275 @@
+#include <gps_base/SolutionHistory.hpp>
+
+#include <base/Float.hpp>
+#include <stdexcept>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    bool isValid(Solution const& solution) {
+        return solution.positionType != NO_SOLUTION &&
+               solution.positionType != INVALID;
+    }
+
+    /** Rank of a solution type, higher meaning more precise */
+    int getPrecisionRank(GPS_SOLUTION_TYPES type) {
+        switch (type) {
+            case AUTONOMOUS_2D: return 0;
+            case AUTONOMOUS: return 1;
+            case DIFFERENTIAL: return 2;
+            case RTK_FLOAT: return 3;
+            case RTK_FIXED: return 4;
+            default: return -1;
+        }
+    }
+
+    double lerp(double a, double b, double factor) {
+        return a + (b - a) * factor;
+    }
+
+    double lerpLongitude(double a, double b, double factor) {
+        double delta = b - a;
+        if (delta > 180) {
+            delta -= 360;
+        }
+        else if (delta < -180) {
+            delta += 360;
+        }
+        double result = a + delta * factor;
+        if (result >= 180) {
+            result -= 360;
+        }
+        else if (result < -180) {
+            result += 360;
+        }
+        return result;
+    }
+
+    Solution invalidSolution(base::Time const& time) {
+        Solution solution;
+        solution.time = time;
+        solution.positionType = INVALID;
+        solution.latitude = base::unknown<double>();
+        solution.longitude = base::unknown<double>();
+        solution.altitude = base::unknown<double>();
+        return solution;
+    }
+}
+
+SolutionHistory::SolutionHistory(size_t capacity)
+    : mBuffer(capacity)
+    , mStart(0)
+    , mSize(0)
+{
+    if (capacity == 0) {
+        throw invalid_argument("SolutionHistory: capacity cannot be zero");
+    }
+}
+
+size_t SolutionHistory::getCapacity() const
+{
+    return mBuffer.size();
+}
+
+size_t SolutionHistory::size() const
+{
+    return mSize;
+}
+
+bool SolutionHistory::empty() const
+{
+    return mSize == 0;
+}
+
+void SolutionHistory::clear()
+{
+    mStart = 0;
+    mSize = 0;
+}
+
+Solution const& SolutionHistory::operator[](size_t i) const
+{
+    size_t index = mStart + i;
+    if (index >= mBuffer.size()) {
+        index -= mBuffer.size();
+    }
+    return mBuffer[index];
+}
+
+bool SolutionHistory::push(Solution const& solution)
+{
+    if (mSize && solution.time <= (*this)[mSize - 1].time) {
+        return false;
+    }
+
+    if (mSize < mBuffer.size()) {
+        size_t index = (mStart + mSize) % mBuffer.size();
+        mBuffer[index] = solution;
+        ++mSize;
+    }
+    else {
+        mBuffer[mStart] = solution;
+        mStart = (mStart + 1) % mBuffer.size();
+    }
+    return true;
+}
+
+void SolutionHistory::setMaxGap(base::Time const& gap)
+{
+    mMaxGap = gap;
+}
+
+base::Time SolutionHistory::getMaxGap() const
+{
+    return mMaxGap;
+}
+
+void SolutionHistory::setConverter(UTMConverter const& converter)
+{
+    mConverter = make_shared<UTMConverter const>(converter);
+}
+
+size_t SolutionHistory::upperBound(base::Time const& time, size_t first) const
+{
+    size_t count = mSize - first;
+    while (count > 0) {
+        size_t step = count / 2;
+        size_t i = first + step;
+        if ((*this)[i].time <= time) {
+            first = i + 1;
+            count -= step + 1;
+        }
+        else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+bool SolutionHistory::findNeighbours(base::Time const& time, size_t& hint,
+                                     size_t& before, size_t& after,
+                                     double& factor) const
+{
+    if (hint > mSize || (hint > 0 && (*this)[hint - 1].time > time)) {
+        hint = 0;
+    }
+    size_t upper = upperBound(time, hint);
+    hint = upper;
+    if (upper == 0) {
+        return false;
+    }
+
+    before = upper - 1;
+    Solution const& previous = (*this)[before];
+    if (previous.time == time) {
+        after = before;
+        factor = 0;
+        return isValid(previous);
+    }
+    else if (upper == mSize) {
+        return false;
+    }
+
+    after = upper;
+    Solution const& next = (*this)[after];
+    if (!isValid(previous) || !isValid(next)) {
+        return false;
+    }
+
+    base::Time gap = next.time - previous.time;
+    if (!mMaxGap.isNull() && gap > mMaxGap) {
+        return false;
+    }
+    factor = static_cast<double>((time - previous.time).toMicroseconds()) /
+             gap.toMicroseconds();
+    return true;
+}
+
+Solution SolutionHistory::interpolate(base::Time const& time, size_t& hint) const
+{
+    size_t before, after;
+    double factor;
+    if (!findNeighbours(time, hint, before, after, factor)) {
+        return invalidSolution(time);
+    }
+
+    Solution const& a = (*this)[before];
+    Solution const& b = (*this)[after];
+    Solution result;
+    result.time = time;
+    result.latitude = lerp(a.latitude, b.latitude, factor);
+    result.longitude = lerpLongitude(a.longitude, b.longitude, factor);
+    result.altitude = lerp(a.altitude, b.altitude, factor);
+    result.geoidalSeparation = lerp(a.geoidalSeparation, b.geoidalSeparation, factor);
+    result.ageOfDifferentialCorrections =
+        lerp(a.ageOfDifferentialCorrections, b.ageOfDifferentialCorrections, factor);
+    result.deviationLatitude = lerp(a.deviationLatitude, b.deviationLatitude, factor);
+    result.deviationLongitude = lerp(a.deviationLongitude, b.deviationLongitude, factor);
+    result.deviationAltitude = lerp(a.deviationAltitude, b.deviationAltitude, factor);
+    result.positionType =
+        getPrecisionRank(a.positionType) <= getPrecisionRank(b.positionType) ?
+        a.positionType : b.positionType;
+    result.noOfSatellites = min(a.noOfSatellites, b.noOfSatellites);
+    return result;
+}
+
+Solution SolutionHistory::interpolate(base::Time const& time) const
+{
+    size_t hint = 0;
+    return interpolate(time, hint);
+}
+
+vector<Solution> SolutionHistory::interpolate(vector<base::Time> const& times) const
+{
+    vector<Solution> result;
+    result.reserve(times.size());
+    size_t hint = 0;
+    for (auto const& time : times) {
+        result.push_back(interpolate(time, hint));
+    }
+    return result;
+}
+
+base::samples::RigidBodyState SolutionHistory::interpolateNWU(
+    base::Time const& time, size_t& hint) const
+{
+    if (!mConverter) {
+        throw logic_error("SolutionHistory::interpolateNWU called without a converter");
+    }
+
+    size_t before, after;
+    double factor;
+    if (!findNeighbours(time, hint, before, after, factor)) {
+        base::samples::RigidBodyState result;
+        result.time = time;
+        return result;
+    }
+
+    base::samples::RigidBodyState result = mConverter->convertToNWU((*this)[before]);
+    if (after != before) {
+        base::samples::RigidBodyState next = mConverter->convertToNWU((*this)[after]);
+        result.position += (next.position - result.position) * factor;
+        result.cov_position += (next.cov_position - result.cov_position) * factor;
+    }
+    result.time = time;
+    return result;
+}
+
+base::samples::RigidBodyState SolutionHistory::interpolateNWU(base::Time const& time) const
+{
+    size_t hint = 0;
+    return interpolateNWU(time, hint);
+}
+
+vector<base::samples::RigidBodyState> SolutionHistory::interpolateNWU(
+    vector<base::Time> const& times) const
+{
+    vector<base::samples::RigidBodyState> result;
+    result.reserve(times.size());
+    size_t hint = 0;
+    for (auto const& time : times) {
+        result.push_back(interpolateNWU(time, hint));
+    }
+    return result;
+}
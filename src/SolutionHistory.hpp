@@ -0,0 +1,108 @@
+#ifndef GPS_BASE_SOLUTIONHISTORY_HPP
+#define GPS_BASE_SOLUTIONHISTORY_HPP
+
+#include <memory>
+#include <vector>
+#include <gps_base/BaseTypes.hpp>
+#include <gps_base/UTMConverter.hpp>
+
+namespace gps_base
+{
+    /** Fixed-capacity history of solutions, indexed by time
+     *
+     * It is meant to give the GNSS position at the timestamps of other
+     * sensors, interpolating between the received solutions. Solutions must
+     * be pushed in increasing time order. Once the capacity is reached,
+     * the oldest solutions are dropped.
+     *
+     * Interpolation is refused - and the returned solution has its
+     * positionType set to INVALID - when the requested time is outside the
+     * history, when one of the neighbouring solutions is NO_SOLUTION or
+     * INVALID, or when the neighbours are further apart than the maximum
+     * gap.
+     */
+    class SolutionHistory
+    {
+        std::vector<Solution> mBuffer;
+        std::size_t mStart;
+        std::size_t mSize;
+        base::Time mMaxGap;
+        std::shared_ptr<UTMConverter const> mConverter;
+
+        /** Index of the first solution whose time is strictly greater than
+         * @a time, searching within [first, size)
+         */
+        std::size_t upperBound(base::Time const& time, std::size_t first) const;
+
+        /** Find the neighbours of @a time
+         *
+         * @return false if there are no valid neighbours to interpolate from
+         */
+        bool findNeighbours(base::Time const& time, std::size_t& hint,
+                            std::size_t& before, std::size_t& after,
+                            double& factor) const;
+
+        Solution interpolate(base::Time const& time, std::size_t& hint) const;
+        base::samples::RigidBodyState interpolateNWU(
+            base::Time const& time, std::size_t& hint) const;
+
+    public:
+        explicit SolutionHistory(std::size_t capacity);
+
+        std::size_t getCapacity() const;
+        std::size_t size() const;
+        bool empty() const;
+        void clear();
+
+        /** Return the i-th solution, 0 being the oldest */
+        Solution const& operator[](std::size_t i) const;
+
+        /** Add a solution to the history
+         *
+         * @return false if the solution is not strictly newer than the last
+         *   solution in the history, in which case it is ignored
+         */
+        bool push(Solution const& solution);
+
+        /** Set the maximum time between two solutions for interpolation
+         *
+         * A null time (the default) disables the check
+         */
+        void setMaxGap(base::Time const& gap);
+        base::Time getMaxGap() const;
+
+        /** Set the converter used by interpolateNWU */
+        void setConverter(UTMConverter const& converter);
+
+        /** Interpolate the latitude, longitude, altitude and deviations at
+         * the given time
+         *
+         * The position type and number of satellites are the least precise
+         * of the two neighbours
+         */
+        Solution interpolate(base::Time const& time) const;
+
+        /** Interpolate at many timestamps
+         *
+         * The lookup is fastest when @a times is sorted
+         */
+        std::vector<Solution> interpolate(std::vector<base::Time> const& times) const;
+
+        /** Interpolate in the NWU frame of the attached converter
+         *
+         * The neighbouring solutions are converted with
+         * UTMConverter::convertToNWU and the position and covariance are
+         * interpolated linearly. Returns an invalid RBS with only its time
+         * set if interpolation is not possible.
+         *
+         * @throw std::logic_error if setConverter has not been called
+         */
+        base::samples::RigidBodyState interpolateNWU(base::Time const& time) const;
+
+        /** Interpolate in the NWU frame at many timestamps */
+        std::vector<base::samples::RigidBodyState> interpolateNWU(
+            std::vector<base::Time> const& times) const;
+    };
+}
+
+#endif
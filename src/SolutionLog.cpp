@@ -0,0 +1,439 @@
+#include <gps_base/SolutionLog.hpp>
+
+#include "Varint.hpp"
+#include <algorithm>
+#include <base/Float.hpp>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    const char FILE_MAGIC[8] = { 'G', 'P', 'S', 'S', 'O', 'L', 'O', 'G' };
+    const uint32_t FILE_VERSION = 1;
+    const uint32_t BLOCK_MAGIC = 0x4B4C4253; // "SBLK"
+    const uint32_t TRAILER_MAGIC = 0x58444E49; // "INDX"
+    const size_t HEADER_SIZE = sizeof(FILE_MAGIC) + 4;
+    const size_t BLOCK_HEADER_SIZE = 12;
+    const size_t INDEX_ENTRY_SIZE = 28;
+    const size_t TRAILER_SIZE = 16;
+
+    const double ANGLE_SCALE = 1e9;
+    const double ALTITUDE_SCALE = 1e4;
+    /** Encoding of non-finite values in the scaled integer columns */
+    const int64_t INVALID_SCALED = numeric_limits<int64_t>::min();
+
+    int64_t toScaled(double value, double scale) {
+        double scaled = value * scale;
+        if (!std::isfinite(scaled) || std::abs(scaled) >= 9e18) {
+            return INVALID_SCALED;
+        }
+        return llround(scaled);
+    }
+
+    double fromScaled(int64_t value, double scale) {
+        if (value == INVALID_SCALED) {
+            return base::unknown<double>();
+        }
+        return value / scale;
+    }
+
+    /** Delta-encode a column of integers
+     *
+     * Deltas are computed with wrapping arithmetic so that any sequence,
+     * including INVALID_SCALED, round-trips
+     */
+    template<typename F>
+    void writeDeltas(string& out, vector<Solution> const& block, F value) {
+        uint64_t previous = 0;
+        for (auto const& solution : block) {
+            uint64_t current = static_cast<uint64_t>(value(solution));
+            varint::writeSigned(out, static_cast<int64_t>(current - previous));
+            previous = current;
+        }
+    }
+
+    template<typename F>
+    void readDeltas(uint8_t const*& cursor, uint8_t const* end, size_t count, F store) {
+        uint64_t previous = 0;
+        for (size_t i = 0; i < count; ++i) {
+            previous += static_cast<uint64_t>(varint::readSigned(cursor, end));
+            store(i, static_cast<int64_t>(previous));
+        }
+    }
+
+    template<typename F>
+    void writeFloats(string& out, vector<Solution> const& block, F value) {
+        for (auto const& solution : block) {
+            varint::writeFixed<float>(out, value(solution));
+        }
+    }
+
+    void readFloats(uint8_t const*& cursor, uint8_t const* end, vector<double>& column) {
+        for (size_t i = 0; i < column.size(); ++i) {
+            column[i] = varint::readFixed<float>(cursor, end);
+        }
+    }
+
+    uint8_t encodeSatelliteCount(int count) {
+        if (count < 0) {
+            return 255;
+        }
+        return static_cast<uint8_t>(min(count, 254));
+    }
+
+    int decodeSatelliteCount(uint8_t count) {
+        return count == 255 ? -1 : count;
+    }
+}
+
+size_t SolutionColumns::size() const
+{
+    return time.size();
+}
+
+void SolutionColumns::resize(size_t size)
+{
+    time.resize(size);
+    latitude.resize(size);
+    longitude.resize(size);
+    positionType.resize(size);
+    noOfSatellites.resize(size);
+    altitude.resize(size);
+    geoidalSeparation.resize(size);
+    ageOfDifferentialCorrections.resize(size);
+    deviationLatitude.resize(size);
+    deviationLongitude.resize(size);
+    deviationAltitude.resize(size);
+}
+
+void SolutionColumns::clear()
+{
+    resize(0);
+}
+
+Solution SolutionColumns::get(size_t i) const
+{
+    Solution solution;
+    solution.time = time[i];
+    solution.latitude = latitude[i];
+    solution.longitude = longitude[i];
+    solution.positionType = static_cast<GPS_SOLUTION_TYPES>(positionType[i]);
+    solution.noOfSatellites = decodeSatelliteCount(noOfSatellites[i]);
+    solution.altitude = altitude[i];
+    solution.geoidalSeparation = geoidalSeparation[i];
+    solution.ageOfDifferentialCorrections = ageOfDifferentialCorrections[i];
+    solution.deviationLatitude = deviationLatitude[i];
+    solution.deviationLongitude = deviationLongitude[i];
+    solution.deviationAltitude = deviationAltitude[i];
+    return solution;
+}
+
+void SolutionColumns::set(size_t i, Solution const& solution)
+{
+    time[i] = solution.time;
+    latitude[i] = solution.latitude;
+    longitude[i] = solution.longitude;
+    positionType[i] = solution.positionType;
+    noOfSatellites[i] = encodeSatelliteCount(solution.noOfSatellites);
+    altitude[i] = solution.altitude;
+    geoidalSeparation[i] = solution.geoidalSeparation;
+    ageOfDifferentialCorrections[i] = solution.ageOfDifferentialCorrections;
+    deviationLatitude[i] = solution.deviationLatitude;
+    deviationLongitude[i] = solution.deviationLongitude;
+    deviationAltitude[i] = solution.deviationAltitude;
+}
+
+SolutionLogWriter::SolutionLogWriter(string const& path, size_t blockSize)
+    : mFile(path, ios::binary | ios::trunc)
+    , mBlockSize(blockSize)
+    , mOffset(0)
+{
+    if (!mFile) {
+        throw runtime_error("SolutionLogWriter: cannot open " + path);
+    }
+    if (mBlockSize == 0) {
+        throw invalid_argument("SolutionLogWriter: the block size cannot be zero");
+    }
+    mBlock.reserve(mBlockSize);
+
+    string header(FILE_MAGIC, sizeof(FILE_MAGIC));
+    varint::writeFixed<uint32_t>(header, FILE_VERSION);
+    writeRaw(header);
+}
+
+SolutionLogWriter::~SolutionLogWriter()
+{
+    try {
+        close();
+    }
+    catch(...) {
+    }
+}
+
+void SolutionLogWriter::writeRaw(string const& data)
+{
+    mFile.write(data.data(), data.size());
+    if (!mFile) {
+        throw runtime_error("SolutionLogWriter: failed to write");
+    }
+    mOffset += data.size();
+}
+
+void SolutionLogWriter::write(Solution const& solution)
+{
+    if (!mFile.is_open()) {
+        throw logic_error("SolutionLogWriter: writing on a closed log");
+    }
+
+    mBlock.push_back(solution);
+    if (mBlock.size() >= mBlockSize) {
+        writeBlock();
+    }
+}
+
+void SolutionLogWriter::flush()
+{
+    if (!mBlock.empty()) {
+        writeBlock();
+    }
+    mFile.flush();
+}
+
+void SolutionLogWriter::writeBlock()
+{
+    string payload;
+    payload.reserve(mBlock.size() * 48);
+    writeDeltas(payload, mBlock, [](Solution const& s) {
+        return s.time.toMicroseconds();
+    });
+    writeDeltas(payload, mBlock, [](Solution const& s) {
+        return toScaled(s.latitude, ANGLE_SCALE);
+    });
+    writeDeltas(payload, mBlock, [](Solution const& s) {
+        return toScaled(s.longitude, ANGLE_SCALE);
+    });
+    writeDeltas(payload, mBlock, [](Solution const& s) {
+        return toScaled(s.altitude, ALTITUDE_SCALE);
+    });
+    for (auto const& solution : mBlock) {
+        payload.push_back(static_cast<char>(solution.positionType));
+    }
+    for (auto const& solution : mBlock) {
+        payload.push_back(static_cast<char>(encodeSatelliteCount(solution.noOfSatellites)));
+    }
+    writeFloats(payload, mBlock, [](Solution const& s) { return s.geoidalSeparation; });
+    writeFloats(payload, mBlock, [](Solution const& s) { return s.ageOfDifferentialCorrections; });
+    writeFloats(payload, mBlock, [](Solution const& s) { return s.deviationLatitude; });
+    writeFloats(payload, mBlock, [](Solution const& s) { return s.deviationLongitude; });
+    writeFloats(payload, mBlock, [](Solution const& s) { return s.deviationAltitude; });
+
+    SolutionLogBlockInfo info;
+    info.offset = mOffset;
+    info.count = mBlock.size();
+    info.firstTime = mBlock.front().time;
+    info.lastTime = mBlock.back().time;
+
+    string header;
+    varint::writeFixed<uint32_t>(header, BLOCK_MAGIC);
+    varint::writeFixed<uint32_t>(header, info.count);
+    varint::writeFixed<uint32_t>(header, payload.size());
+    writeRaw(header);
+    writeRaw(payload);
+
+    mIndex.push_back(info);
+    mBlock.clear();
+}
+
+void SolutionLogWriter::close()
+{
+    if (!mFile.is_open()) {
+        return;
+    }
+
+    flush();
+
+    string index;
+    for (auto const& info : mIndex) {
+        varint::writeFixed<uint64_t>(index, info.offset);
+        varint::writeFixed<uint32_t>(index, info.count);
+        varint::writeFixed<int64_t>(index, info.firstTime.toMicroseconds());
+        varint::writeFixed<int64_t>(index, info.lastTime.toMicroseconds());
+    }
+    varint::writeFixed<uint64_t>(index, mOffset);
+    varint::writeFixed<uint32_t>(index, mIndex.size());
+    varint::writeFixed<uint32_t>(index, TRAILER_MAGIC);
+    writeRaw(index);
+    mFile.close();
+}
+
+SolutionLogReader::SolutionLogReader(string const& path)
+    : mData(nullptr)
+    , mSize(0)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw runtime_error("SolutionLogReader: cannot open " + path);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == -1) {
+        ::close(fd);
+        throw runtime_error("SolutionLogReader: cannot stat " + path);
+    }
+    mSize = info.st_size;
+    if (mSize < HEADER_SIZE + TRAILER_SIZE) {
+        ::close(fd);
+        throw runtime_error("SolutionLogReader: " + path + " is not a solution log");
+    }
+
+    void* data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw runtime_error("SolutionLogReader: cannot map " + path);
+    }
+    mData = static_cast<uint8_t const*>(data);
+
+    try {
+        uint8_t const* end = mData + mSize;
+        if (memcmp(mData, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+            throw runtime_error("SolutionLogReader: " + path + " is not a solution log");
+        }
+        uint8_t const* cursor = mData + sizeof(FILE_MAGIC);
+        if (varint::readFixed<uint32_t>(cursor, end) != FILE_VERSION) {
+            throw runtime_error("SolutionLogReader: unsupported version in " + path);
+        }
+
+        cursor = end - TRAILER_SIZE;
+        uint64_t indexOffset = varint::readFixed<uint64_t>(cursor, end);
+        uint32_t blockCount = varint::readFixed<uint32_t>(cursor, end);
+        if (varint::readFixed<uint32_t>(cursor, end) != TRAILER_MAGIC) {
+            throw runtime_error("SolutionLogReader: " + path + " has no index, "
+                                "was it properly closed ?");
+        }
+        if (indexOffset + static_cast<uint64_t>(blockCount) * INDEX_ENTRY_SIZE
+                != mSize - TRAILER_SIZE) {
+            throw runtime_error("SolutionLogReader: invalid index in " + path);
+        }
+
+        cursor = mData + indexOffset;
+        mIndex.resize(blockCount);
+        for (auto& block : mIndex) {
+            block.offset = varint::readFixed<uint64_t>(cursor, end);
+            block.count = varint::readFixed<uint32_t>(cursor, end);
+            block.firstTime = base::Time::fromMicroseconds(
+                varint::readFixed<int64_t>(cursor, end));
+            block.lastTime = base::Time::fromMicroseconds(
+                varint::readFixed<int64_t>(cursor, end));
+            if (block.offset + BLOCK_HEADER_SIZE > indexOffset) {
+                throw runtime_error("SolutionLogReader: invalid index in " + path);
+            }
+        }
+    }
+    catch(...) {
+        munmap(const_cast<uint8_t*>(mData), mSize);
+        throw;
+    }
+}
+
+SolutionLogReader::~SolutionLogReader()
+{
+    munmap(const_cast<uint8_t*>(mData), mSize);
+}
+
+size_t SolutionLogReader::getSolutionCount() const
+{
+    size_t count = 0;
+    for (auto const& block : mIndex) {
+        count += block.count;
+    }
+    return count;
+}
+
+size_t SolutionLogReader::getBlockCount() const
+{
+    return mIndex.size();
+}
+
+SolutionLogBlockInfo const& SolutionLogReader::getBlockInfo(size_t block) const
+{
+    return mIndex.at(block);
+}
+
+size_t SolutionLogReader::findBlock(base::Time const& time) const
+{
+    auto it = lower_bound(mIndex.begin(), mIndex.end(), time,
+        [](SolutionLogBlockInfo const& block, base::Time const& time) {
+            return block.lastTime < time;
+        });
+    return it - mIndex.begin();
+}
+
+void SolutionLogReader::readBlock(size_t block, SolutionColumns& columns) const
+{
+    auto const& info = mIndex.at(block);
+    uint8_t const* cursor = mData + info.offset;
+    uint8_t const* end = mData + mSize;
+    if (varint::readFixed<uint32_t>(cursor, end) != BLOCK_MAGIC) {
+        throw runtime_error("SolutionLogReader: invalid block");
+    }
+    size_t count = varint::readFixed<uint32_t>(cursor, end);
+    size_t payloadSize = varint::readFixed<uint32_t>(cursor, end);
+    if (count != info.count || payloadSize > static_cast<size_t>(end - cursor)) {
+        throw runtime_error("SolutionLogReader: invalid block");
+    }
+    end = cursor + payloadSize;
+
+    columns.resize(count);
+    readDeltas(cursor, end, count, [&columns](size_t i, int64_t v) {
+        columns.time[i] = base::Time::fromMicroseconds(v);
+    });
+    readDeltas(cursor, end, count, [&columns](size_t i, int64_t v) {
+        columns.latitude[i] = fromScaled(v, ANGLE_SCALE);
+    });
+    readDeltas(cursor, end, count, [&columns](size_t i, int64_t v) {
+        columns.longitude[i] = fromScaled(v, ANGLE_SCALE);
+    });
+    readDeltas(cursor, end, count, [&columns](size_t i, int64_t v) {
+        columns.altitude[i] = fromScaled(v, ALTITUDE_SCALE);
+    });
+    if (static_cast<size_t>(end - cursor) < 2 * count) {
+        throw runtime_error("SolutionLogReader: invalid block");
+    }
+    copy(cursor, cursor + count, columns.positionType.begin());
+    cursor += count;
+    copy(cursor, cursor + count, columns.noOfSatellites.begin());
+    cursor += count;
+    readFloats(cursor, end, columns.geoidalSeparation);
+    readFloats(cursor, end, columns.ageOfDifferentialCorrections);
+    readFloats(cursor, end, columns.deviationLatitude);
+    readFloats(cursor, end, columns.deviationLongitude);
+    readFloats(cursor, end, columns.deviationAltitude);
+}
+
+void SolutionLogReader::readBlock(size_t block, vector<Solution>& solutions) const
+{
+    SolutionColumns columns;
+    readBlock(block, columns);
+    solutions.reserve(solutions.size() + columns.size());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        solutions.push_back(columns.get(i));
+    }
+}
+
+vector<Solution> SolutionLogReader::readAll() const
+{
+    vector<Solution> solutions;
+    solutions.reserve(getSolutionCount());
+    for (size_t i = 0; i < mIndex.size(); ++i) {
+        readBlock(i, solutions);
+    }
+    return solutions;
+}
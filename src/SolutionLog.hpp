@@ -0,0 +1,162 @@
+#ifndef GPS_BASE_SOLUTIONLOG_HPP
+#define GPS_BASE_SOLUTIONLOG_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <gps_base/BaseTypes.hpp>
+
+namespace gps_base
+{
+    /** A set of solutions stored as one array per field
+     *
+     * This is what SolutionLogReader decodes into. The latitude, longitude
+     * and altitude arrays can be given as-is to the batch conversion methods
+     * of UTMConverter.
+     */
+    struct SolutionColumns {
+        std::vector<base::Time> time;
+        std::vector<double> latitude;
+        std::vector<double> longitude;
+        std::vector<std::uint8_t> positionType;
+        /** Number of satellites, saturated to 254
+         *
+         * 255 is used for negative (unknown) values. get() converts it back
+         * to -1
+         */
+        std::vector<std::uint8_t> noOfSatellites;
+        std::vector<double> altitude;
+        std::vector<double> geoidalSeparation;
+        std::vector<double> ageOfDifferentialCorrections;
+        std::vector<double> deviationLatitude;
+        std::vector<double> deviationLongitude;
+        std::vector<double> deviationAltitude;
+
+        std::size_t size() const;
+        void resize(std::size_t size);
+        void clear();
+
+        /** Return the i-th solution */
+        Solution get(std::size_t i) const;
+
+        /** Set the i-th solution */
+        void set(std::size_t i, Solution const& solution);
+    };
+
+    /** Information about a block of a solution log */
+    struct SolutionLogBlockInfo {
+        /** Offset of the block in the file */
+        std::uint64_t offset;
+        /** Number of solutions in the block */
+        std::uint32_t count;
+        /** Time of the first solution in the block */
+        base::Time firstTime;
+        /** Time of the last solution in the block */
+        base::Time lastTime;
+    };
+
+    /** Writer for the columnar solution log format
+     *
+     * The file is a header, followed by blocks of up to a configurable
+     * number of solutions, followed by an index of the blocks. Within a
+     * block, each field is stored in its own column:
+     *
+     * - time as varint-encoded deltas in microseconds
+     * - latitude and longitude as varint-encoded deltas of 1e-9 degrees
+     * - altitude as varint-encoded deltas of 0.1 mm
+     * - position type and number of satellites as bytes
+     * - the geoidal separation, the age of corrections and the deviations
+     *   as 32-bit floats
+     *
+     * Latitude, longitude and altitude are therefore stored with a
+     * resolution of about 0.1mm. NaN values are preserved.
+     */
+    class SolutionLogWriter
+    {
+        std::ofstream mFile;
+        std::size_t mBlockSize;
+        std::uint64_t mOffset;
+        std::vector<Solution> mBlock;
+        std::vector<SolutionLogBlockInfo> mIndex;
+
+        void writeBlock();
+        void writeRaw(std::string const& data);
+
+    public:
+        static const std::size_t DEFAULT_BLOCK_SIZE = 4096;
+
+        /** Create a new log, overwriting @a path if it exists
+         *
+         * @param blockSize maximum number of solutions per block
+         * @throw std::runtime_error if the file cannot be opened
+         */
+        explicit SolutionLogWriter(std::string const& path,
+                                   std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+        SolutionLogWriter(SolutionLogWriter const&) = delete;
+        SolutionLogWriter& operator=(SolutionLogWriter const&) = delete;
+
+        /** Calls close() */
+        ~SolutionLogWriter();
+
+        /** Append a solution to the log
+         *
+         * Solutions are buffered until a full block is available
+         */
+        void write(Solution const& solution);
+
+        /** Write the solutions buffered so far as a (possibly partial) block */
+        void flush();
+
+        /** Flush the last block and write the index
+         *
+         * The log is not readable before close() is called. Further calls
+         * are ignored.
+         */
+        void close();
+    };
+
+    /** Reader for logs created by SolutionLogWriter
+     *
+     * The file is memory-mapped, and blocks are decoded on demand
+     */
+    class SolutionLogReader
+    {
+        std::uint8_t const* mData;
+        std::size_t mSize;
+        std::vector<SolutionLogBlockInfo> mIndex;
+
+    public:
+        /** Open and index a log
+         *
+         * @throw std::runtime_error if the file cannot be opened or is not a
+         *   valid (or closed) solution log
+         */
+        explicit SolutionLogReader(std::string const& path);
+        SolutionLogReader(SolutionLogReader const&) = delete;
+        SolutionLogReader& operator=(SolutionLogReader const&) = delete;
+        ~SolutionLogReader();
+
+        /** Total number of solutions in the log */
+        std::size_t getSolutionCount() const;
+        std::size_t getBlockCount() const;
+        SolutionLogBlockInfo const& getBlockInfo(std::size_t block) const;
+
+        /** Index of the first block that has solutions at or after @a time
+         *
+         * Returns getBlockCount() if there are none
+         */
+        std::size_t findBlock(base::Time const& time) const;
+
+        /** Decode a block, replacing the contents of @a columns */
+        void readBlock(std::size_t block, SolutionColumns& columns) const;
+
+        /** Decode a block, appending the solutions to @a solutions */
+        void readBlock(std::size_t block, std::vector<Solution>& solutions) const;
+
+        /** Decode the whole log */
+        std::vector<Solution> readAll() const;
+    };
+}
+
+#endif
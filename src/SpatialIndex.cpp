@@ -0,0 +1,391 @@
+#include <gps_base/SpatialIndex.hpp>
+
+#include <base/Float.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    /** Squared distance and insertion index of a candidate */
+    typedef pair<double, uint32_t> Candidate;
+
+    bool hasPosition(Solution const& solution) {
+        return solution.positionType != NO_SOLUTION &&
+               solution.positionType != INVALID;
+    }
+
+    template<typename Point>
+    double squaredDistance(Point const& a, Point const& b) {
+        double dx = a.x - b.x;
+        double dy = a.y - b.y;
+        return dx * dx + dy * dy;
+    }
+
+    template<typename Point>
+    double axisCoordinate(Point const& p, bool yAxis) {
+        return yAxis ? p.y : p.x;
+    }
+
+    template<typename Entry>
+    void buildNode(Entry* begin, Entry* end, bool yAxis) {
+        if (static_cast<size_t>(end - begin) <= SpatialIndex::LEAF_SIZE) {
+            return;
+        }
+
+        Entry* mid = begin + (end - begin) / 2;
+        nth_element(begin, mid, end, [yAxis](Entry const& a, Entry const& b) {
+            return axisCoordinate(a.point, yAxis) < axisCoordinate(b.point, yAxis);
+        });
+        buildNode(begin, mid, !yAxis);
+        buildNode(mid + 1, end, !yAxis);
+    }
+
+    template<typename Point, typename Visitor>
+    void searchNode(Point const* points, uint32_t const* indices,
+                    size_t begin, size_t end, bool yAxis,
+                    Point const& query, Visitor& visitor) {
+        if (end - begin <= SpatialIndex::LEAF_SIZE) {
+            for (size_t i = begin; i < end; ++i) {
+                visitor.visit(squaredDistance(points[i], query), indices[i]);
+            }
+            return;
+        }
+
+        size_t mid = begin + (end - begin) / 2;
+        visitor.visit(squaredDistance(points[mid], query), indices[mid]);
+
+        double diff = axisCoordinate(query, yAxis) - axisCoordinate(points[mid], yAxis);
+        if (diff < 0) {
+            searchNode(points, indices, begin, mid, !yAxis, query, visitor);
+            if (diff * diff <= visitor.bound()) {
+                searchNode(points, indices, mid + 1, end, !yAxis, query, visitor);
+            }
+        }
+        else {
+            searchNode(points, indices, mid + 1, end, !yAxis, query, visitor);
+            if (diff * diff <= visitor.bound()) {
+                searchNode(points, indices, begin, mid, !yAxis, query, visitor);
+            }
+        }
+    }
+
+    /** Keeps the k nearest candidates in a max-heap */
+    struct NearestVisitor {
+        size_t k;
+        vector<Candidate> heap;
+
+        explicit NearestVisitor(size_t k)
+            : k(k) {
+            heap.reserve(k);
+        }
+
+        double bound() const {
+            if (heap.size() < k) {
+                return numeric_limits<double>::infinity();
+            }
+            return heap.front().first;
+        }
+
+        void visit(double distance2, uint32_t index) {
+            if (heap.size() < k) {
+                heap.emplace_back(distance2, index);
+                push_heap(heap.begin(), heap.end());
+            }
+            else if (distance2 < heap.front().first) {
+                pop_heap(heap.begin(), heap.end());
+                heap.back() = Candidate(distance2, index);
+                push_heap(heap.begin(), heap.end());
+            }
+        }
+    };
+
+    struct RadiusVisitor {
+        double radius2;
+        vector<Candidate> result;
+
+        explicit RadiusVisitor(double radius)
+            : radius2(radius * radius) {}
+
+        double bound() const {
+            return radius2;
+        }
+
+        void visit(double distance2, uint32_t index) {
+            if (distance2 <= radius2) {
+                result.emplace_back(distance2, index);
+            }
+        }
+    };
+
+    vector<SpatialIndex::Match> toMatches(vector<Candidate> const& candidates) {
+        vector<SpatialIndex::Match> result;
+        result.reserve(candidates.size());
+        for (auto const& c : candidates) {
+            result.push_back(SpatialIndex::Match { c.second, sqrt(c.first) });
+        }
+        return result;
+    }
+}
+
+SpatialIndex::SpatialIndex(UTMConverter const& converter)
+    : mConverter(converter)
+    , mSize(0)
+{
+}
+
+void SpatialIndex::convert(size_t count,
+                           double const* latitudes, double const* longitudes,
+                           double* x, double* y) const
+{
+    vector<size_t> valid;
+    vector<double> validLatitudes, validLongitudes;
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = y[i] = base::unknown<double>();
+        if (isfinite(latitudes[i]) && isfinite(longitudes[i])) {
+            valid.push_back(i);
+            validLatitudes.push_back(latitudes[i]);
+            validLongitudes.push_back(longitudes[i]);
+        }
+    }
+
+    vector<double> altitudes(valid.size(), 0);
+    vector<double> validX(valid.size());
+    vector<double> validY(valid.size());
+    vector<double> validZ(valid.size());
+    mConverter.convertToNWU(valid.size(),
+                            validLatitudes.data(), validLongitudes.data(),
+                            altitudes.data(),
+                            validX.data(), validY.data(), validZ.data());
+    for (size_t i = 0; i < valid.size(); ++i) {
+        x[valid[i]] = validX[i];
+        y[valid[i]] = validY[i];
+    }
+}
+
+uint32_t SpatialIndex::nextIndex()
+{
+    if (mSize > numeric_limits<uint32_t>::max()) {
+        throw length_error("SpatialIndex: too many positions");
+    }
+    return mSize++;
+}
+
+void SpatialIndex::build(vector<Solution> const& solutions)
+{
+    vector<double> latitudes(solutions.size());
+    vector<double> longitudes(solutions.size());
+    for (size_t i = 0; i < solutions.size(); ++i) {
+        if (hasPosition(solutions[i])) {
+            latitudes[i] = solutions[i].latitude;
+            longitudes[i] = solutions[i].longitude;
+        }
+        else {
+            latitudes[i] = longitudes[i] = base::unknown<double>();
+        }
+    }
+    build(solutions.size(), latitudes.data(), longitudes.data());
+}
+
+void SpatialIndex::build(size_t count,
+                         double const* latitudes, double const* longitudes)
+{
+    if (count > static_cast<size_t>(numeric_limits<uint32_t>::max()) + 1) {
+        throw length_error("SpatialIndex: too many positions");
+    }
+
+    clear();
+    vector<double> x(count);
+    vector<double> y(count);
+    convert(count, latitudes, longitudes, x.data(), y.data());
+
+    Tree tree;
+    tree.points.reserve(count);
+    tree.indices.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (isfinite(x[i]) && isfinite(y[i])) {
+            tree.points.push_back(Point { x[i], y[i] });
+            tree.indices.push_back(i);
+        }
+    }
+    mSize = count;
+
+    if (!tree.points.empty()) {
+        buildTree(tree);
+        mTrees.push_back(move(tree));
+    }
+}
+
+size_t SpatialIndex::insert(Solution const& solution)
+{
+    if (!hasPosition(solution)) {
+        return nextIndex();
+    }
+
+    Point point;
+    convert(1, &solution.latitude, &solution.longitude, &point.x, &point.y);
+    uint32_t index = nextIndex();
+    if (isfinite(point.x) && isfinite(point.y)) {
+        add(point, index);
+    }
+    return index;
+}
+
+size_t SpatialIndex::insert(base::Position const& nwu)
+{
+    uint32_t index = nextIndex();
+    if (isfinite(nwu.x()) && isfinite(nwu.y())) {
+        add(Point { nwu.x(), nwu.y() }, index);
+    }
+    return index;
+}
+
+void SpatialIndex::add(Point const& point, uint32_t index)
+{
+    mBuffer.points.push_back(point);
+    mBuffer.indices.push_back(index);
+    if (mBuffer.points.size() >= INSERT_BUFFER_SIZE) {
+        flushBuffer();
+    }
+}
+
+void SpatialIndex::flushBuffer()
+{
+    Tree carry = move(mBuffer);
+    mBuffer = Tree();
+
+    // Keep the trees' sizes more than doubling from the back of mTrees to
+    // its front, which bounds the tree count to O(log n)
+    while (!mTrees.empty() &&
+           mTrees.back().points.size() <= 2 * carry.points.size()) {
+        mergeInto(carry, mTrees.back());
+        mTrees.pop_back();
+    }
+    buildTree(carry);
+    mTrees.push_back(move(carry));
+}
+
+void SpatialIndex::optimize()
+{
+    if (mTrees.size() <= 1 && mBuffer.points.empty()) {
+        return;
+    }
+
+    Tree merged = move(mBuffer);
+    mBuffer = Tree();
+    for (auto const& tree : mTrees) {
+        mergeInto(merged, tree);
+    }
+    mTrees.clear();
+    buildTree(merged);
+    mTrees.push_back(move(merged));
+}
+
+void SpatialIndex::clear()
+{
+    mTrees.clear();
+    mBuffer = Tree();
+    mSize = 0;
+}
+
+size_t SpatialIndex::size() const
+{
+    return mSize;
+}
+
+size_t SpatialIndex::getTreeCount() const
+{
+    return mTrees.size();
+}
+
+void SpatialIndex::mergeInto(Tree& target, Tree const& source)
+{
+    target.points.insert(target.points.end(),
+                         source.points.begin(), source.points.end());
+    target.indices.insert(target.indices.end(),
+                          source.indices.begin(), source.indices.end());
+}
+
+void SpatialIndex::buildTree(Tree& tree)
+{
+    struct Entry {
+        Point point;
+        uint32_t index;
+    };
+
+    size_t count = tree.points.size();
+    vector<Entry> entries(count);
+    for (size_t i = 0; i < count; ++i) {
+        entries[i] = Entry { tree.points[i], tree.indices[i] };
+    }
+    buildNode(entries.data(), entries.data() + count, false);
+    for (size_t i = 0; i < count; ++i) {
+        tree.points[i] = entries[i].point;
+        tree.indices[i] = entries[i].index;
+    }
+}
+
+vector<SpatialIndex::Match> SpatialIndex::nearest(Solution const& query, size_t k) const
+{
+    if (!hasPosition(query)) {
+        return vector<Match>();
+    }
+
+    Point point;
+    convert(1, &query.latitude, &query.longitude, &point.x, &point.y);
+    return nearest(base::Position(point.x, point.y, 0), k);
+}
+
+vector<SpatialIndex::Match> SpatialIndex::nearest(base::Position const& nwu, size_t k) const
+{
+    Point query { nwu.x(), nwu.y() };
+    if (k == 0 || !isfinite(query.x) || !isfinite(query.y)) {
+        return vector<Match>();
+    }
+
+    NearestVisitor visitor(k);
+    for (auto const& tree : mTrees) {
+        searchNode(tree.points.data(), tree.indices.data(),
+                   0, tree.points.size(), false, query, visitor);
+    }
+    for (size_t i = 0; i < mBuffer.points.size(); ++i) {
+        visitor.visit(squaredDistance(mBuffer.points[i], query), mBuffer.indices[i]);
+    }
+
+    sort_heap(visitor.heap.begin(), visitor.heap.end());
+    return toMatches(visitor.heap);
+}
+
+vector<SpatialIndex::Match> SpatialIndex::radius(Solution const& query, double radius) const
+{
+    if (!hasPosition(query)) {
+        return vector<Match>();
+    }
+
+    Point point;
+    convert(1, &query.latitude, &query.longitude, &point.x, &point.y);
+    return this->radius(base::Position(point.x, point.y, 0), radius);
+}
+
+vector<SpatialIndex::Match> SpatialIndex::radius(base::Position const& nwu, double radius) const
+{
+    Point query { nwu.x(), nwu.y() };
+    if (!(radius >= 0) || !isfinite(query.x) || !isfinite(query.y)) {
+        return vector<Match>();
+    }
+
+    RadiusVisitor visitor(radius);
+    for (auto const& tree : mTrees) {
+        searchNode(tree.points.data(), tree.indices.data(),
+                   0, tree.points.size(), false, query, visitor);
+    }
+    for (size_t i = 0; i < mBuffer.points.size(); ++i) {
+        visitor.visit(squaredDistance(mBuffer.points[i], query), mBuffer.indices[i]);
+    }
+
+    sort(visitor.result.begin(), visitor.result.end());
+    return toMatches(visitor.result);
+}
@@ -0,0 +1,147 @@
+#ifndef GPS_BASE_SPATIALINDEX_HPP
+#define GPS_BASE_SPATIALINDEX_HPP
+
+#include <cstdint>
+#include <vector>
+#include <gps_base/BaseTypes.hpp>
+#include <gps_base/UTMConverter.hpp>
+
+namespace gps_base
+{
+    /** Index of horizontal positions for nearest-neighbour and radius
+     * queries
+     *
+     * Positions are converted in the local NWU frame of the converter given
+     * at construction, and stored in implicit k-d trees. The index is 2D:
+     * altitudes are ignored, and distances are euclidean distances in the
+     * NWU frame, i.e. carry the UTM scale error of the converter's zone.
+     *
+     * Each position is identified by its insertion index, i.e. its index in
+     * the vector given to build(), then incremented by insert(). Solutions
+     * that have no valid position (NO_SOLUTION, INVALID, or NaN coordinates)
+     * get an index but are never returned by queries.
+     *
+     * Bulk-loaded positions end up in a single tree. Incremental insertions
+     * are buffered, then merged into a set of trees of geometrically
+     * increasing sizes so that the cost of an insertion is amortized
+     * O(log^2 n) and queries visit O(log n) trees.
+     */
+    class SpatialIndex
+    {
+    public:
+        /** A query result */
+        struct Match {
+            /** Insertion index of the position */
+            std::size_t index;
+            /** Horizontal distance to the query point, in meters */
+            double distance;
+        };
+
+        /** Number of points in a k-d tree leaf */
+        static const std::size_t LEAF_SIZE = 8;
+        /** Number of inserted points that are kept in a linearly-scanned
+         * buffer before being merged into the trees
+         */
+        static const std::size_t INSERT_BUFFER_SIZE = 256;
+
+        explicit SpatialIndex(UTMConverter const& converter);
+
+        /** Remove all positions and load the given solutions
+         *
+         * The conversions go through the batch UTMConverter path
+         */
+        void build(std::vector<Solution> const& solutions);
+
+        /** Remove all positions and load the given coordinates
+         *
+         * NaN coordinates are accepted, and count as invalid positions
+         */
+        void build(std::size_t count,
+                   double const* latitudes, double const* longitudes);
+
+        /** Add a single solution to the index
+         *
+         * @return the solution's insertion index
+         */
+        std::size_t insert(Solution const& solution);
+
+        /** Add a position, already expressed in the NWU frame, to the index
+         *
+         * @return the position's insertion index
+         */
+        std::size_t insert(base::Position const& nwu);
+
+        /** Merge all trees and the insertion buffer into a single tree
+         *
+         * This optimizes queries after a long sequence of insertions
+         */
+        void optimize();
+
+        /** Remove all positions */
+        void clear();
+
+        /** Number of positions added to the index, including invalid ones */
+        std::size_t size() const;
+
+        /** Number of k-d trees the positions are currently stored into */
+        std::size_t getTreeCount() const;
+
+        /** The @a k positions nearest to the given solution, sorted by
+         * increasing distance
+         */
+        std::vector<Match> nearest(Solution const& query, std::size_t k) const;
+
+        /** The @a k positions nearest to the given NWU position, sorted by
+         * increasing distance
+         */
+        std::vector<Match> nearest(base::Position const& nwu, std::size_t k) const;
+
+        /** All positions within @a radius meters of the given solution,
+         * sorted by increasing distance
+         */
+        std::vector<Match> radius(Solution const& query, double radius) const;
+
+        /** All positions within @a radius meters of the given NWU position,
+         * sorted by increasing distance
+         */
+        std::vector<Match> radius(base::Position const& nwu, double radius) const;
+
+    private:
+        struct Point {
+            double x;
+            double y;
+        };
+
+        /** An implicit k-d tree
+         *
+         * The node covering [begin, end) splits at its median element
+         * mid = (begin + end) / 2, on x at even depths and y at odd depths.
+         * Ranges of at most LEAF_SIZE points are leaves. Coordinates and
+         * indices are stored separately so that the traversal only touches
+         * the coordinates.
+         */
+        struct Tree {
+            std::vector<Point> points;
+            std::vector<std::uint32_t> indices;
+        };
+
+        UTMConverter mConverter;
+        std::vector<Tree> mTrees;
+        Tree mBuffer;
+        std::size_t mSize;
+
+        /** Convert valid geodetic coordinates in the NWU frame */
+        void convert(std::size_t count,
+                     double const* latitudes, double const* longitudes,
+                     double* x, double* y) const;
+
+        std::uint32_t nextIndex();
+        void add(Point const& point, std::uint32_t index);
+        void flushBuffer();
+
+        static void buildTree(Tree& tree);
+        static void mergeInto(Tree& target, Tree const& source);
+    };
+}
+
+#endif
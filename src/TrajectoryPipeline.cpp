@@ -0,0 +1,361 @@
+#include <gps_base/TrajectoryPipeline.hpp>
+
+#include "Parallel.hpp"
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    typedef chrono::steady_clock Clock;
+
+    base::Time elapsedSince(Clock::time_point start) {
+        return base::Time::fromMicroseconds(
+            chrono::duration_cast<chrono::microseconds>(Clock::now() - start).count());
+    }
+
+    void accumulate(TrajectoryStageStatistics& total,
+                    TrajectoryStageStatistics const& stage) {
+        total.input += stage.input;
+        total.output += stage.output;
+        total.time += stage.time;
+    }
+
+    /** Statistics of the stages that run in the workers */
+    struct WorkerStatistics {
+        TrajectoryStageStatistics decode;
+        TrajectoryStageStatistics filter;
+        TrajectoryStageStatistics convert;
+    };
+
+    void moveElement(TrajectoryColumns& columns, size_t from, size_t to) {
+        columns.time[to] = columns.time[from];
+        columns.x[to] = columns.x[from];
+        columns.y[to] = columns.y[from];
+        columns.z[to] = columns.z[from];
+        columns.deviationX[to] = columns.deviationX[from];
+        columns.deviationY[to] = columns.deviationY[from];
+        columns.deviationZ[to] = columns.deviationZ[from];
+        columns.positionType[to] = columns.positionType[from];
+    }
+
+    /** State of the sequential decimation stage, carried across chunks */
+    class Decimator {
+        TrajectoryDecimation mDecimation;
+        bool mHasLast = false;
+        base::Time mLastTime;
+        double mLastX = 0;
+        double mLastY = 0;
+
+    public:
+        explicit Decimator(TrajectoryDecimation const& decimation)
+            : mDecimation(decimation) {}
+
+        void apply(TrajectoryColumns& columns) {
+            double minDistance2 = mDecimation.minDistance * mDecimation.minDistance;
+            size_t kept = 0;
+            for (size_t i = 0; i < columns.size(); ++i) {
+                if (mHasLast) {
+                    double dx = columns.x[i] - mLastX;
+                    double dy = columns.y[i] - mLastY;
+                    if (columns.time[i] - mLastTime < mDecimation.minPeriod ||
+                        dx * dx + dy * dy < minDistance2) {
+                        continue;
+                    }
+                }
+
+                mHasLast = true;
+                mLastTime = columns.time[i];
+                mLastX = columns.x[i];
+                mLastY = columns.y[i];
+                moveElement(columns, i, kept++);
+            }
+            columns.resize(kept);
+        }
+    };
+}
+
+bool TrajectoryFilter::accepts(SolutionColumns const& columns, size_t i) const
+{
+    unsigned int type = columns.positionType[i];
+    if (type >= 32 || !(positionTypes & VALID_POSITION_TYPES & (1u << type))) {
+        return false;
+    }
+
+    // The comparisons are written so that NaN values are rejected when a
+    // limit is set
+    if (!std::isinf(maxCorrectionAge) &&
+        !(columns.ageOfDifferentialCorrections[i] <= maxCorrectionAge)) {
+        return false;
+    }
+    if (!std::isinf(maxHorizontalDeviation)) {
+        double horizontal = hypot(columns.deviationLatitude[i],
+                                  columns.deviationLongitude[i]);
+        if (!(horizontal <= maxHorizontalDeviation)) {
+            return false;
+        }
+    }
+    if (!std::isinf(maxVerticalDeviation) &&
+        !(columns.deviationAltitude[i] <= maxVerticalDeviation)) {
+        return false;
+    }
+    return true;
+}
+
+size_t TrajectoryColumns::size() const
+{
+    return time.size();
+}
+
+void TrajectoryColumns::resize(size_t size)
+{
+    time.resize(size);
+    x.resize(size);
+    y.resize(size);
+    z.resize(size);
+    deviationX.resize(size);
+    deviationY.resize(size);
+    deviationZ.resize(size);
+    positionType.resize(size);
+}
+
+void TrajectoryColumns::clear()
+{
+    resize(0);
+}
+
+double TrajectoryStageStatistics::getThroughput() const
+{
+    return input / time.toSeconds();
+}
+
+TrajectoryPipeline::TrajectoryPipeline(
+    UTMConverter const& converter,
+    TrajectoryPipelineConfiguration const& configuration)
+    : mConverter(converter)
+    , mConfiguration(configuration)
+{
+}
+
+TrajectoryPipelineStatistics TrajectoryPipeline::run(
+    SolutionLogReader const& log, Sink const& sink) const
+{
+    return run(log.getBlockCount(), [&log](size_t chunk, SolutionColumns& columns) {
+        log.readBlock(chunk, columns);
+    }, sink);
+}
+
+TrajectoryPipelineStatistics TrajectoryPipeline::run(
+    vector<Solution> const& solutions, Sink const& sink) const
+{
+    size_t chunkSize = max<size_t>(1, mConfiguration.chunkSize);
+    size_t chunkCount = (solutions.size() + chunkSize - 1) / chunkSize;
+    return run(chunkCount, [&solutions, chunkSize](size_t chunk, SolutionColumns& columns) {
+        size_t begin = chunk * chunkSize;
+        size_t end = min(solutions.size(), begin + chunkSize);
+        columns.resize(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            columns.set(i - begin, solutions[i]);
+        }
+    }, sink);
+}
+
+TrajectoryPipelineStatistics TrajectoryPipeline::run(
+    size_t chunkCount, Source const& source, Sink const& sink) const
+{
+    auto start = Clock::now();
+    TrajectoryPipelineStatistics statistics;
+    statistics.chunks = chunkCount;
+
+    unsigned int threadCount = min<size_t>(
+        details::getThreadCount(mConfiguration.threads), max<size_t>(chunkCount, 1));
+    size_t maxInFlight = mConfiguration.maxChunksInFlight;
+    if (maxInFlight == 0) {
+        maxInFlight = 2 * threadCount;
+    }
+
+    // State shared between the workers and the output stage, protected by
+    // the mutex
+    mutex lock;
+    condition_variable windowAdvanced;
+    condition_variable chunkDone;
+    size_t nextChunk = 0;
+    size_t outputChunks = 0;
+    bool aborted = false;
+    exception_ptr error;
+    map<size_t, TrajectoryColumns> done;
+    WorkerStatistics workerStatistics;
+
+    auto fail = [&](exception_ptr e) {
+        unique_lock<mutex> guard(lock);
+        if (!error) {
+            error = e;
+        }
+        aborted = true;
+        windowAdvanced.notify_all();
+        chunkDone.notify_all();
+    };
+
+    auto worker = [&]() {
+        try {
+            // The coordinate transformations are not thread-safe
+            UTMConverter converter(mConverter);
+            SolutionColumns columns;
+            vector<size_t> selected;
+            vector<double> latitudes, longitudes, altitudes, separations, heights;
+            vector<double> x, y, z;
+            WorkerStatistics local;
+
+            while (true) {
+                size_t chunk;
+                {
+                    unique_lock<mutex> guard(lock);
+                    windowAdvanced.wait(guard, [&] {
+                        return aborted || nextChunk >= chunkCount ||
+                               nextChunk < outputChunks + maxInFlight;
+                    });
+                    if (aborted || nextChunk >= chunkCount) {
+                        break;
+                    }
+                    chunk = nextChunk++;
+                }
+
+                auto stageStart = Clock::now();
+                source(chunk, columns);
+                local.decode.input += columns.size();
+                local.decode.output += columns.size();
+                local.decode.time += elapsedSince(stageStart);
+
+                stageStart = Clock::now();
+                selected.clear();
+                for (size_t i = 0; i < columns.size(); ++i) {
+                    if (mConfiguration.filter.accepts(columns, i)) {
+                        selected.push_back(i);
+                    }
+                }
+                local.filter.input += columns.size();
+                local.filter.output += selected.size();
+                local.filter.time += elapsedSince(stageStart);
+
+                stageStart = Clock::now();
+                size_t count = selected.size();
+                latitudes.resize(count);
+                longitudes.resize(count);
+                altitudes.resize(count);
+                separations.resize(count);
+                heights.resize(count);
+                x.resize(count);
+                y.resize(count);
+                z.resize(count);
+                for (size_t i = 0; i < count; ++i) {
+                    latitudes[i] = columns.latitude[selected[i]];
+                    longitudes[i] = columns.longitude[selected[i]];
+                    altitudes[i] = columns.altitude[selected[i]];
+                    separations[i] = columns.geoidalSeparation[selected[i]];
+                }
+                converter.convertHeights(count, latitudes.data(), longitudes.data(),
+                                         altitudes.data(), separations.data(),
+                                         heights.data());
+                converter.convertToNWU(count, latitudes.data(), longitudes.data(),
+                                       heights.data(), x.data(), y.data(), z.data());
+
+                TrajectoryColumns result;
+                result.resize(count);
+                size_t converted = 0;
+                for (size_t i = 0; i < count; ++i) {
+                    if (!std::isfinite(x[i]) || !std::isfinite(y[i])) {
+                        continue;
+                    }
+                    size_t in = selected[i];
+                    result.time[converted] = columns.time[in];
+                    result.x[converted] = x[i];
+                    result.y[converted] = y[i];
+                    result.z[converted] = z[i];
+                    result.deviationX[converted] = columns.deviationLatitude[in];
+                    result.deviationY[converted] = columns.deviationLongitude[in];
+                    result.deviationZ[converted] = columns.deviationAltitude[in];
+                    result.positionType[converted] = columns.positionType[in];
+                    ++converted;
+                }
+                result.resize(converted);
+                local.convert.input += count;
+                local.convert.output += converted;
+                local.convert.time += elapsedSince(stageStart);
+
+                unique_lock<mutex> guard(lock);
+                done[chunk] = move(result);
+                chunkDone.notify_all();
+            }
+
+            unique_lock<mutex> guard(lock);
+            accumulate(workerStatistics.decode, local.decode);
+            accumulate(workerStatistics.filter, local.filter);
+            accumulate(workerStatistics.convert, local.convert);
+        }
+        catch(...) {
+            fail(current_exception());
+        }
+    };
+
+    vector<thread> workers;
+    for (unsigned int i = 0; i < threadCount && chunkCount > 0; ++i) {
+        workers.emplace_back(worker);
+    }
+
+    Decimator decimator(mConfiguration.decimation);
+    try {
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            TrajectoryColumns columns;
+            {
+                unique_lock<mutex> guard(lock);
+                chunkDone.wait(guard, [&] {
+                    return aborted || done.count(chunk);
+                });
+                if (aborted) {
+                    break;
+                }
+                auto it = done.find(chunk);
+                columns = move(it->second);
+                done.erase(it);
+            }
+
+            auto stageStart = Clock::now();
+            statistics.decimate.input += columns.size();
+            decimator.apply(columns);
+            statistics.decimate.output += columns.size();
+            statistics.decimate.time += elapsedSince(stageStart);
+
+            stageStart = Clock::now();
+            sink(columns);
+            statistics.output.input += columns.size();
+            statistics.output.output += columns.size();
+            statistics.output.time += elapsedSince(stageStart);
+
+            unique_lock<mutex> guard(lock);
+            outputChunks = chunk + 1;
+            windowAdvanced.notify_all();
+        }
+    }
+    catch(...) {
+        fail(current_exception());
+    }
+
+    for (auto& w : workers) {
+        w.join();
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+
+    statistics.decode = workerStatistics.decode;
+    statistics.filter = workerStatistics.filter;
+    statistics.convert = workerStatistics.convert;
+    statistics.time = elapsedSince(start);
+    return statistics;
+}
@@ -0,0 +1,162 @@
+#ifndef GPS_BASE_TRAJECTORYPIPELINE_HPP
+#define GPS_BASE_TRAJECTORYPIPELINE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <base/Float.hpp>
+#include <gps_base/BaseTypes.hpp>
+#include <gps_base/SolutionLog.hpp>
+#include <gps_base/UTMConverter.hpp>
+
+namespace gps_base
+{
+    /** Selection of the solutions that are kept by TrajectoryPipeline */
+    struct TrajectoryFilter {
+        /** Bitmask of all position types that have a position */
+        static const unsigned int VALID_POSITION_TYPES =
+            ~((1u << NO_SOLUTION) | (1u << INVALID));
+
+        /** Accepted position types
+         *
+         * Bit N is set if the position type whose GPS_SOLUTION_TYPES value
+         * is N is accepted. Use positionTypeBit() to build it. NO_SOLUTION
+         * and INVALID are always rejected.
+         */
+        unsigned int positionTypes = VALID_POSITION_TYPES;
+        /** Maximum age of the differential corrections, in seconds
+         *
+         * If finite, solutions with an unknown age are rejected
+         */
+        double maxCorrectionAge = base::infinity<double>();
+        /** Maximum horizontal deviation, i.e. the norm of the latitude and
+         * longitude deviations, in meters
+         */
+        double maxHorizontalDeviation = base::infinity<double>();
+        /** Maximum altitude deviation, in meters */
+        double maxVerticalDeviation = base::infinity<double>();
+
+        static unsigned int positionTypeBit(GPS_SOLUTION_TYPES type)
+        {
+            return 1u << type;
+        }
+
+        /** Whether the i-th solution of @a columns passes the filter */
+        bool accepts(SolutionColumns const& columns, std::size_t i) const;
+    };
+
+    /** Downsampling of the filtered trajectory
+     *
+     * A solution is kept if it is at least minPeriod after and minDistance
+     * away from the last kept solution. The default keeps everything.
+     */
+    struct TrajectoryDecimation {
+        base::Time minPeriod;
+        /** Minimum distance, in meters, in the NWU frame */
+        double minDistance = 0;
+    };
+
+    struct TrajectoryPipelineConfiguration {
+        TrajectoryFilter filter;
+        TrajectoryDecimation decimation;
+        /** Number of worker threads, zero meaning one per hardware thread */
+        unsigned int threads = 0;
+        /** Maximum number of chunks being processed or waiting to be output
+         *
+         * This bounds the memory used by the pipeline. Zero means twice the
+         * number of threads
+         */
+        std::size_t maxChunksInFlight = 0;
+        /** Number of solutions per chunk when the input is not a log
+         *
+         * Logs are split along their blocks
+         */
+        std::size_t chunkSize = SolutionLogWriter::DEFAULT_BLOCK_SIZE;
+    };
+
+    /** A part of the pipeline's output, in the NWU frame
+     *
+     * The deviations are converted into the NWU axes
+     */
+    struct TrajectoryColumns {
+        std::vector<base::Time> time;
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+        std::vector<double> deviationX;
+        std::vector<double> deviationY;
+        std::vector<double> deviationZ;
+        std::vector<std::uint8_t> positionType;
+
+        std::size_t size() const;
+        void resize(std::size_t size);
+        void clear();
+    };
+
+    struct TrajectoryStageStatistics {
+        /** Number of solutions this stage received */
+        std::size_t input = 0;
+        /** Number of solutions this stage produced */
+        std::size_t output = 0;
+        /** Time spent in this stage, summed over all threads */
+        base::Time time;
+
+        /** Input solutions per second of time spent in the stage */
+        double getThroughput() const;
+    };
+
+    struct TrajectoryPipelineStatistics {
+        std::size_t chunks = 0;
+        /** Wall-clock time of the whole run */
+        base::Time time;
+
+        TrajectoryStageStatistics decode;
+        TrajectoryStageStatistics filter;
+        TrajectoryStageStatistics convert;
+        TrajectoryStageStatistics decimate;
+        TrajectoryStageStatistics output;
+    };
+
+    /** Filter, convert and downsample solutions in parallel
+     *
+     * The input is split in chunks. The decode, filter and convert stages
+     * run chunk by chunk on a pool of worker threads. Their results go
+     * through a reorder buffer, and the decimation and output stages then
+     * run sequentially in the calling thread, in the input order.
+     *
+     * The number of chunks in flight is bounded, i.e. the workers wait for
+     * the output stage if it is lagging behind.
+     */
+    class TrajectoryPipeline
+    {
+    public:
+        /** Called with the pipeline output, chunk by chunk, in order
+         *
+         * Exceptions thrown by the sink stop the pipeline and are
+         * propagated by run()
+         */
+        typedef std::function<void (TrajectoryColumns const&)> Sink;
+
+        TrajectoryPipeline(UTMConverter const& converter,
+                           TrajectoryPipelineConfiguration const& configuration);
+
+        TrajectoryPipelineStatistics run(SolutionLogReader const& log,
+                                         Sink const& sink) const;
+
+        TrajectoryPipelineStatistics run(std::vector<Solution> const& solutions,
+                                         Sink const& sink) const;
+
+    private:
+        /** Fill the columns with the given chunk of the input */
+        typedef std::function<void (std::size_t, SolutionColumns&)> Source;
+
+        UTMConverter mConverter;
+        TrajectoryPipelineConfiguration mConfiguration;
+
+        TrajectoryPipelineStatistics run(std::size_t chunkCount,
+                                         Source const& source,
+                                         Sink const& sink) const;
+    };
+}
+
+#endif
@@ -0,0 +1,205 @@
+#ifndef GPS_BASE_TRANSVERSEMERCATOR_HPP
+#define GPS_BASE_TRANSVERSEMERCATOR_HPP
+
+#include <cmath>
+#include <gps_base/Geodesic.hpp>
+
+namespace gps_base {
+    /** Transverse Mercator projection on the WGS84 ellipsoid
+     *
+     * This implements the Krüger series to sixth order in the third
+     * flattening n, following Karney, "Transverse Mercator with an accuracy
+     * of a few nanometers", J. Geodesy 85(8), 2011. Within the UTM zones,
+     * it agrees with PROJ to the nanometer.
+     *
+     * Unlike a generic coordinate transformation, the forward projection
+     * also returns the meridian convergence and the point scale factor. A
+     * small displacement (e, n) in the local east-north frame maps to the
+     * grid displacement k R(γ) (e, n), R(γ) being the counter-clockwise
+     * rotation by the convergence γ.
+     *
+     * Latitudes and longitudes are in degrees, the convergence in radians.
+     */
+    namespace tmerc {
+        /** Third flattening of WGS84 */
+        constexpr double N = geodesic::WGS84_F / (2 - geodesic::WGS84_F);
+        /** Squared eccentricity of WGS84 */
+        constexpr double E2 = geodesic::WGS84_F * (2 - geodesic::WGS84_F);
+        /** Rectifying radius, i.e. the radius of the sphere with the same
+         * meridian length as the ellipsoid
+         */
+        constexpr double RECTIFYING_RADIUS =
+            geodesic::WGS84_A / (1 + N) *
+            (1 + N * N / 4 + N * N * N * N / 64 + N * N * N * N * N * N / 256);
+
+        /** Order of the series */
+        constexpr int ORDER = 6;
+
+        /** Evaluates c[0] n + c[1] n^2 + ... + c[5] n^6 */
+        constexpr double series(double c1, double c2, double c3,
+                                double c4, double c5, double c6)
+        {
+            return N * (c1 + N * (c2 + N * (c3 + N * (c4 + N * (c5 + N * c6)))));
+        }
+
+        /** Coefficients of the forward series (Karney 2011, eq. 35) */
+        constexpr double ALPHA[ORDER] = {
+            series(1.0 / 2, -2.0 / 3, 5.0 / 16, 41.0 / 180, -127.0 / 288, 7891.0 / 37800),
+            series(0, 13.0 / 48, -3.0 / 5, 557.0 / 1440, 281.0 / 630, -1983433.0 / 1935360),
+            series(0, 0, 61.0 / 240, -103.0 / 140, 15061.0 / 26880, 167603.0 / 181440),
+            series(0, 0, 0, 49561.0 / 161280, -179.0 / 168, 6601661.0 / 7257600),
+            series(0, 0, 0, 0, 34729.0 / 80640, -3418889.0 / 1995840),
+            series(0, 0, 0, 0, 0, 212378941.0 / 319334400)
+        };
+
+        /** Coefficients of the inverse series (Karney 2011, eq. 36) */
+        constexpr double BETA[ORDER] = {
+            series(1.0 / 2, -2.0 / 3, 37.0 / 96, -1.0 / 360, -81.0 / 512, 96199.0 / 604800),
+            series(0, 1.0 / 48, 1.0 / 15, -437.0 / 1440, 46.0 / 105, -1118711.0 / 3870720),
+            series(0, 0, 17.0 / 480, -37.0 / 840, -209.0 / 4480, 5569.0 / 90720),
+            series(0, 0, 0, 4397.0 / 161280, -11.0 / 504, -830251.0 / 7257600),
+            series(0, 0, 0, 0, 4583.0 / 161280, -108847.0 / 3991680),
+            series(0, 0, 0, 0, 0, 20648693.0 / 638668800)
+        };
+
+        /** Scale factor on the central meridian of the UTM zones */
+        constexpr double UTM_K0 = 0.9996;
+        constexpr double UTM_FALSE_EASTING = 500000;
+        /** False northing of the southern hemisphere zones */
+        constexpr double UTM_FALSE_NORTHING_SOUTH = 10000000;
+
+        /** Longitude of the central meridian of a UTM zone, in degrees */
+        constexpr double getUTMCentralMeridian(int zone)
+        {
+            return 6 * zone - 183;
+        }
+
+        /** Result of the forward projection */
+        struct Projection {
+            /** Distance east of the central meridian, in meters */
+            double x;
+            /** Distance north of the equator, in meters */
+            double y;
+            /** Meridian convergence, in radians */
+            double convergence;
+            /** Point scale factor */
+            double scale;
+        };
+
+        /** Result of the inverse projection */
+        struct Geodetic {
+            double latitude;
+            double longitude;
+        };
+
+        namespace details {
+            /** Conformal latitude tau' = tan(chi) as a function of
+             * tau = tan(phi)
+             */
+            inline double conformalTau(double tau)
+            {
+                double e = std::sqrt(E2);
+                double sigma = std::sinh(e * std::atanh(e * tau / std::hypot(1.0, tau)));
+                return tau * std::hypot(1.0, sigma) - sigma * std::hypot(1.0, tau);
+            }
+
+            /** Inverse of conformalTau, by Newton's method */
+            inline double geographicTau(double taup)
+            {
+                double const e2m = 1 - E2;
+                double tau = taup / e2m;
+                for (int i = 0; i < 5; ++i) {
+                    double taupa = conformalTau(tau);
+                    double dtau = (taup - taupa) * (1 + e2m * tau * tau) /
+                        (e2m * std::hypot(1.0, tau) * std::hypot(1.0, taupa));
+                    tau += dtau;
+                    if (!(std::abs(dtau) >= 1e-15 * std::fmax(1.0, std::abs(tau)))) {
+                        break;
+                    }
+                }
+                return tau;
+            }
+
+            inline double wrapLongitude(double longitude)
+            {
+                return std::remainder(longitude, 360.0);
+            }
+        }
+
+        /** Project a point
+         *
+         * @param k0 scale factor on the central meridian
+         */
+        inline Projection forward(double latitude, double longitude,
+                                  double centralMeridian, double k0)
+        {
+            double phi = latitude * M_PI / 180;
+            double lambda = details::wrapLongitude(longitude - centralMeridian) * M_PI / 180;
+            double sinLambda = std::sin(lambda);
+            double cosLambda = std::cos(lambda);
+
+            double tau = std::tan(phi);
+            double taup = details::conformalTau(tau);
+            double xip = std::atan2(taup, cosLambda);
+            double etap = std::asinh(sinLambda / std::hypot(taup, cosLambda));
+
+            double xi = xip;
+            double eta = etap;
+            double p = 1;
+            double q = 0;
+            for (int j = 1; j <= ORDER; ++j) {
+                double sin2j = std::sin(2 * j * xip);
+                double cos2j = std::cos(2 * j * xip);
+                double sinh2j = std::sinh(2 * j * etap);
+                double cosh2j = std::cosh(2 * j * etap);
+                double alpha = ALPHA[j - 1];
+                xi += alpha * sin2j * cosh2j;
+                eta += alpha * cos2j * sinh2j;
+                p += 2 * j * alpha * cos2j * cosh2j;
+                q += 2 * j * alpha * sin2j * sinh2j;
+            }
+
+            double sinPhi = std::sin(phi);
+            Projection result;
+            result.x = k0 * RECTIFYING_RADIUS * eta;
+            result.y = k0 * RECTIFYING_RADIUS * xi;
+            result.convergence =
+                std::atan2(taup * sinLambda, std::hypot(1.0, taup) * cosLambda) +
+                std::atan2(q, p);
+            result.scale = k0 * RECTIFYING_RADIUS / geodesic::WGS84_A *
+                std::hypot(p, q) *
+                std::sqrt(1 - E2 * sinPhi * sinPhi) * std::hypot(1.0, tau) /
+                std::hypot(taup, cosLambda);
+            return result;
+        }
+
+        /** Inverse of forward() */
+        inline Geodetic inverse(double x, double y,
+                                double centralMeridian, double k0)
+        {
+            double xi = y / (k0 * RECTIFYING_RADIUS);
+            double eta = x / (k0 * RECTIFYING_RADIUS);
+
+            double xip = xi;
+            double etap = eta;
+            for (int j = 1; j <= ORDER; ++j) {
+                double beta = BETA[j - 1];
+                xip -= beta * std::sin(2 * j * xi) * std::cosh(2 * j * eta);
+                etap -= beta * std::cos(2 * j * xi) * std::sinh(2 * j * eta);
+            }
+
+            double sinhEtap = std::sinh(etap);
+            double cosXip = std::cos(xip);
+            double taup = std::sin(xip) / std::hypot(sinhEtap, cosXip);
+            double tau = details::geographicTau(taup);
+
+            Geodetic result;
+            result.latitude = std::atan(tau) * 180 / M_PI;
+            result.longitude = details::wrapLongitude(
+                centralMeridian + std::atan2(sinhEtap, cosXip) * 180 / M_PI);
+            return result;
+        }
+    }
+}
+
+#endif
@@ -1,14 +1,130 @@
 #include "UTMConverter.hpp"
+#include "UTMFrames.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <ogr_spatialref.h>
+#include <stdexcept>
 
 using namespace std;
 using namespace gps_base;
 
+const unsigned int UTMConverter::COST_SAMPLING_PERIOD;
+const size_t UTMConverter::COST_HISTOGRAM_SIZE;
+
+namespace {
+    /** Number of points converted at a time by convertToNWUFloat */
+    const size_t FLOAT_CONVERSION_BLOCK_SIZE = 1024;
+
+    enum Counter
+    {
+        GPS_TO_UTM,
+        GPS_TO_NWU,
+        UTM_TO_GPS,
+        NWU_TO_GPS,
+        TRANSFORM_REBUILDS,
+        TRANSFORM_FAILURES,
+        INVALID_SAMPLES,
+        SAMPLED_CALLS,
+        COUNTER_COUNT
+    };
+
+#ifdef GPS_BASE_INSTRUMENTATION
+    // Zero-initialized, as they have static storage
+    std::atomic<uint64_t> counters[COUNTER_COUNT];
+    std::atomic<uint64_t> costHistogram[UTMConverter::COST_HISTOGRAM_SIZE];
+
+    /** Number of conversion calls in progress in this thread */
+    thread_local unsigned int callDepth = 0;
+    /** Number of calls to skip before the next cost measurement */
+    thread_local unsigned int callsUntilSample = 0;
+
+    size_t getHistogramBucket(uint64_t nanoseconds)
+    {
+        size_t bucket = 0;
+        while (nanoseconds > 1 && bucket + 1 < UTMConverter::COST_HISTOGRAM_SIZE)
+        {
+            nanoseconds >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    uint64_t readCounter(std::atomic<uint64_t>& counter, bool reset)
+    {
+        if (reset)
+            return counter.exchange(0, std::memory_order_relaxed);
+        return counter.load(std::memory_order_relaxed);
+    }
+#endif
+
+    void increment(Counter counter, uint64_t n = 1)
+    {
+#ifdef GPS_BASE_INSTRUMENTATION
+        counters[counter].fetch_add(n, std::memory_order_relaxed);
+#endif
+    }
+
+    /** Counts a conversion call and samples its cost
+     *
+     * Only the outermost probe is active when conversions call each other,
+     * so that each call is counted once. Without instrumentation, this is
+     * an empty object.
+     */
+    class ConversionProbe
+    {
+#ifdef GPS_BASE_INSTRUMENTATION
+        bool mSampled = false;
+        size_t mPoints = 0;
+        chrono::steady_clock::time_point mStart;
+#endif
+
+    public:
+        ConversionProbe(Counter direction, size_t points = 1)
+        {
+#ifdef GPS_BASE_INSTRUMENTATION
+            if (callDepth++ != 0)
+                return;
+
+            increment(direction, points);
+            if (callsUntilSample-- == 0)
+            {
+                callsUntilSample = UTMConverter::COST_SAMPLING_PERIOD - 1;
+                mSampled = true;
+                mPoints = max<size_t>(points, 1);
+                mStart = chrono::steady_clock::now();
+            }
+#endif
+        }
+
+        ~ConversionProbe()
+        {
+#ifdef GPS_BASE_INSTRUMENTATION
+            --callDepth;
+            if (!mSampled)
+                return;
+
+            uint64_t duration = chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now() - mStart).count();
+            costHistogram[getHistogramBucket(duration / mPoints)].fetch_add(
+                1, std::memory_order_relaxed);
+            increment(SAMPLED_CALLS);
+#endif
+        }
+
+        ConversionProbe(ConversionProbe const&) = delete;
+        ConversionProbe& operator=(ConversionProbe const&) = delete;
+    };
+}
+
 UTMConverter::UTMConverter()
     : utm_zone(32)
     , utm_north(true)
     , origin(base::Position::Zero())
+    , height_reference(HEIGHT_ORTHOMETRIC)
     , utm2latlon(nullptr)
     , latlon2utm(nullptr)
 {
@@ -19,6 +135,7 @@ UTMConverter::UTMConverter(UTMConversionParameters const& parameters)
     : utm_zone(parameters.utm_zone)
     , utm_north(parameters.utm_north)
     , origin(parameters.nwu_origin)
+    , height_reference(parameters.height_reference)
     , utm2latlon(nullptr)
     , latlon2utm(nullptr)
 {
@@ -35,6 +152,8 @@ UTMConverter::UTMConverter(UTMConverter const& src)
     : utm_zone(src.utm_zone)
     , utm_north(src.utm_north)
     , origin(src.origin)
+    , height_reference(src.height_reference)
+    , geoid(src.geoid)
     , utm2latlon(nullptr)
     , latlon2utm(nullptr) {
     createCoTransform();
@@ -48,6 +167,8 @@ UTMConverter& UTMConverter::operator=(UTMConverter const& src) {
     utm_zone = src.utm_zone;
     utm_north = src.utm_north;
     origin = src.origin;
+    height_reference = src.height_reference;
+    geoid = src.geoid;
     createCoTransform();
 
     return *this;
@@ -58,6 +179,7 @@ void UTMConverter::setParameters(UTMConversionParameters const& parameters)
     utm_zone = parameters.utm_zone;
     utm_north = parameters.utm_north;
     origin = parameters.nwu_origin;
+    height_reference = parameters.height_reference;
     createCoTransform();
 }
 
@@ -67,11 +189,14 @@ UTMConversionParameters UTMConverter::getParameters() const
     parameters.utm_zone = utm_zone;
     parameters.utm_north = utm_north;
     parameters.nwu_origin = origin;
+    parameters.height_reference = height_reference;
     return parameters;
 }
 
 void UTMConverter::createCoTransform()
 {
+    increment(TRANSFORM_REBUILDS);
+
     OGRSpatialReference latlonSRS;
     latlonSRS.SetWellKnownGeogCS("WGS84");
 #if GDAL_VERSION_MAJOR >= 3
@@ -85,12 +210,19 @@ void UTMConverter::createCoTransform()
     OGRCoordinateTransformation* newToUTM =
         OGRCreateCoordinateTransformation(&latlonSRS, &utmSRS);
     if (newToUTM == NULL)
+    {
+        increment(TRANSFORM_FAILURES);
         throw runtime_error("failed to compute coordinate transform from lat/lon to UTM");
+    }
 
     OGRCoordinateTransformation* newToLatLon =
         OGRCreateCoordinateTransformation(&utmSRS, &latlonSRS);
     if (newToLatLon == NULL)
+    {
+        delete newToUTM;
+        increment(TRANSFORM_FAILURES);
         throw runtime_error("failed to compute coordinate transform from UTM to lat/lon");
+    }
 
     delete latlon2utm;
     latlon2utm = newToUTM;
@@ -120,6 +252,63 @@ bool UTMConverter::getUTMNorth() const
     return this->utm_north;
 }
 
+void UTMConverter::setHeightReference(HEIGHT_REFERENCE reference)
+{
+    this->height_reference = reference;
+}
+
+HEIGHT_REFERENCE UTMConverter::getHeightReference() const
+{
+    return this->height_reference;
+}
+
+void UTMConverter::setGeoidModel(std::shared_ptr<GeoidModel const> model)
+{
+    this->geoid = model;
+}
+
+std::shared_ptr<GeoidModel const> UTMConverter::getGeoidModel() const
+{
+    return this->geoid;
+}
+
+void UTMConverter::convertHeights(size_t count,
+                                  double const* latitudes,
+                                  double const* longitudes,
+                                  double const* altitudes,
+                                  double const* separations,
+                                  double* heights) const
+{
+    utm::convertHeights(height_reference, geoid.get(), count,
+                        latitudes, longitudes, altitudes, separations, heights);
+}
+
+UTMConverterStatistics UTMConverter::getStatistics(bool reset)
+{
+    UTMConverterStatistics statistics;
+    statistics.time = base::Time::now();
+    statistics.costHistogram.resize(COST_HISTOGRAM_SIZE, 0);
+#ifdef GPS_BASE_INSTRUMENTATION
+    statistics.enabled = true;
+    statistics.gpsToUTM = readCounter(counters[GPS_TO_UTM], reset);
+    statistics.gpsToNWU = readCounter(counters[GPS_TO_NWU], reset);
+    statistics.utmToGPS = readCounter(counters[UTM_TO_GPS], reset);
+    statistics.nwuToGPS = readCounter(counters[NWU_TO_GPS], reset);
+    statistics.transformRebuilds = readCounter(counters[TRANSFORM_REBUILDS], reset);
+    statistics.transformFailures = readCounter(counters[TRANSFORM_FAILURES], reset);
+    statistics.invalidSamples = readCounter(counters[INVALID_SAMPLES], reset);
+    statistics.sampledCalls = readCounter(counters[SAMPLED_CALLS], reset);
+    for (size_t i = 0; i < COST_HISTOGRAM_SIZE; ++i)
+        statistics.costHistogram[i] = readCounter(costHistogram[i], reset);
+#endif
+    return statistics;
+}
+
+void UTMConverter::resetStatistics()
+{
+    getStatistics(true);
+}
+
 base::Position UTMConverter::getNWUOrigin() const
 {
     return this->origin;
@@ -132,44 +321,110 @@ void UTMConverter::setNWUOrigin(base::Position origin)
 
 base::samples::RigidBodyState UTMConverter::convertToUTM(const gps_base::Solution &solution) const
 {
-    base::samples::RigidBodyState position;
-    position.time = solution.time;
-
+    ConversionProbe probe(GPS_TO_UTM);
     if (solution.positionType == gps_base::NO_SOLUTION)
-        return position;
+    {
+        increment(INVALID_SAMPLES);
+        return utm::makeEmptyState(solution);
+    }
 
     // if there is a valid reading, then write it to position readings port
     double northing = solution.latitude;
     double easting  = solution.longitude;
-    double altitude = solution.altitude;
+    double altitude = utm::toOutputHeight(height_reference, geoid.get(), solution);
 
-    latlon2utm->Transform(1, &easting, &northing, &altitude);
+    if (!latlon2utm->Transform(1, &easting, &northing, &altitude))
+        increment(TRANSFORM_FAILURES);
 
-    position.time = solution.time;
-    position.position.x() = easting;
-    position.position.y() = northing;
-    position.position.z() = altitude;
-    position.cov_position = Eigen::Vector3d(
-        solution.deviationLongitude * solution.deviationLongitude,
-        solution.deviationLatitude * solution.deviationLatitude,
-        solution.deviationAltitude * solution.deviationAltitude).asDiagonal();
-    return position;
+    return utm::makeUTMState(solution, easting, northing, altitude);
+}
+
+std::vector<base::samples::RigidBodyState> UTMConverter::convertToUTM(
+    std::vector<gps_base::Solution> const& solutions) const
+{
+    ConversionProbe probe(GPS_TO_UTM, solutions.size());
+    std::vector<double> latitudes, longitudes, altitudes, separations;
+    latitudes.reserve(solutions.size());
+    longitudes.reserve(solutions.size());
+    altitudes.reserve(solutions.size());
+    separations.reserve(solutions.size());
+    for (auto const& solution : solutions)
+    {
+        if (solution.positionType == gps_base::NO_SOLUTION)
+            continue;
+        latitudes.push_back(solution.latitude);
+        longitudes.push_back(solution.longitude);
+        altitudes.push_back(solution.altitude);
+        separations.push_back(solution.geoidalSeparation);
+    }
+
+    std::vector<double> eastings(latitudes.size());
+    std::vector<double> northings(latitudes.size());
+    std::vector<double> heights(latitudes.size());
+    convertHeights(latitudes.size(), latitudes.data(), longitudes.data(),
+                   altitudes.data(), separations.data(), heights.data());
+    std::swap(altitudes, heights);
+    convertToUTM(latitudes.size(), latitudes.data(), longitudes.data(), altitudes.data(),
+                 eastings.data(), northings.data(), heights.data());
+
+    std::vector<base::samples::RigidBodyState> result;
+    result.reserve(solutions.size());
+    size_t valid = 0;
+    for (auto const& solution : solutions)
+    {
+        if (solution.positionType == gps_base::NO_SOLUTION)
+        {
+            increment(INVALID_SAMPLES);
+            result.push_back(utm::makeEmptyState(solution));
+            continue;
+        }
+        result.push_back(utm::makeUTMState(solution,
+            eastings[valid], northings[valid], heights[valid]));
+        ++valid;
+    }
+    return result;
+}
+
+void UTMConverter::convertToUTM(size_t count,
+                                double const* latitudes,
+                                double const* longitudes,
+                                double const* altitudes,
+                                double* eastings,
+                                double* northings,
+                                double* heights) const
+{
+    ConversionProbe probe(GPS_TO_UTM, count);
+    std::copy(longitudes, longitudes + count, eastings);
+    std::copy(latitudes, latitudes + count, northings);
+    std::copy(altitudes, altitudes + count, heights);
+
+    // OGRCoordinateTransformation::Transform takes an int count
+    size_t const maxChunk = std::numeric_limits<int>::max();
+    for (size_t offset = 0; offset < count; offset += maxChunk)
+    {
+        int chunk = std::min(maxChunk, count - offset);
+        if (!latlon2utm->Transform(chunk,
+                eastings + offset, northings + offset, heights + offset))
+            increment(TRANSFORM_FAILURES);
+    }
 }
 
 gps_base::Solution UTMConverter::convertUTMToGPS(const base::samples::RigidBodyState& position) const
 {
+    ConversionProbe probe(UTM_TO_GPS);
     // if there is a valid reading, then write it to position readings port
     double easting  = position.position.x();
     double northing = position.position.y();
     double altitude = position.position.z();
 
-    utm2latlon->Transform(1, &easting, &northing, &altitude);
+    if (!utm2latlon->Transform(1, &easting, &northing, &altitude))
+        increment(TRANSFORM_FAILURES);
 
     gps_base::Solution solution;
     solution.time = position.time;
     solution.latitude = northing;
     solution.longitude = easting;
-    solution.altitude = altitude;
+    utm::fromOutputHeight(height_reference, geoid.get(), solution, altitude);
     solution.deviationLongitude = sqrt(position.cov_position(0, 0));
     solution.deviationLatitude = sqrt(position.cov_position(1, 1));
     solution.deviationAltitude = sqrt(position.cov_position(2, 2));
@@ -178,34 +433,213 @@ gps_base::Solution UTMConverter::convertUTMToGPS(const base::samples::RigidBodyS
 
 base::samples::RigidBodyState UTMConverter::convertToNWU(const gps_base::Solution &solution) const
 {
+    ConversionProbe probe(GPS_TO_NWU);
     return convertToNWU(convertToUTM(solution));
 }
 
+std::vector<base::samples::RigidBodyState> UTMConverter::convertToNWU(
+    std::vector<gps_base::Solution> const& solutions) const
+{
+    ConversionProbe probe(GPS_TO_NWU, solutions.size());
+    std::vector<base::samples::RigidBodyState> result = convertToUTM(solutions);
+    for (auto& state : result)
+        state = convertToNWU(state);
+    return result;
+}
+
+void UTMConverter::convertToNWU(size_t count,
+                                double const* latitudes,
+                                double const* longitudes,
+                                double const* altitudes,
+                                double* x,
+                                double* y,
+                                double* z) const
+{
+    ConversionProbe probe(GPS_TO_NWU, count);
+    // Compute UTM in-place, eastings in y and northings in x
+    convertToUTM(count, latitudes, longitudes, altitudes, y, x, z);
+    for (size_t i = 0; i < count; ++i)
+    {
+        base::Position nwu = utm::toNWU(y[i], x[i], z[i], origin);
+        x[i] = nwu.x();
+        y[i] = nwu.y();
+        z[i] = nwu.z();
+    }
+}
+
+FloatConversionReport UTMConverter::convertToNWUFloat(size_t count,
+                                                     double const* latitudes,
+                                                     double const* longitudes,
+                                                     double const* altitudes,
+                                                     float* xyz,
+                                                     double tolerance,
+                                                     base::Position const& anchor) const
+{
+    if (!(tolerance > 0))
+        throw invalid_argument("UTMConverter: the float tolerance must be strictly positive");
+
+    ConversionProbe probe(GPS_TO_NWU, count);
+    FloatConversionReport report;
+    report.count = count;
+    report.range = utm::getFloatRange(tolerance);
+    report.firstOutOfRange = count;
+
+    // Convert in double precision by blocks, to bound the temporary memory
+    double x[FLOAT_CONVERSION_BLOCK_SIZE];
+    double y[FLOAT_CONVERSION_BLOCK_SIZE];
+    double z[FLOAT_CONVERSION_BLOCK_SIZE];
+    for (size_t start = 0; start < count; start += FLOAT_CONVERSION_BLOCK_SIZE)
+    {
+        size_t size = min(FLOAT_CONVERSION_BLOCK_SIZE, count - start);
+        convertToNWU(size, latitudes + start, longitudes + start, altitudes + start,
+                     x, y, z);
+        utm::packFloats(size, start, x, y, z, anchor, xyz + 3 * start, report);
+    }
+    return report;
+}
+
 gps_base::Solution UTMConverter::convertNWUToGPS(const base::samples::RigidBodyState& nwu) const
 {
+    ConversionProbe probe(NWU_TO_GPS);
     return convertUTMToGPS(convertNWUToUTM(nwu));
 }
 
 base::samples::RigidBodyState UTMConverter::convertToNWU(const base::samples::RigidBodyState &utm) const
 {
-    base::samples::RigidBodyState position = utm;
-    double easting  = position.position.x();
-    double northing = position.position.y();
-    position.position.x() = northing;
-    position.position.y() = 1000000 - easting;
-    position.position -= origin;
-    std::swap(position.cov_position(0, 0), position.cov_position(1, 1));
-    return position;
+    return utm::toNWU(utm, origin);
 }
 
 base::samples::RigidBodyState UTMConverter::convertNWUToUTM(const base::samples::RigidBodyState &nwu) const
 {
-    base::samples::RigidBodyState utm = nwu;
-    auto position = nwu.position + origin;
-    double northing  = position.x();
-    double easting = 1000000 - position.y();
-    utm.position.x() = easting;
-    utm.position.y() = northing;
-    std::swap(utm.cov_position(0, 0), utm.cov_position(1, 1));
-    return utm;
+    return utm::fromNWU(nwu, origin);
+}
+
+Eigen::Matrix3d UTMGridProperties::getJacobian() const
+{
+    double c = cos(convergence);
+    double s = sin(convergence);
+    Eigen::Matrix3d jacobian;
+    jacobian << scale * c, -scale * s, 0,
+                scale * s,  scale * c, 0,
+                0, 0, 1;
+    return jacobian;
+}
+
+base::Orientation UTMGridProperties::getRotation() const
+{
+    return base::Orientation(Eigen::AngleAxisd(convergence, Eigen::Vector3d::UnitZ()));
+}
+
+UTMGridProperties UTMConverter::getGridProperties(double latitude, double longitude) const
+{
+    tmerc::Projection projection = utm::project(
+        tmerc::getUTMCentralMeridian(utm_zone), utm::getFalseNorthing(utm_north),
+        latitude, longitude);
+    UTMGridProperties grid;
+    grid.convergence = projection.convergence;
+    grid.scale = projection.scale;
+    return grid;
+}
+
+base::samples::RigidBodyState UTMConverter::convertToUTMWithGrid(
+    gps_base::Solution const& solution, base::Orientation const& orientation) const
+{
+    ConversionProbe probe(GPS_TO_UTM);
+    if (solution.positionType == gps_base::NO_SOLUTION)
+    {
+        increment(INVALID_SAMPLES);
+        return utm::makeEmptyState(solution);
+    }
+
+    tmerc::Projection projection = utm::project(
+        tmerc::getUTMCentralMeridian(utm_zone), utm::getFalseNorthing(utm_north),
+        solution.latitude, solution.longitude);
+    double height = utm::toOutputHeight(height_reference, geoid.get(), solution);
+    return utm::makeGridState(solution, projection, height, orientation);
+}
+
+std::vector<base::samples::RigidBodyState> UTMConverter::convertToUTMWithGrid(
+    std::vector<gps_base::Solution> const& solutions) const
+{
+    ConversionProbe probe(GPS_TO_UTM, solutions.size());
+    std::vector<base::samples::RigidBodyState> result;
+    result.reserve(solutions.size());
+    for (auto const& solution : solutions)
+        result.push_back(convertToUTMWithGrid(solution));
+    return result;
+}
+
+void UTMConverter::convertToUTMWithGrid(size_t count,
+                                        double const* latitudes,
+                                        double const* longitudes,
+                                        double const* altitudes,
+                                        double* eastings,
+                                        double* northings,
+                                        double* heights,
+                                        double* convergences,
+                                        double* scales) const
+{
+    ConversionProbe probe(GPS_TO_UTM, count);
+    double centralMeridian = tmerc::getUTMCentralMeridian(utm_zone);
+    double falseNorthing = utm::getFalseNorthing(utm_north);
+    for (size_t i = 0; i < count; ++i)
+    {
+        tmerc::Projection projection = utm::project(
+            centralMeridian, falseNorthing, latitudes[i], longitudes[i]);
+        eastings[i] = projection.x;
+        northings[i] = projection.y;
+        heights[i] = altitudes[i];
+        convergences[i] = projection.convergence;
+        scales[i] = projection.scale;
+    }
+}
+
+base::samples::RigidBodyState UTMConverter::convertToNWUWithGrid(
+    gps_base::Solution const& solution, base::Orientation const& orientation) const
+{
+    ConversionProbe probe(GPS_TO_NWU);
+    if (solution.positionType == gps_base::NO_SOLUTION)
+    {
+        increment(INVALID_SAMPLES);
+        return utm::makeEmptyState(solution);
+    }
+    return convertToNWU(convertToUTMWithGrid(solution, utm::rotateZ90(orientation, false)));
+}
+
+std::vector<base::samples::RigidBodyState> UTMConverter::convertToNWUWithGrid(
+    std::vector<gps_base::Solution> const& solutions) const
+{
+    ConversionProbe probe(GPS_TO_NWU, solutions.size());
+    std::vector<base::samples::RigidBodyState> result;
+    result.reserve(solutions.size());
+    for (auto const& solution : solutions)
+        result.push_back(convertToNWUWithGrid(solution));
+    return result;
+}
+
+gps_base::Solution UTMConverter::convertUTMToGPSWithGrid(
+    base::samples::RigidBodyState const& utm, base::Orientation* orientation) const
+{
+    ConversionProbe probe(UTM_TO_GPS);
+    double centralMeridian = tmerc::getUTMCentralMeridian(utm_zone);
+    double falseNorthing = utm::getFalseNorthing(utm_north);
+    tmerc::Geodetic geodetic = utm::unproject(
+        centralMeridian, falseNorthing, utm.position.x(), utm.position.y());
+    tmerc::Projection projection = utm::project(
+        centralMeridian, falseNorthing, geodetic.latitude, geodetic.longitude);
+
+    gps_base::Solution solution =
+        utm::makeGridSolution(utm, geodetic, projection, orientation);
+    utm::fromOutputHeight(height_reference, geoid.get(), solution, utm.position.z());
+    return solution;
+}
+
+gps_base::Solution UTMConverter::convertNWUToGPSWithGrid(
+    base::samples::RigidBodyState const& nwu, base::Orientation* orientation) const
+{
+    ConversionProbe probe(NWU_TO_GPS);
+    gps_base::Solution solution = convertUTMToGPSWithGrid(convertNWUToUTM(nwu), orientation);
+    if (orientation)
+        *orientation = utm::rotateZ90(*orientation, true);
+    return solution;
 }
@@ -1,6 +1,8 @@
 #ifndef _GPS_BASE_UTMCONVERTER_HPP_
 #define _GPS_BASE_UTMCONVERTER_HPP_
 
+#include <memory>
+#include <vector>
 #include <base/samples/RigidBodyState.hpp>
 #include <gps_base/BaseTypes.hpp>
 
@@ -8,17 +10,50 @@ class OGRCoordinateTransformation;
 
 namespace gps_base
 {
+    class GeoidModel;
+
+    /** Local properties of the UTM grid at a given point */
+    struct UTMGridProperties
+    {
+        /** Meridian convergence, in radians
+         *
+         * A direction in the local east-north frame is rotated
+         * counter-clockwise by this angle in the UTM grid. It is zero on the
+         * zone's central meridian.
+         */
+        double convergence;
+        /** Point scale factor of the projection */
+        double scale;
+
+        /** Jacobian of (easting, northing, altitude) with respect to a
+         * displacement in the local ENU frame
+         */
+        Eigen::Matrix3d getJacobian() const;
+
+        /** Rotation from the local ENU frame to the UTM grid */
+        base::Orientation getRotation() const;
+    };
+
     class UTMConverter
     {
         private:
             int utm_zone;
             bool utm_north;
             base::Position origin;
+            HEIGHT_REFERENCE height_reference;
+            std::shared_ptr<GeoidModel const> geoid;
             OGRCoordinateTransformation *utm2latlon, *latlon2utm;
 
             void createCoTransform();
 
         public:
+            /** One call in COST_SAMPLING_PERIOD, per thread, has its cost
+             * measured by the instrumentation
+             */
+            static const unsigned int COST_SAMPLING_PERIOD = 16;
+            /** Size of UTMConverterStatistics::costHistogram */
+            static const std::size_t COST_HISTOGRAM_SIZE = 32;
+
             UTMConverter();
             UTMConverter(UTMConversionParameters const& parameters);
             UTMConverter(UTMConverter const& src);
@@ -44,6 +79,54 @@ namespace gps_base
             /** Get whether we're north or south of the equator */
             bool getUTMNorth() const;
 
+            /** Sets the reference of the output heights */
+            void setHeightReference(HEIGHT_REFERENCE reference);
+
+            /** Get the reference of the output heights */
+            HEIGHT_REFERENCE getHeightReference() const;
+
+            /** Sets the geoid model used to compute the output heights
+             *
+             * Solution::altitude is a height above mean sea level, with the
+             * receiver's own geoid model, and Solution::geoidalSeparation
+             * the height of that geoid above the ellipsoid.
+             *
+             * Without a geoid model, orthometric heights are the solutions'
+             * altitudes, and ellipsoidal heights the sum of the altitude and
+             * the geoidal separation.
+             *
+             * With a geoid model, the ellipsoidal height is computed the same
+             * way, using the model's separation if the solution's is NaN. The
+             * orthometric height is then the ellipsoidal height minus the
+             * model's separation, i.e. heights are consistent regardless of
+             * the geoid model used by the receiver.
+             *
+             * The inverse conversions set the geoidal separation to the
+             * model's, or to zero in ellipsoidal mode without a model.
+             *
+             * The model is shared between copies of the converter. Pass a
+             * null pointer to remove it.
+             */
+            void setGeoidModel(std::shared_ptr<GeoidModel const> model);
+
+            /** Get the geoid model, or null if there is none */
+            std::shared_ptr<GeoidModel const> getGeoidModel() const;
+
+            /** Compute heights in the output height reference for arrays of
+             * coordinates
+             *
+             * This is the array counterpart of the height computations done
+             * by the Solution-based conversions. The array conversions expect
+             * heights computed this way. @a separations may contain NaNs.
+             * @a heights may not overlap the input arrays.
+             */
+            void convertHeights(std::size_t count,
+                                double const* latitudes,
+                                double const* longitudes,
+                                double const* altitudes,
+                                double const* separations,
+                                double* heights) const;
+
             /** Set a position that will be removed from the computed UTM
              * solution
              */
@@ -53,6 +136,21 @@ namespace gps_base
              */
             base::Position getNWUOrigin() const;
 
+            /** Snapshot of the instrumentation counters of all converters
+             *
+             * The counters are only updated if the library is built with the
+             * GPS_BASE_INSTRUMENTATION CMake option. The snapshot is
+             * otherwise all zeroes, with UTMConverterStatistics::enabled
+             * false.
+             *
+             * @param reset if true, the counters are reset as they are read,
+             *   i.e. successive snapshots cover disjoint periods
+             */
+            static UTMConverterStatistics getStatistics(bool reset = false);
+
+            /** Reset the instrumentation counters */
+            static void resetStatistics();
+
             /** Convert a GPS solution into UTM coordinates
              *
              * The returned RBS will has all its fields invalidated (only the
@@ -60,6 +158,107 @@ namespace gps_base
              */
             base::samples::RigidBodyState convertToUTM(const gps_base::Solution &solution) const;
 
+            /** Convert a set of GPS solutions into UTM coordinates
+             *
+             * This is equivalent to calling convertToUTM on each solution,
+             * but does a single call to the underlying coordinate transform
+             */
+            std::vector<base::samples::RigidBodyState> convertToUTM(
+                std::vector<gps_base::Solution> const& solutions) const;
+
+            /** Convert arrays of latitudes, longitudes and altitudes into UTM
+             *
+             * This is the lowest-level batch conversion, meant to be used on
+             * columnar data such as SolutionColumns. The output arrays must
+             * hold @a count elements and may not overlap the input arrays.
+             *
+             * The altitudes are copied as-is, i.e. are expected to be in the
+             * output height reference already (see convertHeights)
+             */
+            void convertToUTM(std::size_t count,
+                              double const* latitudes,
+                              double const* longitudes,
+                              double const* altitudes,
+                              double* eastings,
+                              double* northings,
+                              double* heights) const;
+
+            /** Properties of the UTM grid at the given latitude and longitude */
+            UTMGridProperties getGridProperties(double latitude, double longitude) const;
+
+            /** Convert a GPS solution into UTM coordinates, accounting for
+             * the rotation and scale of the projection
+             *
+             * The projection is computed analytically (see TransverseMercator.hpp)
+             * and does not go through the coordinate transform used by
+             * convertToUTM, from which it differs by a few nanometers.
+             *
+             * The deviations are interpreted as a diagonal covariance in the
+             * local ENU frame, and propagated as the full covariance
+             * J Sigma J^T, J being UTMGridProperties::getJacobian().
+             *
+             * @param orientation an orientation in the local ENU frame, rotated
+             *   into the UTM grid. With the default, the returned orientation
+             *   is the rotation from the local ENU frame to the grid.
+             */
+            base::samples::RigidBodyState convertToUTMWithGrid(
+                gps_base::Solution const& solution,
+                base::Orientation const& orientation = base::Orientation::Identity()) const;
+
+            /** Batch version of convertToUTMWithGrid */
+            std::vector<base::samples::RigidBodyState> convertToUTMWithGrid(
+                std::vector<gps_base::Solution> const& solutions) const;
+
+            /** Array version of convertToUTMWithGrid
+             *
+             * It computes the UTM coordinates, meridian convergences and
+             * scale factors of the given points. The output arrays must hold
+             * @a count elements.
+             */
+            void convertToUTMWithGrid(std::size_t count,
+                                      double const* latitudes,
+                                      double const* longitudes,
+                                      double const* altitudes,
+                                      double* eastings,
+                                      double* northings,
+                                      double* heights,
+                                      double* convergences,
+                                      double* scales) const;
+
+            /** NWU version of convertToUTMWithGrid
+             *
+             * @param orientation an orientation in the local NWU frame
+             */
+            base::samples::RigidBodyState convertToNWUWithGrid(
+                gps_base::Solution const& solution,
+                base::Orientation const& orientation = base::Orientation::Identity()) const;
+
+            /** Batch version of convertToNWUWithGrid */
+            std::vector<base::samples::RigidBodyState> convertToNWUWithGrid(
+                std::vector<gps_base::Solution> const& solutions) const;
+
+            /** Inverse of convertToUTMWithGrid
+             *
+             * The full covariance is propagated back into the local ENU frame.
+             * The returned deviations are the square roots of its diagonal.
+             * The Solution's solution type field is not set by this function.
+             *
+             * @param orientation if not null, set to the state's orientation
+             *   expressed in the local ENU frame
+             */
+            gps_base::Solution convertUTMToGPSWithGrid(
+                base::samples::RigidBodyState const& utm,
+                base::Orientation* orientation = nullptr) const;
+
+            /** Inverse of convertToNWUWithGrid
+             *
+             * @param orientation if not null, set to the state's orientation
+             *   expressed in the local NWU frame
+             */
+            gps_base::Solution convertNWUToGPSWithGrid(
+                base::samples::RigidBodyState const& nwu,
+                base::Orientation* orientation = nullptr) const;
+
             /** Convert a UTM position into latitude/longitude with deviations
              * The Solutions' solution type field is not set by this function
              */
@@ -72,15 +271,72 @@ namespace gps_base
              */
             base::samples::RigidBodyState convertToNWU(const gps_base::Solution &solution) const;
 
+            /** Convert a set of GPS solutions into NWU coordinates
+             *
+             * This is the batch version of convertToNWU
+             */
+            std::vector<base::samples::RigidBodyState> convertToNWU(
+                std::vector<gps_base::Solution> const& solutions) const;
+
+            /** Convert arrays of latitudes, longitudes and altitudes into NWU
+             *
+             * This is the NWU counterpart of the array version of
+             * convertToUTM, with the same constraints on the arrays
+             */
+            void convertToNWU(std::size_t count,
+                              double const* latitudes,
+                              double const* longitudes,
+                              double const* altitudes,
+                              double* x,
+                              double* y,
+                              double* z) const;
+
+            /** Convert arrays of latitudes, longitudes and altitudes into
+             * single-precision NWU coordinates relative to an anchor
+             *
+             * The positions are written interleaved, as x, y, z for each
+             * point, which uses a quarter of the memory of the three double
+             * arrays of convertToNWU. They are computed in double precision
+             * and only rounded once made relative to @a anchor, which should
+             * therefore be close to the points, e.g. the center of the
+             * chunk of data being converted.
+             *
+             * The points whose coordinates exceed the range within which a
+             * float is precise to @a tolerance are still converted, but are
+             * counted in the report. Points with a non-finite coordinate are
+             * set to NaN on all axes.
+             *
+             * @param xyz output array of 3 * count floats
+             * @param tolerance the maximum acceptable rounding error, in
+             *   meters
+             * @param anchor the reference of the output, in the NWU frame
+             *   (i.e. relative to the NWU origin)
+             * @throw std::invalid_argument if the tolerance is not strictly
+             *   positive
+             */
+            FloatConversionReport convertToNWUFloat(
+                std::size_t count,
+                double const* latitudes,
+                double const* longitudes,
+                double const* altitudes,
+                float* xyz,
+                double tolerance,
+                base::Position const& anchor = base::Position::Zero()) const;
+
             /** Convert NWU coordinates (Rock's convention) into GPS coordinates
              */
             gps_base::Solution convertNWUToGPS(const base::samples::RigidBodyState& nwu) const;
 
             /** Convert a UTM-converted GPS solution into NWU coordinates (Rock's convention)
+             *
+             * The position, velocity, orientation and their covariances are
+             * rotated from the UTM axes into the NWU axes
              */
             base::samples::RigidBodyState convertToNWU(const base::samples::RigidBodyState &solution) const;
 
             /** Convert a NWU position into a UTM position
+             *
+             * This is the inverse of convertToNWU(RigidBodyState)
              */
             base::samples::RigidBodyState convertNWUToUTM(const base::samples::RigidBodyState &nwu) const;
     };
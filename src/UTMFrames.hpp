@@ -0,0 +1,342 @@
+#ifndef GPS_BASE_UTMFRAMES_HPP
+#define GPS_BASE_UTMFRAMES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <base/samples/RigidBodyState.hpp>
+#include <gps_base/BaseTypes.hpp>
+#include <gps_base/GeoidModel.hpp>
+#include <gps_base/TransverseMercator.hpp>
+
+namespace gps_base {
+    /** Building blocks of the UTM and NWU conversions
+     *
+     * These are the parts of the conversions that do not depend on how the
+     * converter stores its zone, shared by UTMConverter and
+     * FixedUTMConverter. They are inline so that the latter can be fully
+     * specialized by the compiler.
+     */
+    namespace utm {
+        /** Offset applied on the eastings in the NWU frame, so that the
+         * westing stays positive
+         */
+        constexpr double NWU_WESTING_OFFSET = 1000000;
+
+        constexpr double getFalseNorthing(bool north)
+        {
+            return north ? 0 : tmerc::UTM_FALSE_NORTHING_SOUTH;
+        }
+
+        /** Project a point on the UTM grid
+         *
+         * The returned x and y are the easting and northing
+         */
+        inline tmerc::Projection project(double centralMeridian, double falseNorthing,
+                                         double latitude, double longitude)
+        {
+            tmerc::Projection projection = tmerc::forward(
+                latitude, longitude, centralMeridian, tmerc::UTM_K0);
+            projection.x += tmerc::UTM_FALSE_EASTING;
+            projection.y += falseNorthing;
+            return projection;
+        }
+
+        /** Inverse of project() */
+        inline tmerc::Geodetic unproject(double centralMeridian, double falseNorthing,
+                                         double easting, double northing)
+        {
+            return tmerc::inverse(easting - tmerc::UTM_FALSE_EASTING,
+                                  northing - falseNorthing,
+                                  centralMeridian, tmerc::UTM_K0);
+        }
+
+        /** Convert an easting, northing and height into the NWU frame */
+        inline base::Position toNWU(double easting, double northing, double height,
+                                    base::Position const& origin)
+        {
+            return base::Position(northing, NWU_WESTING_OFFSET - easting, height) - origin;
+        }
+
+        /** Rotate a vector by +-90 degrees around Z
+         *
+         * The UTM to NWU rotation maps (x, y, z) to (y, -x, z). It is applied
+         * as a signed permutation, not a matrix product, so that unset (NaN
+         * or infinite) values do not leak into the other axes
+         */
+        inline Eigen::Vector3d rotateZ90(Eigen::Vector3d const& v, bool toNWU)
+        {
+            double sign = toNWU ? 1 : -1;
+            return Eigen::Vector3d(sign * v.y(), -sign * v.x(), v.z());
+        }
+
+        inline Eigen::Matrix3d rotateZ90(Eigen::Matrix3d const& m, bool toNWU)
+        {
+            double sign = toNWU ? 1 : -1;
+            int const permutation[3] = { 1, 0, 2 };
+            double const signs[3] = { sign, -sign, 1 };
+            Eigen::Matrix3d result;
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < 3; ++j)
+                    result(i, j) = signs[i] * signs[j] * m(permutation[i], permutation[j]);
+            return result;
+        }
+
+        inline base::Orientation rotateZ90(base::Orientation const& q, bool toNWU)
+        {
+            return base::Orientation(
+                Eigen::AngleAxisd(toNWU ? -M_PI / 2 : M_PI / 2, Eigen::Vector3d::UnitZ())) * q;
+        }
+
+        /** Convert a state from the UTM axes into the NWU frame */
+        inline base::samples::RigidBodyState toNWU(
+            base::samples::RigidBodyState const& utm, base::Position const& origin)
+        {
+            base::samples::RigidBodyState nwu = utm;
+            nwu.position = toNWU(utm.position.x(), utm.position.y(), utm.position.z(), origin);
+            nwu.cov_position = rotateZ90(utm.cov_position, true);
+            nwu.orientation = rotateZ90(utm.orientation, true);
+            nwu.velocity = rotateZ90(utm.velocity, true);
+            nwu.cov_velocity = rotateZ90(utm.cov_velocity, true);
+            return nwu;
+        }
+
+        /** Inverse of toNWU(RigidBodyState) */
+        inline base::samples::RigidBodyState fromNWU(
+            base::samples::RigidBodyState const& nwu, base::Position const& origin)
+        {
+            base::samples::RigidBodyState utm = nwu;
+            base::Position position = nwu.position + origin;
+            utm.position.x() = NWU_WESTING_OFFSET - position.y();
+            utm.position.y() = position.x();
+            utm.cov_position = rotateZ90(nwu.cov_position, false);
+            utm.orientation = rotateZ90(nwu.orientation, false);
+            utm.velocity = rotateZ90(nwu.velocity, false);
+            utm.cov_velocity = rotateZ90(nwu.cov_velocity, false);
+            return utm;
+        }
+
+        /** A state with only its timestamp set, for solutions without a
+         * position
+         */
+        inline base::samples::RigidBodyState makeEmptyState(gps_base::Solution const& solution)
+        {
+            base::samples::RigidBodyState state;
+            state.time = solution.time;
+            return state;
+        }
+
+        /** A UTM state whose covariance is the solution's deviations,
+         * ignoring the grid rotation and scale
+         */
+        inline base::samples::RigidBodyState makeUTMState(
+            gps_base::Solution const& solution,
+            double easting, double northing, double height)
+        {
+            base::samples::RigidBodyState state;
+            state.time = solution.time;
+            state.position = base::Position(easting, northing, height);
+            state.cov_position = Eigen::Vector3d(
+                solution.deviationLongitude * solution.deviationLongitude,
+                solution.deviationLatitude * solution.deviationLatitude,
+                solution.deviationAltitude * solution.deviationAltitude).asDiagonal();
+            return state;
+        }
+
+        /** A UTM state whose covariance and orientation account for the grid
+         * rotation and scale
+         *
+         * The covariance is computed block-wise so that an unset altitude
+         * deviation does not leak into the horizontal block, and vice-versa
+         *
+         * @param orientation the orientation in the local ENU frame
+         */
+        inline base::samples::RigidBodyState makeGridState(
+            gps_base::Solution const& solution, tmerc::Projection const& projection,
+            double height, base::Orientation const& orientation)
+        {
+            double c = std::cos(projection.convergence);
+            double s = std::sin(projection.convergence);
+            double k2 = projection.scale * projection.scale;
+            double east = solution.deviationLongitude * solution.deviationLongitude;
+            double north = solution.deviationLatitude * solution.deviationLatitude;
+
+            base::samples::RigidBodyState state;
+            state.time = solution.time;
+            state.position = base::Position(projection.x, projection.y, height);
+            state.cov_position = Eigen::Matrix3d::Zero();
+            state.cov_position(0, 0) = k2 * (c * c * east + s * s * north);
+            state.cov_position(1, 1) = k2 * (s * s * east + c * c * north);
+            state.cov_position(0, 1) = state.cov_position(1, 0) = k2 * c * s * (east - north);
+            state.cov_position(2, 2) = solution.deviationAltitude * solution.deviationAltitude;
+            state.orientation = base::Orientation(
+                Eigen::AngleAxisd(projection.convergence, Eigen::Vector3d::UnitZ())) * orientation;
+            return state;
+        }
+
+        /** Inverse of makeGridState
+         *
+         * The altitude is not set
+         *
+         * @param projection the projection of the state's position
+         * @param orientation if not null, set to the state's orientation in
+         *   the local ENU frame
+         */
+        inline gps_base::Solution makeGridSolution(
+            base::samples::RigidBodyState const& utm,
+            tmerc::Geodetic const& geodetic, tmerc::Projection const& projection,
+            base::Orientation* orientation)
+        {
+            // Inverse of the horizontal block of the jacobian
+            double c = std::cos(projection.convergence);
+            double s = std::sin(projection.convergence);
+            Eigen::Matrix2d inverse;
+            inverse << c, s,
+                      -s, c;
+            inverse /= projection.scale;
+            Eigen::Matrix2d local =
+                inverse * utm.cov_position.topLeftCorner<2, 2>() * inverse.transpose();
+
+            gps_base::Solution solution;
+            solution.time = utm.time;
+            solution.latitude = geodetic.latitude;
+            solution.longitude = geodetic.longitude;
+            solution.deviationLongitude = std::sqrt(local(0, 0));
+            solution.deviationLatitude = std::sqrt(local(1, 1));
+            solution.deviationAltitude = std::sqrt(utm.cov_position(2, 2));
+            if (orientation)
+            {
+                *orientation = base::Orientation(Eigen::AngleAxisd(
+                    -projection.convergence, Eigen::Vector3d::UnitZ())) * utm.orientation;
+            }
+            return solution;
+        }
+
+        /** Height of a point in the given reference
+         *
+         * See UTMConverter::setGeoidModel for the rules
+         *
+         * @param modelSeparation the geoid model's separation, ignored if
+         *   there is no model
+         */
+        inline double computeHeight(HEIGHT_REFERENCE reference, bool hasModel,
+                                    double altitude, double separation,
+                                    double modelSeparation)
+        {
+            if (!hasModel)
+            {
+                if (reference == HEIGHT_ORTHOMETRIC)
+                    return altitude;
+                return altitude + separation;
+            }
+
+            if (std::isnan(separation))
+                separation = modelSeparation;
+            double ellipsoidal = altitude + separation;
+            if (reference == HEIGHT_ORTHOMETRIC)
+                return ellipsoidal - modelSeparation;
+            return ellipsoidal;
+        }
+
+        /** Height of a solution in the given reference */
+        inline double toOutputHeight(HEIGHT_REFERENCE reference, GeoidModel const* geoid,
+                                     gps_base::Solution const& solution)
+        {
+            double modelSeparation = 0;
+            if (geoid)
+                modelSeparation = geoid->getSeparation(solution.latitude, solution.longitude);
+            return computeHeight(reference, geoid, solution.altitude,
+                                 solution.geoidalSeparation, modelSeparation);
+        }
+
+        /** Set the altitude and geoidal separation of a solution, whose
+         * latitude and longitude are already set, from a height in the
+         * given reference
+         */
+        inline void fromOutputHeight(HEIGHT_REFERENCE reference, GeoidModel const* geoid,
+                                     gps_base::Solution& solution, double height)
+        {
+            if (geoid)
+            {
+                solution.geoidalSeparation =
+                    geoid->getSeparation(solution.latitude, solution.longitude);
+                if (reference == HEIGHT_ELLIPSOIDAL)
+                    height -= solution.geoidalSeparation;
+            }
+            else if (reference == HEIGHT_ELLIPSOIDAL)
+                solution.geoidalSeparation = 0;
+            solution.altitude = height;
+        }
+
+        /** Array version of toOutputHeight
+         *
+         * @a heights may not overlap the input arrays
+         */
+        inline void convertHeights(HEIGHT_REFERENCE reference, GeoidModel const* geoid,
+                                   std::size_t count,
+                                   double const* latitudes,
+                                   double const* longitudes,
+                                   double const* altitudes,
+                                   double const* separations,
+                                   double* heights)
+        {
+            if (geoid)
+                geoid->getSeparations(count, latitudes, longitudes, heights);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                heights[i] = computeHeight(reference, geoid, altitudes[i], separations[i],
+                                           geoid ? heights[i] : 0);
+            }
+        }
+
+        /** Largest absolute value that a float stores with an error of at
+         * most @a tolerance
+         *
+         * A float has a 24 bits significand, i.e. the rounding error of
+         * values below 2^n is at most 2^(n - 25)
+         */
+        inline double getFloatRange(double tolerance)
+        {
+            return std::ldexp(tolerance, 24);
+        }
+
+        /** Store coordinates as interleaved floats, relative to an anchor
+         *
+         * @param index index of the first point in the whole conversion,
+         *   used to fill FloatConversionReport::firstOutOfRange
+         * @param xyz output array of 3 * count floats
+         */
+        inline void packFloats(std::size_t count, std::size_t index,
+                               double const* x, double const* y, double const* z,
+                               base::Position const& anchor,
+                               float* xyz, FloatConversionReport& report)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                double relative[3] = { x[i] - anchor.x(), y[i] - anchor.y(), z[i] - anchor.z() };
+                bool valid = true;
+                double max = 0;
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    xyz[3 * i + axis] = static_cast<float>(relative[axis]);
+                    valid = valid && std::isfinite(relative[axis]);
+                    max = std::max(max, std::abs(relative[axis]));
+                }
+
+                if (!valid)
+                {
+                    // Invalidate the whole point, whichever axes are unset
+                    for (int axis = 0; axis < 3; ++axis)
+                        xyz[3 * i + axis] = std::numeric_limits<float>::quiet_NaN();
+                    report.invalid++;
+                    continue;
+                }
+                report.maxCoordinate = std::max(report.maxCoordinate, max);
+                if (max > report.range && report.outOfRange++ == 0)
+                    report.firstOutOfRange = index + i;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef GPS_BASE_VARINT_HPP
+#define GPS_BASE_VARINT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace gps_base {
+    /** Helpers for the compact binary formats
+     *
+     * Integers are stored as LEB128 varints, with signed values zigzag
+     * encoded first. Fixed-size values are stored little-endian.
+     */
+    namespace varint {
+        static const int MAX_SIZE = 10;
+
+        inline std::uint64_t zigzag(std::int64_t value)
+        {
+            return (static_cast<std::uint64_t>(value) << 1) ^
+                   static_cast<std::uint64_t>(value >> 63);
+        }
+
+        inline std::int64_t unzigzag(std::uint64_t value)
+        {
+            return static_cast<std::int64_t>(value >> 1) ^
+                   -static_cast<std::int64_t>(value & 1);
+        }
+
+        /** Append a varint to a string */
+        inline void write(std::string& out, std::uint64_t value)
+        {
+            while (value >= 0x80) {
+                out.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        inline void writeSigned(std::string& out, std::int64_t value)
+        {
+            write(out, zigzag(value));
+        }
+
+        /** Read a varint, advancing @a cursor
+         *
+         * @throw std::runtime_error if the varint does not end before @a end
+         */
+        inline std::uint64_t read(std::uint8_t const*& cursor, std::uint8_t const* end)
+        {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 7 * MAX_SIZE; shift += 7) {
+                if (cursor == end) {
+                    break;
+                }
+                std::uint8_t byte = *cursor++;
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+            throw std::runtime_error("truncated or invalid varint");
+        }
+
+        inline std::int64_t readSigned(std::uint8_t const*& cursor, std::uint8_t const* end)
+        {
+            return unzigzag(read(cursor, end));
+        }
+
+        template<typename T>
+        void writeFixed(std::string& out, T value)
+        {
+            std::uint8_t bytes[sizeof(T)];
+            std::memcpy(bytes, &value, sizeof(T));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            for (std::size_t i = 0; i < sizeof(T) / 2; ++i) {
+                std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+            }
+#endif
+            out.append(reinterpret_cast<char const*>(bytes), sizeof(T));
+        }
+
+        template<typename T>
+        T readFixed(std::uint8_t const*& cursor, std::uint8_t const* end)
+        {
+            if (static_cast<std::size_t>(end - cursor) < sizeof(T)) {
+                throw std::runtime_error("unexpected end of data");
+            }
+            std::uint8_t bytes[sizeof(T)];
+            std::memcpy(bytes, cursor, sizeof(T));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            for (std::size_t i = 0; i < sizeof(T) / 2; ++i) {
+                std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+            }
+#endif
+            cursor += sizeof(T);
+            T value;
+            std::memcpy(&value, bytes, sizeof(T));
+            return value;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include <gps_base/demux.hpp>
+
+#include <gps_base/rtcm3.hpp>
+#include <gps_base/sbf.hpp>
+#include <gps_base/ubx.hpp>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    struct ProtocolTable {
+        demux::Protocol protocols[256];
+
+        ProtocolTable() {
+            for (auto& p : protocols) {
+                p = demux::PROTOCOL_NONE;
+            }
+            protocols[rtcm3::PREAMBLE] = demux::PROTOCOL_RTCM3;
+            protocols[ubx::SYNC_1] = demux::PROTOCOL_UBX;
+            protocols[sbf::SYNC_1] = demux::PROTOCOL_SBF;
+        }
+    };
+
+    const ProtocolTable PROTOCOL_TABLE;
+}
+
+demux::Protocol demux::getProtocol(uint8_t byte) {
+    return PROTOCOL_TABLE.protocols[byte];
+}
+
+size_t demux::findFrameStart(uint8_t const* buffer, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        if (PROTOCOL_TABLE.protocols[buffer[i]] != PROTOCOL_NONE) {
+            return i;
+        }
+    }
+    return size;
+}
+
+static int extractProtocolPacket(demux::Protocol protocol,
+                                 uint8_t const* buffer, size_t size) {
+    switch (protocol) {
+        case demux::PROTOCOL_RTCM3:
+            return rtcm3::extractPacket(buffer, size);
+        case demux::PROTOCOL_UBX:
+            return ubx::extractPacket(buffer, size);
+        case demux::PROTOCOL_SBF:
+            return sbf::extractPacket(buffer, size);
+        default:
+            return -1;
+    }
+}
+
+int demux::extractPacket(uint8_t const* buffer, size_t size, Protocol* protocol) {
+    if (!size) {
+        return 0;
+    }
+
+    Protocol candidate = getProtocol(buffer[0]);
+    int result = extractProtocolPacket(candidate, buffer, size);
+    if (result > 0) {
+        if (protocol) {
+            *protocol = candidate;
+        }
+        return result;
+    }
+    else if (result == 0) {
+        return 0;
+    }
+
+    return -static_cast<int>(1 + findFrameStart(buffer + 1, size - 1));
+}
+
+size_t demux::demultiplex(uint8_t const* buffer, size_t size,
+                          vector<Frame>& frames) {
+    size_t offset = 0;
+    while (offset < size) {
+        Protocol protocol = PROTOCOL_NONE;
+        int result = extractPacket(buffer + offset, size - offset, &protocol);
+        if (result == 0) {
+            break;
+        }
+        else if (result < 0) {
+            offset += -result;
+        }
+        else {
+            frames.push_back(Frame { protocol, offset, static_cast<size_t>(result) });
+            offset += result;
+        }
+    }
+    return offset;
+}
@@ -0,0 +1,71 @@
+#ifndef GPS_BASE_DEMUX_HPP
+#define GPS_BASE_DEMUX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gps_base {
+    /** Extraction of RTCM3, UBX and SBF frames from a single byte stream
+     *
+     * Receivers commonly interleave several binary protocols on the same
+     * port. The functions in this namespace dispatch on the first byte of
+     * the buffer to the protocol-specific extractor (rtcm3, ubx, sbf), and
+     * skip over bytes that cannot start a frame in one go instead of
+     * re-trying at every offset.
+     */
+    namespace demux {
+        enum Protocol {
+            PROTOCOL_NONE,
+            PROTOCOL_RTCM3,
+            PROTOCOL_UBX,
+            PROTOCOL_SBF
+        };
+
+        /** A frame found by demultiplex() */
+        struct Frame {
+            Protocol protocol;
+            /** Offset of the frame's first byte in the demultiplexed buffer */
+            std::size_t offset;
+            /** Frame size, including headers and checksums */
+            std::size_t size;
+        };
+
+        /** The protocol whose frames may start with the given byte
+         *
+         * Returns PROTOCOL_NONE if the byte cannot start a frame
+         */
+        Protocol getProtocol(std::uint8_t byte);
+
+        /** Offset of the first byte in the buffer that may start a frame
+         *
+         * Returns @a size if there are none
+         */
+        std::size_t findFrameStart(std::uint8_t const* buffer, std::size_t size);
+
+        /** Packet extraction with the iodrivers_base::Driver contract
+         *
+         * Returns a negative value to skip bytes, 0 if more data is needed
+         * and the frame size if one is available at the start of the buffer.
+         * When rejecting bytes, it skips up to the next possible frame start.
+         *
+         * @param protocol if non-null, set to the protocol of the extracted
+         *   frame when the return value is positive
+         */
+        int extractPacket(std::uint8_t const* buffer, std::size_t size,
+                          Protocol* protocol = nullptr);
+
+        /** Sort a buffer into protocol-tagged frames in a single pass
+         *
+         * Found frames are appended to @a frames
+         *
+         * @return the number of bytes that have been consumed. The remaining
+         *   bytes are the start of an incomplete frame, and should be
+         *   presented again once more data is available
+         */
+        std::size_t demultiplex(std::uint8_t const* buffer, std::size_t size,
+                                std::vector<Frame>& frames);
+    }
+}
+
+#endif
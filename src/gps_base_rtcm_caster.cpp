@@ -0,0 +1,134 @@
+#include <gps_base/RTCMCaster.hpp>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    void usage(ostream& io) {
+        io << "usage: gps_base_rtcm_caster [OPTIONS]\n"
+           << "\n"
+           << "Reads an RTCM 3 stream from the standard input, and serves its\n"
+           << "frames to the TCP clients connected to it. Statistics are written\n"
+           << "on the standard error.\n"
+           << "\n"
+           << "Options:\n"
+           << "  --address ADDRESS        address to listen on (default: 0.0.0.0)\n"
+           << "  --port PORT              port to listen on (default: 2101)\n"
+           << "  --reactors COUNT         number of reactor threads (default: 1)\n"
+           << "  --max-queued BYTES       maximum number of bytes queued per client\n"
+           << "                           before frames are dropped (default: 65536)\n"
+           << "  --backlog COUNT          backlog of the listening socket\n"
+           << "  --report SECONDS         period of the statistics report (default: 10)\n"
+           << flush;
+    }
+
+    unsigned long parseUnsigned(string const& value) {
+        char* end;
+        unsigned long result = strtoul(value.c_str(), &end, 10);
+        if (value.empty() || value[0] == '-' || *end != '\0') {
+            throw invalid_argument("invalid count '" + value + "'");
+        }
+        return result;
+    }
+
+    void report(ostream& io, RTCMCasterStatistics const& statistics) {
+        io << statistics.clients << " clients ("
+           << statistics.acceptedClients << " accepted, "
+           << statistics.disconnectedClients << " disconnected, "
+           << statistics.rejectedClients << " rejected), "
+           << statistics.frames << " frames, "
+           << statistics.sentBytes << " bytes sent, "
+           << statistics.droppedFrames << " frames dropped" << endl;
+    }
+
+    int run(int argc, char** argv) {
+        RTCMCasterConfiguration configuration;
+        unsigned long reportPeriod = 10;
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg == "-h" || arg == "--help") {
+                usage(cout);
+                return 0;
+            }
+            else if (i + 1 == argc) {
+                usage(cerr);
+                return 1;
+            }
+
+            string value = argv[++i];
+            if (arg == "--address") {
+                configuration.address = value;
+            }
+            else if (arg == "--port") {
+                unsigned long port = parseUnsigned(value);
+                if (port > 65535) {
+                    throw invalid_argument("invalid port '" + value + "'");
+                }
+                configuration.port = port;
+            }
+            else if (arg == "--reactors") {
+                configuration.reactors = parseUnsigned(value);
+            }
+            else if (arg == "--max-queued") {
+                configuration.maxQueuedBytes = parseUnsigned(value);
+            }
+            else if (arg == "--backlog") {
+                configuration.backlog = parseUnsigned(value);
+            }
+            else if (arg == "--report") {
+                reportPeriod = parseUnsigned(value);
+            }
+            else {
+                throw invalid_argument("unknown option " + arg);
+            }
+        }
+
+        RTCMCaster caster(configuration);
+        cerr << "listening on " << configuration.address << ":"
+             << caster.getPort() << endl;
+
+        auto lastReport = chrono::steady_clock::now();
+        uint8_t buffer[4096];
+        while (true) {
+            ssize_t size = ::read(0, buffer, sizeof(buffer));
+            if (size < 0 && errno == EINTR) {
+                continue;
+            }
+            else if (size < 0) {
+                throw runtime_error(string("cannot read the input: ") + strerror(errno));
+            }
+            else if (size == 0) {
+                break;
+            }
+
+            caster.push(buffer, size);
+            auto now = chrono::steady_clock::now();
+            if (reportPeriod && now - lastReport >= chrono::seconds(reportPeriod)) {
+                report(cerr, caster.getStatistics());
+                lastReport = now;
+            }
+        }
+
+        caster.stop();
+        report(cerr, caster.getStatistics());
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        return run(argc, argv);
+    }
+    catch(exception const& e) {
+        cerr << "gps_base_rtcm_caster: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,245 @@
+#include <gps_base/GeoidModel.hpp>
+#include <gps_base/TrajectoryPipeline.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    void usage(ostream& io) {
+        io << "usage: gps_base_trajectory [OPTIONS] LOG ZONE N|S [OUTPUT]\n"
+           << "\n"
+           << "Converts a solution log into a CSV trajectory in the NWU frame,\n"
+           << "written to OUTPUT or to the standard output. The columns are\n"
+           << "time (microseconds), x, y, z, sigma_x, sigma_y, sigma_z and\n"
+           << "position_type. Per-stage statistics are written on the\n"
+           << "standard error.\n"
+           << "\n"
+           << "Options:\n"
+           << "  --types TYPE[,TYPE...]   accepted position types, among\n"
+           << "                           AUTONOMOUS, AUTONOMOUS_2D, DIFFERENTIAL,\n"
+           << "                           RTK_FIXED and RTK_FLOAT (default: all)\n"
+           << "  --max-age SECONDS        maximum age of the differential corrections\n"
+           << "  --max-horizontal-deviation METERS\n"
+           << "  --max-vertical-deviation METERS\n"
+           << "  --period SECONDS         minimum time between two output points\n"
+           << "  --distance METERS        minimum distance between two output points\n"
+           << "  --origin X,Y,Z           NWU origin, in UTM coordinates\n"
+           << "  --height REFERENCE       ORTHOMETRIC (default) or ELLIPSOIDAL\n"
+           << "  --geoid FILE             geoid grid in GeographicLib's PGM format\n"
+           << "  --threads COUNT          number of worker threads (default: one per core)\n"
+           << "  --max-chunks COUNT       maximum number of chunks in flight\n"
+           << flush;
+    }
+
+    vector<string> split(string const& value, char separator) {
+        vector<string> result;
+        string element;
+        istringstream stream(value);
+        while (getline(stream, element, separator)) {
+            result.push_back(element);
+        }
+        return result;
+    }
+
+    double parseDouble(string const& value) {
+        char* end;
+        double result = strtod(value.c_str(), &end);
+        if (value.empty() || *end != '\0') {
+            throw invalid_argument("invalid number '" + value + "'");
+        }
+        return result;
+    }
+
+    unsigned long parseUnsigned(string const& value) {
+        char* end;
+        unsigned long result = strtoul(value.c_str(), &end, 10);
+        if (value.empty() || value[0] == '-' || *end != '\0') {
+            throw invalid_argument("invalid count '" + value + "'");
+        }
+        return result;
+    }
+
+    unsigned int parsePositionTypes(string const& value) {
+        static const pair<char const*, GPS_SOLUTION_TYPES> names[] = {
+            { "AUTONOMOUS", AUTONOMOUS },
+            { "AUTONOMOUS_2D", AUTONOMOUS_2D },
+            { "DIFFERENTIAL", DIFFERENTIAL },
+            { "RTK_FIXED", RTK_FIXED },
+            { "RTK_FLOAT", RTK_FLOAT }
+        };
+
+        unsigned int result = 0;
+        for (auto const& name : split(value, ',')) {
+            bool found = false;
+            for (auto const& known : names) {
+                if (name == known.first) {
+                    result |= TrajectoryFilter::positionTypeBit(known.second);
+                    found = true;
+                }
+            }
+            if (!found) {
+                throw invalid_argument("unknown position type '" + name + "'");
+            }
+        }
+        return result;
+    }
+
+    void writeCSV(ostream& io, TrajectoryColumns const& columns) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            io << columns.time[i].toMicroseconds() << ","
+               << columns.x[i] << ","
+               << columns.y[i] << ","
+               << columns.z[i] << ","
+               << columns.deviationX[i] << ","
+               << columns.deviationY[i] << ","
+               << columns.deviationZ[i] << ","
+               << static_cast<int>(columns.positionType[i]) << "\n";
+        }
+    }
+
+    void report(ostream& io, string const& name, TrajectoryStageStatistics const& stage) {
+        io << setw(10) << left << name << right
+           << setw(12) << stage.input << " in "
+           << setw(12) << stage.output << " out "
+           << setw(10) << fixed << setprecision(3) << stage.time.toSeconds() << " s "
+           << setw(14) << setprecision(0) << stage.getThroughput() << " solutions/s\n";
+    }
+
+    int run(int argc, char** argv) {
+        TrajectoryPipelineConfiguration configuration;
+        UTMConversionParameters parameters;
+        shared_ptr<GeoidModel const> geoid;
+        vector<string> arguments;
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg == "-h" || arg == "--help") {
+                usage(cout);
+                return 0;
+            }
+            else if (arg.compare(0, 2, "--") != 0) {
+                arguments.push_back(arg);
+                continue;
+            }
+
+            if (i + 1 == argc) {
+                throw invalid_argument("missing value for " + arg);
+            }
+            string value = argv[++i];
+            if (arg == "--types") {
+                configuration.filter.positionTypes = parsePositionTypes(value);
+            }
+            else if (arg == "--max-age") {
+                configuration.filter.maxCorrectionAge = parseDouble(value);
+            }
+            else if (arg == "--max-horizontal-deviation") {
+                configuration.filter.maxHorizontalDeviation = parseDouble(value);
+            }
+            else if (arg == "--max-vertical-deviation") {
+                configuration.filter.maxVerticalDeviation = parseDouble(value);
+            }
+            else if (arg == "--period") {
+                configuration.decimation.minPeriod = base::Time::fromSeconds(parseDouble(value));
+            }
+            else if (arg == "--distance") {
+                configuration.decimation.minDistance = parseDouble(value);
+            }
+            else if (arg == "--origin") {
+                auto elements = split(value, ',');
+                if (elements.size() != 3) {
+                    throw invalid_argument("expected X,Y,Z for --origin");
+                }
+                parameters.nwu_origin = base::Position(
+                    parseDouble(elements[0]), parseDouble(elements[1]),
+                    parseDouble(elements[2]));
+            }
+            else if (arg == "--height") {
+                if (value == "ORTHOMETRIC") {
+                    parameters.height_reference = HEIGHT_ORTHOMETRIC;
+                }
+                else if (value == "ELLIPSOIDAL") {
+                    parameters.height_reference = HEIGHT_ELLIPSOIDAL;
+                }
+                else {
+                    throw invalid_argument("unknown height reference '" + value + "'");
+                }
+            }
+            else if (arg == "--geoid") {
+                geoid = make_shared<GeoidModel>(value);
+            }
+            else if (arg == "--threads") {
+                configuration.threads = parseUnsigned(value);
+            }
+            else if (arg == "--max-chunks") {
+                configuration.maxChunksInFlight = parseUnsigned(value);
+            }
+            else {
+                throw invalid_argument("unknown option " + arg);
+            }
+        }
+
+        if (arguments.size() != 3 && arguments.size() != 4) {
+            usage(cerr);
+            return 1;
+        }
+        parameters.utm_zone = parseUnsigned(arguments[1]);
+        if (arguments[2] == "N") {
+            parameters.utm_north = true;
+        }
+        else if (arguments[2] == "S") {
+            parameters.utm_north = false;
+        }
+        else {
+            throw invalid_argument("expected N or S as hemisphere");
+        }
+
+        ofstream file;
+        if (arguments.size() == 4) {
+            file.open(arguments[3]);
+            if (!file) {
+                throw runtime_error("cannot open " + arguments[3]);
+            }
+        }
+        ostream& output = file.is_open() ? file : cout;
+        output << setprecision(12);
+        output << "time,x,y,z,sigma_x,sigma_y,sigma_z,position_type\n";
+
+        SolutionLogReader log(arguments[0]);
+        UTMConverter converter(parameters);
+        converter.setGeoidModel(geoid);
+        TrajectoryPipeline pipeline(converter, configuration);
+        auto statistics = pipeline.run(log, [&output](TrajectoryColumns const& columns) {
+            writeCSV(output, columns);
+        });
+        output.flush();
+        if (!output) {
+            throw runtime_error("failed to write the output");
+        }
+
+        cerr << statistics.chunks << " chunks in "
+             << statistics.time.toSeconds() << " s\n";
+        report(cerr, "decode", statistics.decode);
+        report(cerr, "filter", statistics.filter);
+        report(cerr, "convert", statistics.convert);
+        report(cerr, "decimate", statistics.decimate);
+        report(cerr, "output", statistics.output);
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        return run(argc, argv);
+    }
+    catch(exception const& e) {
+        cerr << "gps_base_trajectory: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef GPS_BASE_SBF_HPP
+#define GPS_BASE_SBF_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gps_base {
+    /** Implementation of Septentrio Binary Format (SBF) packet extraction
+     *
+     * SBF blocks are protected by a CRC-16 (CCITT) that covers the block from
+     * the block ID to the end of the block
+     */
+    namespace sbf {
+        static const std::uint8_t SYNC_1 = 0x24;
+        static const std::uint8_t SYNC_2 = 0x40;
+        static const int SYNC_SIZE = 2;
+        static const int CRC_SIZE = 2;
+        static const int HEADER_SIZE = 8;
+        static const int MIN_PACKET_SIZE = HEADER_SIZE;
+
+        /** Whether the buffer starts with the SBF sync sequence
+         *
+         * If the buffer holds only one byte, only the first sync byte is
+         * checked
+         */
+        bool isPreamble(std::uint8_t const* buffer, std::size_t size);
+        /** The block length
+         *
+         * Unlike UBX and RTCM, SBF's length field is the length of the
+         * whole block, including the header
+         */
+        std::uint16_t getLength(std::uint8_t const* buffer, std::size_t size);
+        /** CRC-16 of the given bytes
+         *
+         * @a packetStart must point to the block ID, i.e. just after the
+         * CRC field
+         */
+        std::uint16_t crc(std::uint8_t const* packetStart, std::size_t size);
+        int extractPacket(std::uint8_t const* buffer, std::size_t size);
+    }
+}
+
+#endif
@@ -0,0 +1,64 @@
+#include <gps_base/ubx.hpp>
+
+#include <stdexcept>
+
+using namespace gps_base;
+using namespace std;
+
+int ubx::extractPacket(uint8_t const* buffer, size_t size) {
+    if (!size) {
+        return 0;
+    }
+    else if (!isPreamble(buffer, size)) {
+        return -1;
+    }
+    else if (size < MIN_PACKET_SIZE) {
+        return 0;
+    }
+
+    size_t length = getLength(buffer, size);
+    if (size < length + MIN_PACKET_SIZE) {
+        return 0;
+    }
+
+    uint16_t expectedChecksum =
+        checksum(buffer + SYNC_SIZE, length + HEADER_SIZE - SYNC_SIZE);
+    uint8_t const* bufferChecksum = buffer + length + HEADER_SIZE;
+    uint16_t actualChecksum =
+        static_cast<uint16_t>(bufferChecksum[1]) << 8 |
+        static_cast<uint16_t>(bufferChecksum[0]) << 0;
+
+    if (expectedChecksum != actualChecksum) {
+        return -1;
+    }
+
+    return length + HEADER_SIZE + CHECKSUM_SIZE;
+}
+
+bool ubx::isPreamble(uint8_t const* buffer, size_t size) {
+    if (size < 1) {
+        throw std::length_error(
+            "ubx::isPreamble called with a buffer of zero size"
+        );
+    }
+    return buffer[0] == ubx::SYNC_1 && (size < 2 || buffer[1] == ubx::SYNC_2);
+}
+
+uint16_t ubx::getLength(uint8_t const* buffer, size_t size) {
+    if (size < HEADER_SIZE) {
+        throw std::length_error(
+            "ubx::getLength called with a buffer of size smaller than 6"
+        );
+    }
+    return static_cast<uint16_t>(buffer[5]) << 8 | buffer[4];
+}
+
+uint16_t ubx::checksum(uint8_t const* buffer, size_t size) {
+    uint8_t a = 0;
+    uint8_t b = 0;
+    for (size_t i = 0; i < size; ++i) {
+        a += buffer[i];
+        b += a;
+    }
+    return static_cast<uint16_t>(b) << 8 | a;
+}
@@ -0,0 +1,40 @@
+#ifndef GPS_BASE_UBX_HPP
+#define GPS_BASE_UBX_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gps_base {
+    /** Implementation of u-blox UBX packet extraction
+     *
+     * UBX is u-blox' binary protocol. Frames are protected by a 8-bit
+     * Fletcher checksum
+     */
+    namespace ubx {
+        static const std::uint8_t SYNC_1 = 0xB5;
+        static const std::uint8_t SYNC_2 = 0x62;
+        static const int SYNC_SIZE = 2;
+        static const int HEADER_SIZE = 6;
+        static const int CHECKSUM_SIZE = 2;
+        static const int MIN_PACKET_SIZE = HEADER_SIZE + CHECKSUM_SIZE;
+
+        /** Whether the buffer starts with the UBX sync sequence
+         *
+         * If the buffer holds only one byte, only the first sync byte is
+         * checked
+         */
+        bool isPreamble(std::uint8_t const* buffer, std::size_t size);
+        /** The payload length, that is without header and checksum */
+        std::uint16_t getLength(std::uint8_t const* buffer, std::size_t size);
+        /** Fletcher checksum of the given bytes
+         *
+         * The first checksum byte (CK_A) is returned in the LSB, the second
+         * (CK_B) in the MSB. @a packetStart must point to the message class,
+         * i.e. just after the sync sequence.
+         */
+        std::uint16_t checksum(std::uint8_t const* packetStart, std::size_t size);
+        int extractPacket(std::uint8_t const* buffer, std::size_t size);
+    }
+}
+
+#endif
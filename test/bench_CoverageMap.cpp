@@ -0,0 +1,82 @@
+#include <gps_base/CoverageMap.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <unistd.h>
+
+using namespace gps_base;
+using namespace std;
+
+/** Measures how CoverageAggregator scales with the number of threads, on a
+ * solution log of random fixes
+ *
+ * Usage: bench_CoverageMap [SOLUTION_COUNT], defaults to 5M solutions
+ */
+
+int main(int argc, char** argv) {
+    size_t count = 5000000;
+    if (argc > 1) {
+        count = strtoul(argv[1], nullptr, 10);
+    }
+
+    char path[] = "/tmp/gps_base_bench_CoverageMap_XXXXXX";
+    int fd = mkstemp(path);
+    ::close(fd);
+
+    // A random walk over roughly 20x20km in UTM zone 22S
+    mt19937 rng(42);
+    normal_distribution<double> step(0, 1e-5);
+    uniform_int_distribution<int> type(0, 9);
+    {
+        SolutionLogWriter writer(path);
+        Solution solution;
+        solution.latitude = -27.5;
+        solution.longitude = -48.5;
+        solution.altitude = 10;
+        solution.geoidalSeparation = 0;
+        solution.deviationLatitude = 0.02;
+        solution.deviationLongitude = 0.02;
+        solution.deviationAltitude = 0.05;
+        for (size_t i = 0; i < count; ++i) {
+            solution.time = base::Time::fromMicroseconds(i * 100000);
+            solution.latitude = min(-27.4, max(-27.6, solution.latitude + step(rng)));
+            solution.longitude = min(-48.4, max(-48.6, solution.longitude + step(rng)));
+            int t = type(rng);
+            solution.positionType = t < 7 ? RTK_FIXED : t < 9 ? RTK_FLOAT : AUTONOMOUS;
+            solution.noOfSatellites = 8 + t;
+            solution.ageOfDifferentialCorrections = t * 0.3;
+            writer.write(solution);
+        }
+    }
+
+    UTMConversionParameters parameters;
+    parameters.utm_zone = 22;
+    parameters.utm_north = false;
+    UTMConverter converter(parameters);
+    SolutionLogReader log(path);
+
+    unsigned int maxThreads = max(1u, thread::hardware_concurrency());
+    for (auto scheme : { COVERAGE_CELLS_UTM, COVERAGE_CELLS_GEODETIC }) {
+        CoverageAggregatorConfiguration configuration;
+        configuration.scheme = scheme;
+        configuration.cellSize = scheme == COVERAGE_CELLS_UTM ? 10 : 1e-4;
+        cout << (scheme == COVERAGE_CELLS_UTM ? "UTM" : "geodetic") << " cells" << endl;
+        for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+            configuration.threads = threads;
+            CoverageAggregator aggregator(converter, configuration);
+            auto statistics = aggregator.add(log);
+            double seconds = statistics.time.toSeconds();
+            cout << "  " << threads << " threads: " << seconds << " s, "
+                 << statistics.solutions / seconds / 1e6 << " M solutions/s, "
+                 << aggregator.getMap().size() << " cells, "
+                 << statistics.merges << " merges, "
+                 << aggregator.getMap().encode().size() << " bytes encoded" << endl;
+        }
+    }
+
+    remove(path);
+    return 0;
+}
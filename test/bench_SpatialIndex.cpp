@@ -0,0 +1,138 @@
+#include <gps_base/SpatialIndex.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+
+using namespace gps_base;
+using namespace std;
+
+/** Measures the build, insertion and query costs of SpatialIndex, and
+ * compares the queries against a linear scan
+ *
+ * Usage: bench_SpatialIndex [POINT_COUNT], defaults to 10M points
+ */
+
+namespace {
+    typedef chrono::steady_clock Clock;
+
+    double elapsed(Clock::time_point start) {
+        return chrono::duration<double>(Clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t count = 10000000;
+    if (argc > 1) {
+        count = strtoul(argv[1], nullptr, 10);
+    }
+    size_t const queryCount = 100000;
+    size_t const linearQueryCount = 20;
+
+    // Uniformly spread over roughly 50x50km in UTM zone 22S
+    mt19937 rng(42);
+    uniform_real_distribution<double> offset(-0.25, 0.25);
+    vector<double> latitudes(count);
+    vector<double> longitudes(count);
+    for (size_t i = 0; i < count; ++i) {
+        latitudes[i] = -27.5 + offset(rng);
+        longitudes[i] = -48.5 + offset(rng);
+    }
+
+    UTMConversionParameters parameters;
+    parameters.utm_zone = 22;
+    parameters.utm_north = false;
+    UTMConverter converter(parameters);
+    SpatialIndex index(converter);
+
+    auto start = Clock::now();
+    index.build(count, latitudes.data(), longitudes.data());
+    cout << "bulk build of " << count << " points: " << elapsed(start) << " s" << endl;
+
+    vector<Solution> queries(queryCount);
+    for (auto& query : queries) {
+        query.positionType = AUTONOMOUS;
+        query.latitude = -27.5 + offset(rng);
+        query.longitude = -48.5 + offset(rng);
+        query.altitude = 0;
+    }
+    vector<base::Position> nwuQueries;
+    for (auto const& query : queries) {
+        nwuQueries.push_back(converter.convertToNWU(query).position);
+    }
+
+    start = Clock::now();
+    size_t checksum = 0;
+    for (auto const& query : nwuQueries) {
+        checksum += index.nearest(query, 10).front().index;
+    }
+    double t = elapsed(start);
+    cout << "10-nearest: " << t / queryCount * 1e6 << " us/query"
+         << " (checksum " << checksum << ")" << endl;
+
+    start = Clock::now();
+    size_t found = 0;
+    for (auto const& query : nwuQueries) {
+        found += index.radius(query, 25).size();
+    }
+    t = elapsed(start);
+    cout << "25m radius: " << t / queryCount * 1e6 << " us/query, "
+         << static_cast<double>(found) / queryCount << " matches/query" << endl;
+
+    start = Clock::now();
+    for (auto const& query : queries) {
+        checksum += index.nearest(query, 1).front().index;
+    }
+    t = elapsed(start);
+    cout << "nearest, including the query conversion: "
+         << t / queryCount * 1e6 << " us/query" << endl;
+
+    // Linear scan, i.e. the approach this index replaces
+    vector<base::Position> nwu(count);
+    {
+        vector<double> altitudes(count, 0), eastings(count), northings(count), heights(count);
+        converter.convertToUTM(count, latitudes.data(), longitudes.data(), altitudes.data(),
+                               eastings.data(), northings.data(), heights.data());
+        base::Position origin = converter.getNWUOrigin();
+        for (size_t i = 0; i < count; ++i) {
+            nwu[i] = base::Position(northings[i], 1000000 - eastings[i], 0) - origin;
+        }
+    }
+    start = Clock::now();
+    for (size_t q = 0; q < linearQueryCount; ++q) {
+        double best = numeric_limits<double>::infinity();
+        size_t bestIndex = 0;
+        for (size_t i = 0; i < count; ++i) {
+            double d = (nwu[i] - nwuQueries[q]).head<2>().squaredNorm();
+            if (d < best) {
+                best = d;
+                bestIndex = i;
+            }
+        }
+        if (bestIndex != index.nearest(nwuQueries[q], 1).front().index) {
+            cerr << "mismatch between the linear scan and the index" << endl;
+            return 1;
+        }
+    }
+    t = elapsed(start);
+    cout << "nearest, linear scan: " << t / linearQueryCount * 1e6 << " us/query" << endl;
+
+    SpatialIndex incremental(converter);
+    start = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        incremental.insert(nwu[i]);
+    }
+    t = elapsed(start);
+    cout << "incremental insertion: " << t / count * 1e9 << " ns/point, "
+         << incremental.getTreeCount() << " trees" << endl;
+
+    start = Clock::now();
+    for (auto const& query : nwuQueries) {
+        checksum += incremental.nearest(query, 10).front().index;
+    }
+    t = elapsed(start);
+    cout << "10-nearest after incremental insertion: "
+         << t / queryCount * 1e6 << " us/query" << endl;
+    return 0;
+}
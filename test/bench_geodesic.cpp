@@ -0,0 +1,100 @@
+#include <gps_base/Geodesic.hpp>
+#include <gps_base/UTMConverter.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace gps_base;
+using namespace std;
+
+/** Compares the geodesic distance kernels against the historical approach
+ * of converting both points with UTMConverter and taking the euclidean
+ * norm of the difference
+ */
+
+namespace {
+    typedef chrono::steady_clock Clock;
+
+    void report(string const& name, size_t count, Clock::duration duration,
+                double checksum) {
+        double seconds = chrono::duration<double>(duration).count();
+        cout << name << ": " << seconds * 1e9 / count << " ns/distance"
+             << " (checksum " << checksum << ")" << endl;
+    }
+
+    double sum(vector<double> const& values) {
+        double result = 0;
+        for (double v : values) {
+            result += v;
+        }
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t count = 1000000;
+    if (argc > 1) {
+        count = strtoul(argv[1], nullptr, 10);
+    }
+
+    // A random walk in UTM zone 22S, with steps of up to 100m
+    mt19937 rng(42);
+    uniform_real_distribution<double> step(-1e-3, 1e-3);
+    vector<Solution> trajectory(count);
+    double latitude = -27.5;
+    double longitude = -48.5;
+    for (auto& solution : trajectory) {
+        solution.positionType = AUTONOMOUS;
+        solution.latitude = latitude += step(rng);
+        solution.longitude = longitude += step(rng);
+        solution.altitude = 0;
+    }
+
+    UTMConversionParameters parameters;
+    parameters.utm_zone = 22;
+    parameters.utm_north = false;
+    UTMConverter converter(parameters);
+
+    {
+        auto start = Clock::now();
+        double checksum = 0;
+        for (size_t i = 1; i < count; ++i) {
+            auto p0 = converter.convertToUTM(trajectory[i - 1]);
+            auto p1 = converter.convertToUTM(trajectory[i]);
+            checksum += (p1.position - p0.position).head<2>().norm();
+        }
+        report("UTM, per pair", count - 1, Clock::now() - start, checksum);
+    }
+
+    {
+        auto start = Clock::now();
+        auto utm = converter.convertToUTM(trajectory);
+        double checksum = 0;
+        for (size_t i = 1; i < count; ++i) {
+            checksum += (utm[i].position - utm[i - 1].position).head<2>().norm();
+        }
+        report("UTM, batch", count - 1, Clock::now() - start, checksum);
+    }
+
+    {
+        auto start = Clock::now();
+        auto distances = geodesic::consecutiveDistances(trajectory, geodesic::MODE_EXACT);
+        report("geodesic, exact", count - 1, Clock::now() - start, sum(distances));
+    }
+
+    {
+        auto start = Clock::now();
+        auto distances = geodesic::consecutiveDistances(trajectory, geodesic::MODE_APPROXIMATE);
+        report("geodesic, approximate", count - 1, Clock::now() - start, sum(distances));
+    }
+
+    {
+        auto start = Clock::now();
+        auto distances = geodesic::distances(trajectory.front(), trajectory,
+                                             geodesic::MODE_APPROXIMATE);
+        report("geodesic, approximate, one to many", count, Clock::now() - start,
+               sum(distances));
+    }
+    return 0;
+}
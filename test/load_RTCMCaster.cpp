@@ -0,0 +1,192 @@
+#include <gps_base/RTCMCaster.hpp>
+#include <gps_base/rtcm3.hpp>
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace gps_base;
+using namespace std;
+
+/** Measures the fan-out throughput and latency of RTCMCaster, with many
+ * rovers connected over the loopback interface
+ *
+ * Usage: load_RTCMCaster [ROVERS] [FRAMES] [REACTORS], defaults to 1000
+ * rovers, 1000 frames and 1 reactor. The frames are broadcast every
+ * millisecond, and embed their broadcast time so that the rovers can
+ * measure the latency.
+ */
+
+namespace {
+    typedef chrono::steady_clock Clock;
+
+    const size_t PAYLOAD_SIZE = 200;
+
+    int64_t now() {
+        return chrono::duration_cast<chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count();
+    }
+
+    vector<uint8_t> makeFrame() {
+        vector<uint8_t> frame = {
+            rtcm3::PREAMBLE,
+            static_cast<uint8_t>(PAYLOAD_SIZE >> 8),
+            static_cast<uint8_t>(PAYLOAD_SIZE & 0xFF)
+        };
+        frame.resize(3 + PAYLOAD_SIZE);
+        int64_t time = now();
+        memcpy(frame.data() + 3, &time, sizeof(time));
+        uint32_t crc = rtcm3::crc(frame.data(), frame.size());
+        frame.push_back((crc >> 16) & 0xFF);
+        frame.push_back((crc >> 8) & 0xFF);
+        frame.push_back(crc & 0xFF);
+        return frame;
+    }
+
+    struct Rover {
+        int fd;
+        vector<uint8_t> buffer;
+        size_t frames = 0;
+    };
+
+    void raiseFileLimit(size_t required) {
+        rlimit limit;
+        getrlimit(RLIMIT_NOFILE, &limit);
+        if (limit.rlim_cur < required) {
+            limit.rlim_cur = min<rlim_t>(required, limit.rlim_max);
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+        if (limit.rlim_cur < required) {
+            cerr << "warning: the file descriptor limit (" << limit.rlim_cur
+                 << ") is lower than the " << required << " needed" << endl;
+        }
+    }
+
+    int connectRover(uint16_t port) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            cerr << "failed to connect: " << strerror(errno) << endl;
+            exit(1);
+        }
+        return fd;
+    }
+
+    /** Extract the complete frames of a rover's buffer, and record their
+     * latency
+     */
+    void processFrames(Rover& rover, vector<int64_t>& latencies) {
+        int64_t receivedAt = now();
+        size_t offset = 0;
+        while (rover.buffer.size() - offset >= rtcm3::MIN_PACKET_SIZE) {
+            size_t size = rtcm3::getLength(rover.buffer.data() + offset, 3) +
+                          rtcm3::MIN_PACKET_SIZE;
+            if (rover.buffer.size() - offset < size) {
+                break;
+            }
+            int64_t sentAt;
+            memcpy(&sentAt, rover.buffer.data() + offset + 3, sizeof(sentAt));
+            latencies.push_back(receivedAt - sentAt);
+            rover.frames++;
+            offset += size;
+        }
+        rover.buffer.erase(rover.buffer.begin(), rover.buffer.begin() + offset);
+    }
+
+    double percentile(vector<int64_t> const& sorted, double p) {
+        if (sorted.empty()) {
+            return 0;
+        }
+        return sorted[min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))] * 1e-6;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t roverCount = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000;
+    size_t frameCount = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1000;
+    unsigned int reactors = argc > 3 ? strtoul(argv[3], nullptr, 10) : 1;
+    raiseFileLimit(2 * roverCount + 64);
+
+    RTCMCasterConfiguration configuration;
+    configuration.address = "127.0.0.1";
+    configuration.port = 0;
+    configuration.reactors = reactors;
+    RTCMCaster caster(configuration);
+
+    vector<Rover> rovers(roverCount);
+    int epollFD = epoll_create1(EPOLL_CLOEXEC);
+    for (size_t i = 0; i < roverCount; ++i) {
+        rovers[i].fd = connectRover(caster.getPort());
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+        epoll_ctl(epollFD, EPOLL_CTL_ADD, rovers[i].fd, &event);
+    }
+    while (caster.getStatistics().clients < roverCount) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    cout << roverCount << " rovers connected to " << reactors << " reactor(s)" << endl;
+
+    atomic<bool> broadcasting(true);
+    vector<int64_t> latencies;
+    latencies.reserve(roverCount * frameCount);
+    auto lastData = Clock::now();
+    thread receiver([&]() {
+        epoll_event events[256];
+        uint8_t buffer[65536];
+        while (broadcasting || Clock::now() - lastData < chrono::seconds(1)) {
+            int count = epoll_wait(epollFD, events, 256, 100);
+            for (int i = 0; i < count; ++i) {
+                Rover& rover = rovers[events[i].data.u64];
+                ssize_t size = read(rover.fd, buffer, sizeof(buffer));
+                if (size > 0) {
+                    rover.buffer.insert(rover.buffer.end(), buffer, buffer + size);
+                    processFrames(rover, latencies);
+                    lastData = Clock::now();
+                }
+            }
+        }
+    });
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < frameCount; ++i) {
+        caster.broadcast(make_shared<vector<uint8_t> const>(makeFrame()));
+        this_thread::sleep_until(start + chrono::milliseconds(i + 1));
+    }
+    broadcasting = false;
+    receiver.join();
+    double elapsed = chrono::duration<double>(lastData - start).count();
+
+    auto statistics = caster.getStatistics();
+    size_t received = 0;
+    for (auto const& rover : rovers) {
+        received += rover.frames;
+        close(rover.fd);
+    }
+    close(epollFD);
+    sort(latencies.begin(), latencies.end());
+
+    size_t expected = roverCount * frameCount;
+    cout << "broadcast " << statistics.frames << " frames in " << elapsed << " s\n"
+         << "received " << received << " of " << expected << " frames, "
+         << statistics.droppedFrames << " dropped\n"
+         << "throughput: " << received / elapsed << " frames/s, "
+         << statistics.sentBytes / elapsed / 1e6 << " MB/s\n"
+         << "latency: p50 " << percentile(latencies, 0.5) << " ms, "
+         << "p99 " << percentile(latencies, 0.99) << " ms, "
+         << "max " << percentile(latencies, 1) << " ms" << endl;
+    return received + statistics.droppedFrames == expected ? 0 : 1;
+}
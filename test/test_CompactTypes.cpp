@@ -0,0 +1,98 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/CompactTypes.hpp>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    Satellite makeSatellite(int prn, int elevation, int azimuth, double snr) {
+        Satellite satellite;
+        satellite.PRN = prn;
+        satellite.elevation = elevation;
+        satellite.azimuth = azimuth;
+        satellite.SNR = snr;
+        return satellite;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(PRNSet_stores_the_PRNs_it_is_given) {
+    PRNSet set;
+    set.insert(3);
+    set.insert(437);
+    BOOST_TEST(set.contains(3));
+    BOOST_TEST(set.contains(437));
+    BOOST_TEST(!set.contains(4));
+    BOOST_TEST(set.size() == 2);
+    set.erase(3);
+    BOOST_TEST(!set.contains(3));
+    BOOST_TEST(set.size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(PRNSet_throws_when_inserting_an_out_of_range_PRN) {
+    PRNSet set;
+    BOOST_REQUIRE_THROW(set.insert(-1), std::out_of_range);
+    BOOST_REQUIRE_THROW(set.insert(MAX_PRN), std::out_of_range);
+    BOOST_TEST(!set.contains(MAX_PRN));
+}
+
+BOOST_AUTO_TEST_CASE(PRNSet_converts_to_and_from_a_vector_in_increasing_order) {
+    PRNSet set(vector<int>{ 12, 3, 305 });
+    BOOST_TEST(set.toVector() == (vector<int>{ 3, 12, 305 }));
+}
+
+BOOST_AUTO_TEST_CASE(CompactSatelliteInfo_converts_to_and_from_SatelliteInfo) {
+    SatelliteInfo info;
+    info.time = base::Time::fromMicroseconds(42);
+    info.knownSatellites.push_back(makeSatellite(3, 45, 270, 42.5));
+    info.knownSatellites.push_back(makeSatellite(412, -2, 12, 20));
+
+    CompactSatelliteInfo compact(info);
+    BOOST_TEST(compact.size() == 2);
+    BOOST_TEST(compact.prn[1] == 412);
+    BOOST_TEST(compact.elevation[1] == -2);
+
+    SatelliteInfo result = compact.toSatelliteInfo();
+    BOOST_TEST(result.time == info.time);
+    BOOST_REQUIRE(result.knownSatellites.size() == 2);
+    for (int i = 0; i < 2; ++i) {
+        BOOST_TEST(result.knownSatellites[i].PRN == info.knownSatellites[i].PRN);
+        BOOST_TEST(result.knownSatellites[i].elevation == info.knownSatellites[i].elevation);
+        BOOST_TEST(result.knownSatellites[i].azimuth == info.knownSatellites[i].azimuth);
+        BOOST_TEST(result.knownSatellites[i].SNR == info.knownSatellites[i].SNR);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CompactSatelliteInfo_refuses_satellites_beyond_its_capacity) {
+    CompactSatelliteInfo compact;
+    for (int i = 0; i < MAX_SATELLITES; ++i) {
+        BOOST_REQUIRE(compact.add(makeSatellite(i, 10, 10, 10)));
+    }
+    BOOST_TEST(compact.full());
+    BOOST_TEST(!compact.add(makeSatellite(1, 10, 10, 10)));
+    BOOST_TEST(compact.size() == MAX_SATELLITES);
+}
+
+BOOST_AUTO_TEST_CASE(CompactSatelliteInfo_throws_if_converting_too_many_satellites) {
+    SatelliteInfo info;
+    info.knownSatellites.resize(MAX_SATELLITES + 1);
+    BOOST_REQUIRE_THROW(CompactSatelliteInfo compact(info), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(CompactSolutionQuality_converts_to_and_from_SolutionQuality) {
+    SolutionQuality quality;
+    quality.time = base::Time::fromMicroseconds(42);
+    quality.usedSatellites = { 5, 2, 68 };
+    quality.pdop = 1.5;
+    quality.hdop = 0.9;
+    quality.vdop = 1.2;
+
+    CompactSolutionQuality compact(quality);
+    BOOST_TEST(compact.usedSatellites.contains(68));
+
+    SolutionQuality result = compact.toSolutionQuality();
+    BOOST_TEST(result.time == quality.time);
+    BOOST_TEST(result.usedSatellites == (vector<int>{ 2, 5, 68 }));
+    BOOST_TEST(result.pdop == 1.5);
+    BOOST_TEST(result.hdop == 0.9);
+    BOOST_TEST(result.vdop == 1.2);
+}
@@ -0,0 +1,95 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/ConstellationStatistics.hpp>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    Satellite makeSatellite(int prn, int elevation, double snr) {
+        Satellite satellite;
+        satellite.PRN = prn;
+        satellite.elevation = elevation;
+        satellite.azimuth = 0;
+        satellite.SNR = snr;
+        return satellite;
+    }
+
+    SatelliteInfo fixtureSatellites() {
+        SatelliteInfo info;
+        info.knownSatellites.push_back(makeSatellite(3, 10, 30));
+        info.knownSatellites.push_back(makeSatellite(12, 50, 40));
+        info.knownSatellites.push_back(makeSatellite(305, 20, 35));
+        info.knownSatellites.push_back(makeSatellite(0, 90, 10));
+        return info;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(getConstellationFromPRN_maps_the_PRN_ranges) {
+    static_assert(Satellite::getConstellationFromPRN(1) == CONSTELLATION_GPS,
+                  "the lookup is usable at compile time");
+    BOOST_TEST(Satellite::getConstellationFromPRN(32) == CONSTELLATION_GPS);
+    BOOST_TEST(Satellite::getConstellationFromPRN(33) == CONSTELLATION_SBAS);
+    BOOST_TEST(Satellite::getConstellationFromPRN(155) == CONSTELLATION_SBAS);
+    BOOST_TEST(Satellite::getConstellationFromPRN(65) == CONSTELLATION_GLONASS);
+    BOOST_TEST(Satellite::getConstellationFromPRN(96) == CONSTELLATION_GLONASS);
+    BOOST_TEST(Satellite::getConstellationFromPRN(301) == CONSTELLATION_GALILEO);
+    BOOST_TEST(Satellite::getConstellationFromPRN(437) == CONSTELLATION_BEIDOU);
+    BOOST_TEST(Satellite::getConstellationFromPRN(193) == CONSTELLATION_QZSS);
+}
+
+BOOST_AUTO_TEST_CASE(getConstellationFromPRN_returns_unknown_for_unassigned_PRNs) {
+    BOOST_TEST(Satellite::getConstellationFromPRN(-1) == CONSTELLATION_UNKNOWN);
+    BOOST_TEST(Satellite::getConstellationFromPRN(0) == CONSTELLATION_UNKNOWN);
+    BOOST_TEST(Satellite::getConstellationFromPRN(100) == CONSTELLATION_UNKNOWN);
+    BOOST_TEST(Satellite::getConstellationFromPRN(438) == CONSTELLATION_UNKNOWN);
+    BOOST_TEST(Satellite::getConstellationFromPRN(100000) == CONSTELLATION_UNKNOWN);
+}
+
+BOOST_AUTO_TEST_CASE(computeConstellationStatistics_aggregates_per_constellation) {
+    SolutionQuality quality;
+    quality.usedSatellites = { 12, 305 };
+    auto stats = computeConstellationStatistics(fixtureSatellites(), quality);
+
+    auto const& gps = stats[CONSTELLATION_GPS];
+    BOOST_TEST(gps.count == 2);
+    BOOST_TEST(gps.usedCount == 1);
+    BOOST_TEST(gps.meanSNR == 35);
+    BOOST_TEST(gps.minSNR == 30);
+    BOOST_TEST(gps.maxSNR == 40);
+    BOOST_TEST(gps.meanElevation == 30);
+
+    auto const& galileo = stats[CONSTELLATION_GALILEO];
+    BOOST_TEST(galileo.count == 1);
+    BOOST_TEST(galileo.usedCount == 1);
+    BOOST_TEST(galileo.meanSNR == 35);
+
+    BOOST_TEST(stats[CONSTELLATION_UNKNOWN].count == 1);
+}
+
+BOOST_AUTO_TEST_CASE(computeConstellationStatistics_sets_the_SNR_and_elevation_to_NaN_for_empty_constellations) {
+    auto stats = computeConstellationStatistics(fixtureSatellites(), PRNSet());
+    auto const& glonass = stats[CONSTELLATION_GLONASS];
+    BOOST_TEST(glonass.count == 0);
+    BOOST_TEST(glonass.usedCount == 0);
+    BOOST_TEST(base::isUnknown(glonass.meanSNR));
+    BOOST_TEST(base::isUnknown(glonass.minSNR));
+    BOOST_TEST(base::isUnknown(glonass.maxSNR));
+    BOOST_TEST(base::isUnknown(glonass.meanElevation));
+}
+
+BOOST_AUTO_TEST_CASE(computeConstellationStatistics_gives_the_same_results_on_the_compact_types) {
+    PRNSet used(vector<int>{ 3, 305 });
+    auto expected = computeConstellationStatistics(fixtureSatellites(), used);
+    auto actual = computeConstellationStatistics(
+        CompactSatelliteInfo(fixtureSatellites()), used);
+    for (int i = 0; i < CONSTELLATION_COUNT; ++i) {
+        auto const& e = expected.constellations[i];
+        auto const& a = actual.constellations[i];
+        BOOST_TEST(e.count == a.count);
+        BOOST_TEST(e.usedCount == a.usedCount);
+        if (e.count) {
+            BOOST_TEST(e.meanSNR == a.meanSNR);
+            BOOST_TEST(e.meanElevation == a.meanElevation);
+        }
+    }
+}
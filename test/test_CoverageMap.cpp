@@ -0,0 +1,343 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/CoverageMap.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    UTMConverter fixtureConverter() {
+        UTMConversionParameters parameters;
+        parameters.utm_zone = 24;
+        parameters.utm_north = false;
+        return UTMConverter(parameters);
+    }
+
+    /** Solutions along a line, chosen so that none of them is on a cell
+     * boundary, even after the rounding of the solution log
+     */
+    Solution makeSolution(int i) {
+        Solution solution;
+        solution.time = base::Time::fromMicroseconds(1600000000000000LL + i * 100000);
+        solution.latitude = -13.0573615 + i * 1e-6;
+        solution.longitude = -38.6499025 - i * 2e-6;
+        solution.positionType = (i % 3) ? RTK_FIXED : RTK_FLOAT;
+        solution.noOfSatellites = (i % 5) ? 10 + i % 4 : -1;
+        solution.altitude = 2.0;
+        solution.geoidalSeparation = -10.5;
+        solution.ageOfDifferentialCorrections = (i % 10) ? (i % 10) * 0.5 : base::unknown<double>();
+        solution.deviationLatitude = 0.02;
+        solution.deviationLongitude = 0.03;
+        solution.deviationAltitude = 0.05;
+        return solution;
+    }
+
+    vector<Solution> fixtureSolutions(int count) {
+        vector<Solution> solutions;
+        for (int i = 0; i < count; ++i) {
+            solutions.push_back(makeSolution(i));
+        }
+        return solutions;
+    }
+
+    /** One quality every second, i.e. every 10 solutions */
+    vector<SolutionQuality> fixtureQualities(int count) {
+        vector<SolutionQuality> qualities;
+        for (int i = 0; i < count; i += 10) {
+            SolutionQuality quality;
+            quality.time = makeSolution(i).time;
+            quality.pdop = 2;
+            quality.hdop = 1 + (i / 10) % 3 * 0.25;
+            quality.vdop = 1.5;
+            qualities.push_back(quality);
+        }
+        return qualities;
+    }
+
+    CoverageAggregatorConfiguration geodeticConfiguration() {
+        CoverageAggregatorConfiguration configuration;
+        configuration.scheme = COVERAGE_CELLS_GEODETIC;
+        configuration.cellSize = 1e-3;
+        return configuration;
+    }
+
+    void requireSameCells(CoverageMap const& expected, CoverageMap const& actual,
+                          double tolerance = 1e-12) {
+        auto expectedCells = expected.getCells();
+        auto actualCells = actual.getCells();
+        BOOST_REQUIRE_EQUAL(expectedCells.size(), actualCells.size());
+        for (size_t i = 0; i < expectedCells.size(); ++i) {
+            auto const& e = expectedCells[i];
+            auto const& a = actualCells[i];
+            BOOST_TEST(a.column == e.column);
+            BOOST_TEST(a.row == e.row);
+            BOOST_TEST(a.solutions == e.solutions);
+            BOOST_TEST(a.fixed == e.fixed);
+            BOOST_TEST(a.satelliteSamples == e.satelliteSamples);
+            BOOST_TEST(a.satelliteSum == e.satelliteSum);
+            BOOST_TEST(a.hdopSamples == e.hdopSamples);
+            BOOST_TEST(a.hdopSum == e.hdopSum, boost::test_tools::tolerance(tolerance));
+            BOOST_TEST(a.correctionAgeSamples == e.correctionAgeSamples);
+            BOOST_TEST(a.correctionAgeSum == e.correctionAgeSum,
+                       boost::test_tools::tolerance(tolerance));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(coverage_aggregator_accumulates_the_cell_statistics)
+{
+    auto solutions = fixtureSolutions(1000);
+    auto qualities = fixtureQualities(1000);
+    CoverageAggregator aggregator(fixtureConverter(), geodeticConfiguration());
+    auto statistics = aggregator.add(solutions, qualities);
+    BOOST_TEST(statistics.solutions == 1000);
+    BOOST_TEST(statistics.accepted == 1000);
+    BOOST_TEST(statistics.outside == 0);
+
+    // Compute the expected statistics one solution at a time
+    CoverageMap expected(COVERAGE_CELLS_GEODETIC, 1e-3);
+    for (int i = 0; i < 1000; ++i) {
+        auto const& solution = solutions[i];
+        CoverageCell cell;
+        cell.column = floor(solution.longitude / 1e-3);
+        cell.row = floor(solution.latitude / 1e-3);
+        cell.solutions = 1;
+        cell.fixed = solution.positionType == RTK_FIXED;
+        if (solution.noOfSatellites >= 0) {
+            cell.satelliteSamples = 1;
+            cell.satelliteSum = solution.noOfSatellites;
+        }
+        if (!std::isnan(solution.ageOfDifferentialCorrections)) {
+            cell.correctionAgeSamples = 1;
+            cell.correctionAgeSum = solution.ageOfDifferentialCorrections;
+        }
+        cell.hdopSamples = 1;
+        cell.hdopSum = qualities[i / 10].hdop;
+        expected.add(cell);
+    }
+    BOOST_TEST(expected.size() > 1);
+    requireSameCells(expected, aggregator.getMap());
+
+    auto cell = aggregator.getMap().getCells().front();
+    BOOST_TEST(cell.getFixedRatio() == static_cast<double>(cell.fixed) / cell.solutions);
+    BOOST_TEST(cell.getMeanHDOP() == cell.hdopSum / cell.hdopSamples);
+    BOOST_TEST(std::isnan(aggregator.getMap().getCell(0, 0).getMeanHDOP()));
+}
+
+BOOST_AUTO_TEST_CASE(coverage_aggregator_associates_solutions_with_recent_qualities_only)
+{
+    auto solutions = fixtureSolutions(100);
+    auto qualities = fixtureQualities(100);
+    // Remove the qualities of the solutions 30 to 59, and unsort the solutions
+    qualities.erase(qualities.begin() + 3, qualities.begin() + 6);
+    swap(solutions[10], solutions[90]);
+
+    auto configuration = geodeticConfiguration();
+    configuration.cellSize = 1;
+    configuration.maxQualityAge = base::Time::fromMilliseconds(1500);
+    CoverageAggregator aggregator(fixtureConverter(), configuration);
+    aggregator.add(solutions, qualities);
+
+    auto cells = aggregator.getMap().getCells();
+    BOOST_REQUIRE_EQUAL(1, cells.size());
+    // 30 to 35 are at most 1.5s after the quality of 20
+    BOOST_TEST(cells[0].hdopSamples == 76);
+}
+
+BOOST_AUTO_TEST_CASE(coverage_aggregator_uses_the_converter_utm_grid)
+{
+    auto solutions = fixtureSolutions(1000);
+    auto configuration = CoverageAggregatorConfiguration();
+    configuration.cellSize = 0.5;
+    CoverageAggregator aggregator(fixtureConverter(), configuration);
+    aggregator.add(solutions);
+    BOOST_TEST(aggregator.getMap().getScheme() == COVERAGE_CELLS_UTM);
+    BOOST_TEST(aggregator.getMap().getUTMZone() == 24);
+    BOOST_TEST(!aggregator.getMap().getUTMNorth());
+
+    auto converter = fixtureConverter();
+    uint64_t total = 0;
+    for (auto const& solution : solutions) {
+        auto utm = converter.convertToUTM(solution);
+        int32_t column, row;
+        BOOST_REQUIRE(aggregator.getCellPosition(solution.latitude, solution.longitude,
+                                                 column, row));
+        BOOST_TEST(column == floor(utm.position.x() / 0.5));
+        BOOST_TEST(row == floor(utm.position.y() / 0.5));
+        BOOST_TEST(aggregator.getMap().getCell(column, row).solutions > 0);
+    }
+    for (auto const& cell : aggregator.getMap().getCells()) {
+        total += cell.solutions;
+    }
+    BOOST_TEST(total == 1000);
+}
+
+BOOST_AUTO_TEST_CASE(coverage_aggregator_results_do_not_depend_on_the_parallelization)
+{
+    auto solutions = fixtureSolutions(5000);
+    auto qualities = fixtureQualities(5000);
+    auto configuration = geodeticConfiguration();
+    configuration.threads = 1;
+    CoverageAggregator sequential(fixtureConverter(), configuration);
+    auto sequentialStatistics = sequential.add(solutions, qualities);
+    BOOST_TEST(sequentialStatistics.merges == 1);
+
+    configuration.threads = 4;
+    configuration.chunkSize = 37;
+    configuration.maxLocalCells = 2;
+    CoverageAggregator parallel(fixtureConverter(), configuration);
+    auto parallelStatistics = parallel.add(solutions, qualities);
+    BOOST_TEST(parallelStatistics.merges > 4);
+    requireSameCells(sequential.getMap(), parallel.getMap(), 1e-9);
+
+    // Aggregation accumulates over calls
+    parallel.add(solutions, qualities);
+    BOOST_TEST(parallel.getMap().getCells().front().solutions ==
+               2 * sequential.getMap().getCells().front().solutions);
+    parallel.clear();
+    BOOST_TEST(parallel.getMap().empty());
+}
+
+BOOST_AUTO_TEST_CASE(coverage_aggregator_reads_solution_logs)
+{
+    char tmpl[] = "/tmp/gps_base_test_CoverageMap_XXXXXX";
+    int fd = mkstemp(tmpl);
+    ::close(fd);
+    string path = tmpl;
+
+    auto solutions = fixtureSolutions(5000);
+    {
+        SolutionLogWriter writer(path, 256);
+        for (auto const& solution : solutions) {
+            writer.write(solution);
+        }
+    }
+
+    auto configuration = geodeticConfiguration();
+    configuration.threads = 4;
+    CoverageAggregator fromLog(fixtureConverter(), configuration);
+    SolutionLogReader log(path);
+    auto statistics = fromLog.add(log);
+    remove(path.c_str());
+    BOOST_TEST(statistics.solutions == 5000);
+
+    CoverageAggregator fromVector(fixtureConverter(), configuration);
+    fromVector.add(solutions);
+    requireSameCells(fromVector.getMap(), fromLog.getMap(), 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(coverage_aggregator_filters_the_solutions)
+{
+    auto solutions = fixtureSolutions(100);
+    solutions[0].positionType = NO_SOLUTION;
+    solutions[1].latitude = base::unknown<double>();
+    solutions[2].positionType = AUTONOMOUS;
+
+    auto configuration = geodeticConfiguration();
+    configuration.filter.positionTypes =
+        TrajectoryFilter::positionTypeBit(RTK_FIXED) |
+        TrajectoryFilter::positionTypeBit(RTK_FLOAT);
+    CoverageAggregator aggregator(fixtureConverter(), configuration);
+    auto statistics = aggregator.add(solutions);
+    BOOST_TEST(statistics.solutions == 100);
+    BOOST_TEST(statistics.accepted == 98);
+    BOOST_TEST(statistics.outside == 1);
+
+    uint64_t total = 0;
+    for (auto const& cell : aggregator.getMap().getCells()) {
+        total += cell.solutions;
+    }
+    BOOST_TEST(total == 97);
+}
+
+BOOST_AUTO_TEST_CASE(coverage_map_round_trips_through_its_encoding)
+{
+    CoverageAggregator aggregator(fixtureConverter(), geodeticConfiguration());
+    aggregator.add(fixtureSolutions(5000), fixtureQualities(5000));
+    auto const& map = aggregator.getMap();
+
+    string encoded = map.encode();
+    // A handful of bytes per cell
+    BOOST_TEST(encoded.size() < 32 * map.size());
+
+    auto decoded = CoverageMap::decode(
+        reinterpret_cast<uint8_t const*>(encoded.data()), encoded.size());
+    BOOST_TEST(decoded.isCompatible(map));
+    BOOST_TEST(decoded.getCellSize() == map.getCellSize());
+    requireSameCells(map, decoded, 1e-6);
+
+    char tmpl[] = "/tmp/gps_base_test_CoverageMap_XXXXXX";
+    int fd = mkstemp(tmpl);
+    ::close(fd);
+    map.save(tmpl);
+    auto loaded = CoverageMap::load(tmpl);
+    remove(tmpl);
+    requireSameCells(map, loaded, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(coverage_map_encodes_cells_far_from_the_origin)
+{
+    CoverageMap map(COVERAGE_CELLS_UTM, 10, 32, true);
+    CoverageCell cell;
+    cell.solutions = 1;
+    for (int32_t row : { numeric_limits<int32_t>::min(), -1, 0, 5, numeric_limits<int32_t>::max() }) {
+        for (int32_t column : { numeric_limits<int32_t>::min(), 3, numeric_limits<int32_t>::max() }) {
+            cell.row = row;
+            cell.column = column;
+            map.add(cell);
+        }
+    }
+
+    string encoded = map.encode();
+    auto decoded = CoverageMap::decode(
+        reinterpret_cast<uint8_t const*>(encoded.data()), encoded.size());
+    BOOST_TEST(decoded.getUTMZone() == 32);
+    BOOST_TEST(decoded.getUTMNorth());
+    requireSameCells(map, decoded);
+}
+
+BOOST_AUTO_TEST_CASE(coverage_map_rejects_invalid_data)
+{
+    CoverageAggregator aggregator(fixtureConverter(), geodeticConfiguration());
+    aggregator.add(fixtureSolutions(100));
+    string encoded = aggregator.getMap().encode();
+    auto data = reinterpret_cast<uint8_t const*>(encoded.data());
+
+    BOOST_REQUIRE_THROW(CoverageMap::decode(data, encoded.size() - 1), std::runtime_error);
+    BOOST_REQUIRE_THROW(CoverageMap::decode(data, 4), std::runtime_error);
+    encoded += "x";
+    BOOST_REQUIRE_THROW(CoverageMap::decode(data, encoded.size()), std::runtime_error);
+    encoded[0] = 'X';
+    BOOST_REQUIRE_THROW(CoverageMap::decode(data, encoded.size() - 1), std::runtime_error);
+    BOOST_REQUIRE_THROW(CoverageMap::load("/does/not/exist"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(coverage_map_merges_compatible_maps_only)
+{
+    CoverageMap map(COVERAGE_CELLS_UTM, 10, 24, false);
+    CoverageCell cell;
+    cell.column = 3;
+    cell.row = 4;
+    cell.solutions = 2;
+    cell.fixed = 1;
+    map.add(cell);
+
+    CoverageMap other(COVERAGE_CELLS_UTM, 10, 24, false);
+    other.add(cell);
+    map.merge(other);
+    BOOST_TEST(map.getCell(3, 4).solutions == 4);
+    BOOST_TEST(map.getCell(3, 4).getFixedRatio() == 0.5);
+
+    BOOST_REQUIRE_THROW(map.merge(CoverageMap(COVERAGE_CELLS_UTM, 10, 25, false)),
+                        std::invalid_argument);
+    BOOST_REQUIRE_THROW(map.merge(CoverageMap(COVERAGE_CELLS_UTM, 5, 24, false)),
+                        std::invalid_argument);
+    BOOST_REQUIRE_THROW(map.merge(CoverageMap(COVERAGE_CELLS_GEODETIC, 10)),
+                        std::invalid_argument);
+    BOOST_REQUIRE_THROW(CoverageMap(COVERAGE_CELLS_UTM, 0), std::invalid_argument);
+}
@@ -0,0 +1,109 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/DOP.hpp>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    Satellite makeSatellite(int prn, int elevation, int azimuth) {
+        Satellite satellite;
+        satellite.PRN = prn;
+        satellite.elevation = elevation;
+        satellite.azimuth = azimuth;
+        satellite.SNR = 40;
+        return satellite;
+    }
+
+    /** GPS satellites at zenith and on the horizon, 120 degrees apart,
+     * plus two Galileo satellites at 45 degrees
+     */
+    SatelliteInfo fixtureSatellites() {
+        SatelliteInfo info;
+        info.knownSatellites.push_back(makeSatellite(1, 90, 0));
+        info.knownSatellites.push_back(makeSatellite(2, 10, 0));
+        info.knownSatellites.push_back(makeSatellite(3, 10, 120));
+        info.knownSatellites.push_back(makeSatellite(4, 10, 240));
+        info.knownSatellites.push_back(makeSatellite(301, 45, 60));
+        info.knownSatellites.push_back(makeSatellite(302, 45, 300));
+        return info;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(computeDOP_computes_the_DOP_from_the_satellite_geometry) {
+    auto dop = computeDOP(fixtureSatellites());
+    BOOST_REQUIRE_CLOSE(dop.gdop, 1.7830489110083436, 1e-6);
+    BOOST_REQUIRE_CLOSE(dop.pdop, 1.626963939957377, 1e-6);
+    BOOST_REQUIRE_CLOSE(dop.hdop, 1.041350727977903, 1e-6);
+    BOOST_REQUIRE_CLOSE(dop.vdop, 1.2500401286604854, 1e-6);
+    BOOST_REQUIRE_CLOSE(dop.tdop, 0.7295558629237436, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(computeDOP_applies_the_elevation_mask) {
+    SatelliteMask mask;
+    mask.minElevation = 15;
+    auto dop = computeDOP(fixtureSatellites(), mask);
+    // Only 3 satellites left
+    BOOST_TEST(base::isUnknown(dop.pdop));
+}
+
+BOOST_AUTO_TEST_CASE(computeDOP_applies_the_constellation_mask) {
+    auto info = fixtureSatellites();
+    info.knownSatellites[3].elevation = 20;
+    info.knownSatellites[3].azimuth = 180;
+    info.knownSatellites[2].PRN = 65;
+
+    SatelliteMask mask;
+    mask.constellations =
+        SatelliteMask::constellationBit(CONSTELLATION_GPS) |
+        SatelliteMask::constellationBit(CONSTELLATION_GALILEO);
+    mask.minElevation = 15;
+    auto dop = computeDOP(info, mask);
+    BOOST_REQUIRE_CLOSE(dop.gdop, 4.036193771576142, 1e-6);
+    BOOST_REQUIRE_CLOSE(dop.pdop, 3.420948078337854, 1e-6);
+    BOOST_REQUIRE_CLOSE(dop.hdop, 1.7383883714579693, 1e-6);
+    BOOST_REQUIRE_CLOSE(dop.vdop, 2.946335287210735, 1e-6);
+    BOOST_REQUIRE_CLOSE(dop.tdop, 2.1419557434799117, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(computeDOP_returns_NaN_on_a_degenerate_geometry) {
+    SatelliteInfo info;
+    for (int i = 0; i < 5; ++i) {
+        info.knownSatellites.push_back(makeSatellite(i + 1, 30, 90));
+    }
+    auto dop = computeDOP(info);
+    BOOST_TEST(base::isUnknown(dop.gdop));
+}
+
+BOOST_AUTO_TEST_CASE(computeDOP_gives_the_same_results_on_CompactSatelliteInfo) {
+    auto expected = computeDOP(fixtureSatellites());
+    auto actual = computeDOP(CompactSatelliteInfo(fixtureSatellites()));
+    BOOST_REQUIRE_CLOSE(expected.gdop, actual.gdop, 1e-6);
+    BOOST_REQUIRE_CLOSE(expected.pdop, actual.pdop, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(computeDOP_evaluates_several_masks_at_once) {
+    SatelliteMask all;
+    SatelliteMask high;
+    high.minElevation = 15;
+
+    auto dops = computeDOP(fixtureSatellites(), vector<SatelliteMask> { all, high });
+    BOOST_REQUIRE(dops.size() == 2);
+    BOOST_REQUIRE_CLOSE(dops[0].pdop, 1.626963939957377, 1e-6);
+    BOOST_TEST(base::isUnknown(dops[1].pdop));
+}
+
+BOOST_AUTO_TEST_CASE(computeDOP_evaluates_many_epochs_in_parallel) {
+    vector<SatelliteInfo> epochs(100, fixtureSatellites());
+    epochs[42].knownSatellites.resize(3);
+
+    auto dops = computeDOP(epochs, SatelliteMask(), 4);
+    BOOST_REQUIRE(dops.size() == 100);
+    for (size_t i = 0; i < dops.size(); ++i) {
+        if (i == 42) {
+            BOOST_TEST(base::isUnknown(dops[i].pdop));
+        }
+        else {
+            BOOST_REQUIRE_CLOSE(dops[i].pdop, 1.626963939957377, 1e-6);
+        }
+    }
+}
@@ -0,0 +1,216 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/FixedUTMConverter.hpp>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    typedef FixedUTMConverter<24, false> Zone24S;
+    typedef FixedUTMConverter<32, true> Zone32N;
+
+    static_assert(Zone24S::CENTRAL_MERIDIAN == -39, "wrong central meridian");
+    static_assert(Zone24S::FALSE_NORTHING == 10000000, "wrong false northing");
+    static_assert(Zone32N::CENTRAL_MERIDIAN == 9, "wrong central meridian");
+    static_assert(Zone32N::FALSE_NORTHING == 0, "wrong false northing");
+
+    vector<Solution> makeSolutions(double latitude, double longitude) {
+        vector<Solution> solutions;
+        for (int i = 0; i < 20; ++i) {
+            Solution solution;
+            solution.time = base::Time::fromMicroseconds(i);
+            solution.positionType = RTK_FIXED;
+            solution.latitude = latitude + 0.37 * i;
+            solution.longitude = longitude + 0.29 * i;
+            solution.altitude = 2 + i;
+            solution.geoidalSeparation = -10;
+            solution.deviationLatitude = 0.2;
+            solution.deviationLongitude = 0.33;
+            solution.deviationAltitude = 0.27;
+            solutions.push_back(solution);
+        }
+        return solutions;
+    }
+
+    UTMConversionParameters makeParameters(int zone, bool north) {
+        UTMConversionParameters parameters;
+        parameters.utm_zone = zone;
+        parameters.utm_north = north;
+        parameters.nwu_origin = base::Position(8550000, 400000, 1);
+        return parameters;
+    }
+
+    template<typename Fixed>
+    void requireSameConversions(vector<Solution> const& solutions) {
+        auto parameters = makeParameters(Fixed::ZONE, Fixed::NORTH);
+        Fixed fixed(parameters);
+        UTMConverter converter(parameters);
+
+        for (auto const& solution : solutions) {
+            auto expected = converter.convertToUTM(solution);
+            auto actual = fixed.convertToUTM(solution);
+            for (int i = 0; i < 3; ++i) {
+                BOOST_TEST(actual.position(i) == expected.position(i),
+                           boost::test_tools::tolerance(1e-12));
+            }
+            BOOST_REQUIRE(actual.cov_position == expected.cov_position);
+
+            expected = converter.convertToNWU(solution);
+            actual = fixed.convertToNWU(solution);
+            for (int i = 0; i < 3; ++i) {
+                BOOST_TEST(actual.position(i) == expected.position(i),
+                           boost::test_tools::tolerance(1e-9));
+            }
+            BOOST_REQUIRE(actual.cov_position == expected.cov_position);
+
+            auto expectedSolution = converter.convertNWUToGPS(expected);
+            auto actualSolution = fixed.convertNWUToGPS(actual);
+            BOOST_TEST(actualSolution.latitude == expectedSolution.latitude,
+                       boost::test_tools::tolerance(1e-12));
+            BOOST_TEST(actualSolution.longitude == expectedSolution.longitude,
+                       boost::test_tools::tolerance(1e-12));
+            BOOST_TEST(actualSolution.altitude == expectedSolution.altitude);
+            BOOST_TEST(actualSolution.deviationLatitude == expectedSolution.deviationLatitude);
+            BOOST_TEST(actualSolution.deviationLongitude == expectedSolution.deviationLongitude);
+
+            // The grid conversions share the same implementation
+            base::Orientation heading(Eigen::AngleAxisd(0.3, Eigen::Vector3d::UnitZ()));
+            expected = converter.convertToNWUWithGrid(solution, heading);
+            actual = fixed.convertToNWUWithGrid(solution, heading);
+            BOOST_REQUIRE(actual.position == expected.position);
+            BOOST_REQUIRE(actual.cov_position == expected.cov_position);
+            BOOST_REQUIRE(actual.orientation.coeffs() == expected.orientation.coeffs());
+
+            base::Orientation expectedOrientation, actualOrientation;
+            expectedSolution = converter.convertNWUToGPSWithGrid(expected, &expectedOrientation);
+            actualSolution = fixed.convertNWUToGPSWithGrid(actual, &actualOrientation);
+            BOOST_TEST(actualSolution.latitude == expectedSolution.latitude);
+            BOOST_TEST(actualSolution.longitude == expectedSolution.longitude);
+            BOOST_TEST(actualSolution.deviationLatitude == expectedSolution.deviationLatitude);
+            BOOST_REQUIRE(actualOrientation.coeffs() == expectedOrientation.coeffs());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(the_fixed_converter_matches_the_generic_converter)
+{
+    requireSameConversions<Zone24S>(makeSolutions(-20, -42));
+    requireSameConversions<Zone32N>(makeSolutions(40, 5));
+}
+
+BOOST_AUTO_TEST_CASE(the_fixed_converter_matches_the_generic_array_conversions)
+{
+    auto solutions = makeSolutions(-20, -42);
+    vector<double> latitudes, longitudes, altitudes;
+    for (auto const& solution : solutions) {
+        latitudes.push_back(solution.latitude);
+        longitudes.push_back(solution.longitude);
+        altitudes.push_back(solution.altitude);
+    }
+
+    auto parameters = makeParameters(24, false);
+    Zone24S fixed(parameters);
+    UTMConverter converter(parameters);
+
+    size_t count = solutions.size();
+    vector<double> x(count), y(count), z(count);
+    vector<double> expectedX(count), expectedY(count), expectedZ(count);
+    fixed.convertToNWU(count, latitudes.data(), longitudes.data(), altitudes.data(),
+                       x.data(), y.data(), z.data());
+    converter.convertToNWU(count, latitudes.data(), longitudes.data(), altitudes.data(),
+                           expectedX.data(), expectedY.data(), expectedZ.data());
+    for (size_t i = 0; i < count; ++i) {
+        BOOST_TEST(x[i] == expectedX[i], boost::test_tools::tolerance(1e-9));
+        BOOST_TEST(y[i] == expectedY[i], boost::test_tools::tolerance(1e-9));
+        BOOST_TEST(z[i] == expectedZ[i]);
+    }
+
+    vector<double> convergences(count), scales(count);
+    vector<double> expectedConvergences(count), expectedScales(count);
+    fixed.convertToUTMWithGrid(count, latitudes.data(), longitudes.data(), altitudes.data(),
+                               x.data(), y.data(), z.data(),
+                               convergences.data(), scales.data());
+    converter.convertToUTMWithGrid(count, latitudes.data(), longitudes.data(), altitudes.data(),
+                                   expectedX.data(), expectedY.data(), expectedZ.data(),
+                                   expectedConvergences.data(), expectedScales.data());
+    BOOST_TEST(x == expectedX, boost::test_tools::per_element());
+    BOOST_TEST(y == expectedY, boost::test_tools::per_element());
+    BOOST_TEST(convergences == expectedConvergences, boost::test_tools::per_element());
+    BOOST_TEST(scales == expectedScales, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(the_fixed_converter_matches_the_generic_float_conversions)
+{
+    auto solutions = makeSolutions(-20, -42);
+    vector<double> latitudes, longitudes, altitudes;
+    for (auto const& solution : solutions) {
+        latitudes.push_back(solution.latitude);
+        longitudes.push_back(solution.longitude);
+        altitudes.push_back(solution.altitude);
+    }
+    latitudes[3] = NAN;
+
+    auto parameters = makeParameters(24, false);
+    Zone24S fixed(parameters);
+    UTMConverter converter(parameters);
+
+    size_t count = solutions.size();
+    base::Position anchor = converter.convertToNWU(solutions[10]).position;
+    vector<float> xyz(3 * count), expected(3 * count);
+    auto report = fixed.convertToNWUFloat(
+        count, latitudes.data(), longitudes.data(), altitudes.data(),
+        xyz.data(), 0.01, anchor);
+    auto expectedReport = converter.convertToNWUFloat(
+        count, latitudes.data(), longitudes.data(), altitudes.data(),
+        expected.data(), 0.01, anchor);
+    BOOST_TEST(report.count == expectedReport.count);
+    BOOST_TEST(report.range == expectedReport.range);
+    BOOST_TEST(report.invalid == 1);
+    BOOST_TEST(report.outOfRange == expectedReport.outOfRange);
+    BOOST_TEST(report.firstOutOfRange == expectedReport.firstOutOfRange);
+    BOOST_TEST(report.outOfRange > 0);
+    for (size_t i = 0; i < 3 * count; ++i) {
+        if (i / 3 == 3) {
+            BOOST_TEST(std::isnan(xyz[i]));
+        }
+        else {
+            BOOST_TEST(xyz[i] == expected[i], boost::test_tools::tolerance(1e-5f));
+        }
+    }
+    BOOST_REQUIRE_THROW(fixed.convertToNWUFloat(count, latitudes.data(), longitudes.data(),
+                                                altitudes.data(), xyz.data(), -1),
+                        std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(the_fixed_converter_returns_the_timestamp_only_if_there_is_no_solution)
+{
+    auto solution = makeSolutions(-20, -42).front();
+    solution.positionType = NO_SOLUTION;
+
+    Zone24S fixed;
+    auto state = fixed.convertToNWU(solution);
+    BOOST_REQUIRE_EQUAL(solution.time, state.time);
+    BOOST_REQUIRE(!state.hasValidPosition());
+    state = fixed.convertToUTMWithGrid(solution);
+    BOOST_REQUIRE_EQUAL(solution.time, state.time);
+    BOOST_REQUIRE(!state.hasValidPosition());
+}
+
+BOOST_AUTO_TEST_CASE(the_fixed_converter_rejects_other_zones)
+{
+    Zone24S fixed;
+    BOOST_REQUIRE_THROW(fixed.setParameters(makeParameters(25, false)), std::invalid_argument);
+    BOOST_REQUIRE_THROW(fixed.setParameters(makeParameters(24, true)), std::invalid_argument);
+    BOOST_REQUIRE_THROW(Zone24S(makeParameters(23, false)), std::invalid_argument);
+    BOOST_REQUIRE_THROW(fixed.setUTMZone(1), std::invalid_argument);
+    BOOST_REQUIRE_THROW(fixed.setUTMNorth(true), std::invalid_argument);
+
+    auto parameters = makeParameters(24, false);
+    parameters.height_reference = HEIGHT_ELLIPSOIDAL;
+    fixed.setParameters(parameters);
+    fixed.setUTMZone(24);
+    fixed.setUTMNorth(false);
+    BOOST_TEST(fixed.getUTMZone() == 24);
+    BOOST_TEST(!fixed.getUTMNorth());
+    BOOST_TEST(fixed.getNWUOrigin() == parameters.nwu_origin);
+    BOOST_TEST(fixed.getParameters().height_reference == HEIGHT_ELLIPSOIDAL);
+}
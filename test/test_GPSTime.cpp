@@ -0,0 +1,70 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/GPSTime.hpp>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    base::Time utc(int year, int month, int day, int hour, int minute, int second) {
+        return base::Time::fromTimeValues(year, month, day, hour, minute, second, 0, 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(gpstime_leap_second_lookups_can_be_done_at_compile_time) {
+    static_assert(gpstime::getGPSMinusUTC(gpstime::GPS_EPOCH) == 0, "");
+    static_assert(gpstime::getTAIMinusUTC(1483228799) == 36, "");
+    static_assert(gpstime::getTAIMinusUTC(1483228800) == 37, "");
+    static_assert(gpstime::getGPSMinusUTCFromGPS(1483228800 + 17) == 17, "");
+    static_assert(gpstime::getGPSMinusUTCFromGPS(1483228800 + 18) == 18, "");
+}
+
+BOOST_AUTO_TEST_CASE(gpstime_converts_between_UTC_GPS_and_TAI) {
+    base::Time t = utc(2020, 3, 1, 12, 0, 0) + base::Time::fromMicroseconds(123456);
+    BOOST_TEST(gpstime::utcToGPS(t) == t + base::Time::fromSeconds(18.0));
+    BOOST_TEST(gpstime::utcToTAI(t) == t + base::Time::fromSeconds(37.0));
+    BOOST_TEST(gpstime::gpsToTAI(gpstime::utcToGPS(t)) == gpstime::utcToTAI(t));
+    BOOST_TEST(gpstime::gpsToUTC(gpstime::utcToGPS(t)) == t);
+    BOOST_TEST(gpstime::taiToUTC(gpstime::utcToTAI(t)) == t);
+    BOOST_TEST(gpstime::taiToGPS(gpstime::utcToTAI(t)) == gpstime::utcToGPS(t));
+}
+
+BOOST_AUTO_TEST_CASE(gpstime_uses_the_leap_seconds_valid_at_the_given_time) {
+    base::Time before = utc(2016, 12, 31, 23, 59, 59);
+    base::Time after = utc(2017, 1, 1, 0, 0, 0);
+    BOOST_TEST(gpstime::utcToGPS(before) == before + base::Time::fromSeconds(17.0));
+    BOOST_TEST(gpstime::utcToGPS(after) == after + base::Time::fromSeconds(18.0));
+    BOOST_TEST(gpstime::gpsToUTC(gpstime::utcToGPS(before)) == before);
+    BOOST_TEST(gpstime::gpsToUTC(gpstime::utcToGPS(after)) == after);
+}
+
+BOOST_AUTO_TEST_CASE(gpstime_converts_GPS_week_and_time_of_week_into_UTC) {
+    gpstime::WeekTime time { 2000, 0.5 };
+    BOOST_TEST(gpstime::weekTimeToUTC(time) ==
+               utc(2018, 5, 5, 23, 59, 42) + base::Time::fromMilliseconds(500));
+}
+
+BOOST_AUTO_TEST_CASE(gpstime_converts_UTC_into_GPS_week_and_time_of_week) {
+    auto time = gpstime::utcToWeekTime(
+        utc(2018, 5, 6, 0, 0, 42) + base::Time::fromMilliseconds(250));
+    BOOST_TEST(time.week == 2000);
+    BOOST_TEST(time.tow == 60.25);
+}
+
+BOOST_AUTO_TEST_CASE(gpstime_batch_conversions_match_the_single_conversions) {
+    vector<gpstime::WeekTime> times;
+    vector<base::Time> gpsTimes;
+    for (int week = 1900; week < 1960; ++week) {
+        for (double tow = 0; tow < gpstime::SECONDS_PER_WEEK; tow += 100000.5) {
+            times.push_back(gpstime::WeekTime { week, tow });
+            gpsTimes.push_back(gpstime::utcToGPS(gpstime::weekTimeToUTC(times.back())));
+        }
+    }
+
+    auto fromWeekTime = gpstime::weekTimeToUTC(times);
+    auto fromGPS = gpstime::gpsToUTC(gpsTimes);
+    BOOST_REQUIRE_EQUAL(times.size(), fromWeekTime.size());
+    for (size_t i = 0; i < times.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(gpstime::weekTimeToUTC(times[i]), fromWeekTime[i]);
+        BOOST_REQUIRE_EQUAL(fromWeekTime[i], fromGPS[i]);
+    }
+}
@@ -0,0 +1,121 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/Geodesic.hpp>
+#include <base/Float.hpp>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    Solution makeSolution(double latitude, double longitude) {
+        Solution solution;
+        solution.positionType = AUTONOMOUS;
+        solution.latitude = latitude;
+        solution.longitude = longitude;
+        solution.altitude = 0;
+        return solution;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(geodesic_inverse_computes_the_distance_and_azimuths) {
+    auto result = geodesic::inverse(-27.5, -48.5, -27.6, -48.4);
+    BOOST_TEST(result.distance == 14843.973513144561, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(result.azimuth1 == 138.31235139488504, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(result.azimuth2 == 138.2660991179041, boost::test_tools::tolerance(1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(geodesic_inverse_handles_the_antimeridian) {
+    auto result = geodesic::inverse(makeSolution(52.0, -179.9), makeSolution(52.1, 179.9));
+    BOOST_TEST(result.distance == 17665.00614908521, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(result.azimuth1 == -50.87995309413363, boost::test_tools::tolerance(1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(geodesic_inverse_handles_nearly_antipodal_points) {
+    auto result = geodesic::inverse(0, 0, 0.5, 179.7);
+    BOOST_TEST(result.distance == 19944127.420750458, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(result.azimuth1 == 15.556882793490544, boost::test_tools::tolerance(1e-9));
+}
+
+BOOST_AUTO_TEST_CASE(geodesic_direct_computes_the_end_point) {
+    auto result = geodesic::direct(makeSolution(-27.5, -48.5), 30, 100000);
+    BOOST_TEST(result.latitude == -26.717519927757017, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(result.longitude == -47.99751018341317, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(result.azimuth == 29.77101840812854, boost::test_tools::tolerance(1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(geodesic_direct_and_inverse_are_consistent) {
+    auto end = geodesic::direct(45, 7, 123, 2500);
+    auto result = geodesic::inverse(45, 7, end.latitude, end.longitude);
+    BOOST_REQUIRE_CLOSE(result.distance, 2500, 1e-9);
+    BOOST_REQUIRE_CLOSE(result.azimuth1, 123, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(geodesic_approximate_distance_is_within_its_error_bound) {
+    double expected[] = { 14843.973513144561, 17665.00614908521,
+                          512266.3552306422, 74.23437504144498 };
+    double points[][4] = {
+        { -27.5, -48.5, -27.6, -48.4 },
+        { 52.0, -179.9, 52.1, 179.9 },
+        { 40.0, -3.0, 40.0, 3.0 },
+        { -27.5, -48.5, -27.5005, -48.4995 }
+    };
+    for (int i = 0; i < 4; ++i) {
+        double d = geodesic::approximateDistance(
+            points[i][0], points[i][1], points[i][2], points[i][3]);
+        BOOST_TEST(d == expected[i], boost::test_tools::tolerance(1.5e-6));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(geodesic_approximate_distance_falls_back_to_the_exact_solver_for_far_points) {
+    double d = geodesic::distance(0, 0, 0.5, 179.7, geodesic::MODE_APPROXIMATE);
+    BOOST_TEST(d == 19944127.420750458, boost::test_tools::tolerance(1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(geodesic_distance_is_zero_for_identical_points) {
+    BOOST_TEST(geodesic::distance(10, 20, 10, 20) == 0);
+    BOOST_TEST(geodesic::distance(10, 20, 10, 20, geodesic::MODE_APPROXIMATE) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(geodesic_distance_returns_NaN_for_NaN_inputs) {
+    double nan = base::unknown<double>();
+    BOOST_TEST(base::isUnknown(geodesic::distance(nan, 20, 10, 20)));
+    BOOST_TEST(base::isUnknown(
+        geodesic::distance(10, 20, 10, nan, geodesic::MODE_APPROXIMATE)));
+}
+
+BOOST_AUTO_TEST_CASE(geodesic_distances_computes_the_distance_from_one_point_to_many) {
+    Solution from = makeSolution(-27.5, -48.5);
+    vector<Solution> to = {
+        makeSolution(-27.6, -48.4), makeSolution(-27.5005, -48.4995),
+        makeSolution(-27.5, -48.5)
+    };
+
+    for (auto mode : { geodesic::MODE_EXACT, geodesic::MODE_APPROXIMATE }) {
+        auto result = geodesic::distances(from, to, mode);
+        BOOST_REQUIRE_EQUAL(3, result.size());
+        for (size_t i = 0; i < to.size(); ++i) {
+            BOOST_TEST(result[i] == geodesic::distance(from, to[i], mode),
+                       boost::test_tools::tolerance(1e-12));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(geodesic_consecutiveDistances_computes_the_distances_along_a_trajectory) {
+    vector<Solution> trajectory = {
+        makeSolution(-27.5, -48.5), makeSolution(-27.6, -48.4),
+        makeSolution(-27.6, -48.4), makeSolution(-27.7, -48.45)
+    };
+
+    for (auto mode : { geodesic::MODE_EXACT, geodesic::MODE_APPROXIMATE }) {
+        auto result = geodesic::consecutiveDistances(trajectory, mode);
+        BOOST_REQUIRE_EQUAL(3, result.size());
+        for (size_t i = 0; i < result.size(); ++i) {
+            BOOST_TEST(result[i] == geodesic::distance(trajectory[i], trajectory[i + 1], mode),
+                       boost::test_tools::tolerance(1e-12));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(geodesic_consecutiveDistances_returns_an_empty_vector_for_less_than_two_points) {
+    BOOST_TEST(geodesic::consecutiveDistances(vector<Solution>()).empty());
+    BOOST_TEST(geodesic::consecutiveDistances({ makeSolution(0, 0) }).empty());
+}
@@ -0,0 +1,257 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/GeoidModel.hpp>
+#include <gps_base/UTMConverter.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <unistd.h>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    /** Geoid height of the synthetic grid, linear so that both
+     * interpolations are exact away from the poles and the wrap-around
+     */
+    double syntheticSeparation(double latitude, double longitude) {
+        return 0.5 * latitude + 0.1 * longitude;
+    }
+
+    struct GeoidModelFixture {
+        string path;
+
+        GeoidModelFixture() {
+            char tmpl[] = "/tmp/gps_base_test_GeoidModel_XXXXXX";
+            int fd = mkstemp(tmpl);
+            ::close(fd);
+            path = tmpl;
+        }
+
+        ~GeoidModelFixture() {
+            remove(path.c_str());
+        }
+
+        /** Write a 30 degree grid of syntheticSeparation */
+        void writeGrid(string const& header = "P5\n# Offset -100\n# Scale 0.01\n") {
+            ofstream file(path, ios::binary);
+            file << header << "12 7\n65535\n";
+            for (int row = 0; row < 7; ++row) {
+                for (int column = 0; column < 12; ++column) {
+                    double value = syntheticSeparation(90 - row * 30, column * 30);
+                    int sample = lround((value + 100) / 0.01);
+                    file.put(sample >> 8);
+                    file.put(sample & 0xFF);
+                }
+            }
+        }
+
+        Solution makeSolution(double altitude, double separation) {
+            Solution solution;
+            solution.positionType = RTK_FIXED;
+            solution.latitude = 40;
+            solution.longitude = 50;
+            solution.altitude = altitude;
+            solution.geoidalSeparation = separation;
+            solution.deviationLatitude = 0.1;
+            solution.deviationLongitude = 0.1;
+            solution.deviationAltitude = 0.1;
+            return solution;
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(GeoidModelSuite, GeoidModelFixture)
+
+BOOST_AUTO_TEST_CASE(it_reads_the_grid_geometry)
+{
+    writeGrid();
+    GeoidModel model(path);
+    BOOST_TEST(model.getWidth() == 12);
+    BOOST_TEST(model.getHeight() == 7);
+    BOOST_TEST(model.getLatitudeResolution() == 30);
+    BOOST_TEST(model.getLongitudeResolution() == 30);
+    BOOST_TEST(model.getInterpolation() == GeoidModel::INTERPOLATION_BILINEAR);
+}
+
+BOOST_AUTO_TEST_CASE(it_returns_the_grid_values_on_the_nodes)
+{
+    writeGrid();
+    GeoidModel model(path);
+    for (int row = 0; row < 7; ++row) {
+        for (int column = 0; column < 12; ++column) {
+            double latitude = 90 - row * 30;
+            double longitude = column * 30;
+            BOOST_TEST(model.getSeparation(latitude, longitude) ==
+                       syntheticSeparation(latitude, longitude),
+                       boost::test_tools::tolerance(1e-9));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(it_interpolates_between_the_nodes)
+{
+    writeGrid();
+    GeoidModel bilinear(path);
+    GeoidModel bicubic(path, GeoidModel::INTERPOLATION_BICUBIC);
+    for (double latitude = -55; latitude < 55; latitude += 7.3) {
+        for (double longitude = 35; longitude < 295; longitude += 11.1) {
+            double expected = syntheticSeparation(latitude, longitude);
+            BOOST_TEST(bilinear.getSeparation(latitude, longitude) == expected,
+                       boost::test_tools::tolerance(1e-9));
+            BOOST_TEST(bicubic.getSeparation(latitude, longitude) == expected,
+                       boost::test_tools::tolerance(1e-9));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(it_wraps_around_in_longitude)
+{
+    writeGrid();
+    GeoidModel model(path);
+    BOOST_TEST(model.getSeparation(10, -30) == model.getSeparation(10, 330));
+    BOOST_TEST(model.getSeparation(10, 360) == model.getSeparation(10, 0));
+
+    // Halfway between the last column and the first one
+    double expected = (syntheticSeparation(30, 330) + syntheticSeparation(30, 0)) / 2;
+    BOOST_TEST(model.getSeparation(30, 345) == expected,
+               boost::test_tools::tolerance(1e-9));
+}
+
+BOOST_AUTO_TEST_CASE(it_returns_NaN_for_invalid_coordinates)
+{
+    writeGrid();
+    GeoidModel model(path);
+    BOOST_TEST(std::isnan(model.getSeparation(NAN, 10)));
+    BOOST_TEST(std::isnan(model.getSeparation(10, NAN)));
+    BOOST_TEST(std::isnan(model.getSeparation(91, 10)));
+}
+
+BOOST_AUTO_TEST_CASE(the_batch_lookup_matches_the_single_lookup)
+{
+    writeGrid();
+    for (auto interpolation : { GeoidModel::INTERPOLATION_BILINEAR,
+                                GeoidModel::INTERPOLATION_BICUBIC }) {
+        GeoidModel model(path, interpolation);
+
+        vector<double> latitudes, longitudes;
+        for (int i = 0; i < 100; ++i) {
+            latitudes.push_back(-80 + i * 1.7);
+            longitudes.push_back(-170 + i * i * 0.3);
+        }
+        latitudes[50] = NAN;
+
+        vector<double> separations(latitudes.size());
+        model.getSeparations(latitudes.size(), latitudes.data(), longitudes.data(),
+                             separations.data());
+        for (size_t i = 0; i < latitudes.size(); ++i) {
+            double expected = model.getSeparation(latitudes[i], longitudes[i]);
+            if (std::isnan(expected)) {
+                BOOST_TEST(std::isnan(separations[i]));
+            }
+            else {
+                BOOST_TEST(separations[i] == expected);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(it_rejects_invalid_files)
+{
+    BOOST_REQUIRE_THROW(GeoidModel("/does/not/exist"), std::runtime_error);
+
+    writeGrid("P2\n# Offset -100\n# Scale 0.01\n");
+    BOOST_REQUIRE_THROW(GeoidModel model(path), std::runtime_error);
+
+    writeGrid("P5\n# Offset -100\n");
+    BOOST_REQUIRE_THROW(GeoidModel model(path), std::runtime_error);
+
+    writeGrid();
+    truncate(path.c_str(), 100);
+    BOOST_REQUIRE_THROW(GeoidModel model(path), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(the_converter_outputs_orthometric_heights_by_default)
+{
+    writeGrid();
+    UTMConverter converter;
+    BOOST_TEST(converter.getHeightReference() == HEIGHT_ORTHOMETRIC);
+
+    // Without a model, the altitude is passed through
+    BOOST_TEST(converter.convertToUTM(makeSolution(10, -3)).position.z() == 10);
+
+    // With a model, the solution's separation is replaced by the model's
+    double modelSeparation = syntheticSeparation(40, 50);
+    converter.setGeoidModel(make_shared<GeoidModel>(path));
+    auto utm = converter.convertToUTM(makeSolution(10, -3));
+    BOOST_TEST(utm.position.z() == 10 - 3 - modelSeparation,
+               boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(converter.convertToUTM(makeSolution(10, NAN)).position.z() == 10,
+               boost::test_tools::tolerance(1e-9));
+
+    auto solution = converter.convertUTMToGPS(utm);
+    BOOST_TEST(solution.altitude == 10 - 3 - modelSeparation,
+               boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(solution.geoidalSeparation == modelSeparation,
+               boost::test_tools::tolerance(1e-9));
+}
+
+BOOST_AUTO_TEST_CASE(the_converter_outputs_ellipsoidal_heights)
+{
+    writeGrid();
+    UTMConversionParameters parameters;
+    parameters.height_reference = HEIGHT_ELLIPSOIDAL;
+    UTMConverter converter(parameters);
+    BOOST_TEST(converter.getParameters().height_reference == HEIGHT_ELLIPSOIDAL);
+
+    auto utm = converter.convertToUTM(makeSolution(10, -3));
+    BOOST_TEST(utm.position.z() == 7);
+    auto solution = converter.convertUTMToGPS(utm);
+    BOOST_TEST(solution.altitude == 7);
+    BOOST_TEST(solution.geoidalSeparation == 0);
+
+    double modelSeparation = syntheticSeparation(40, 50);
+    converter.setGeoidModel(make_shared<GeoidModel>(path));
+    BOOST_TEST(converter.convertToUTM(makeSolution(10, -3)).position.z() == 7,
+               boost::test_tools::tolerance(1e-9));
+    utm = converter.convertToUTM(makeSolution(10, NAN));
+    BOOST_TEST(utm.position.z() == 10 + modelSeparation,
+               boost::test_tools::tolerance(1e-9));
+
+    solution = converter.convertUTMToGPS(utm);
+    BOOST_TEST(solution.altitude == 10, boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(solution.geoidalSeparation == modelSeparation,
+               boost::test_tools::tolerance(1e-9));
+}
+
+BOOST_AUTO_TEST_CASE(the_batch_and_array_conversions_apply_the_height_reference)
+{
+    writeGrid();
+    UTMConverter converter;
+    converter.setHeightReference(HEIGHT_ELLIPSOIDAL);
+    converter.setGeoidModel(make_shared<GeoidModel>(path));
+
+    vector<Solution> solutions = { makeSolution(10, -3), makeSolution(10, NAN) };
+    solutions[1].latitude = 41;
+    auto utm = converter.convertToUTM(solutions);
+    auto grid = converter.convertToNWUWithGrid(solutions);
+    double latitudes[2], longitudes[2], altitudes[2], separations[2], heights[2];
+    for (int i = 0; i < 2; ++i) {
+        double expected = converter.convertToUTM(solutions[i]).position.z();
+        BOOST_TEST(utm[i].position.z() == expected, boost::test_tools::tolerance(1e-9));
+        BOOST_TEST(grid[i].position.z() == expected, boost::test_tools::tolerance(1e-9));
+
+        latitudes[i] = solutions[i].latitude;
+        longitudes[i] = solutions[i].longitude;
+        altitudes[i] = solutions[i].altitude;
+        separations[i] = solutions[i].geoidalSeparation;
+    }
+
+    converter.convertHeights(2, latitudes, longitudes, altitudes, separations, heights);
+    for (int i = 0; i < 2; ++i) {
+        BOOST_TEST(heights[i] == utm[i].position.z(), boost::test_tools::tolerance(1e-9));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
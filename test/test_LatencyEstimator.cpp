@@ -0,0 +1,51 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/LatencyEstimator.hpp>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    base::Time ms(int value) {
+        return base::Time::fromMilliseconds(value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LatencyEstimator_estimates_the_minimum_latency_over_the_window) {
+    LatencyEstimator estimator(base::Time::fromSeconds(1.0));
+    base::Time start = base::Time::fromSeconds(1000.0);
+    int latencies[] = { 80, 50, 70, 60, 90 };
+    for (int i = 0; i < 5; ++i) {
+        base::Time solutionTime = start + ms(100 * i);
+        estimator.update(solutionTime, solutionTime + ms(latencies[i]));
+    }
+    BOOST_TEST(estimator.getSampleCount() == 5);
+    BOOST_TEST(estimator.getLatency() == ms(50));
+    BOOST_TEST(estimator.toCPUTime(start) == start + ms(50));
+}
+
+BOOST_AUTO_TEST_CASE(LatencyEstimator_forgets_samples_older_than_the_window) {
+    LatencyEstimator estimator(base::Time::fromSeconds(1.0));
+    base::Time start = base::Time::fromSeconds(1000.0);
+    estimator.update(start, start + ms(10));
+    for (int i = 1; i < 20; ++i) {
+        base::Time solutionTime = start + ms(100 * i);
+        estimator.update(solutionTime, solutionTime + ms(40));
+    }
+    BOOST_TEST(estimator.getLatency() == ms(40));
+}
+
+BOOST_AUTO_TEST_CASE(LatencyEstimator_tracks_the_mean_and_jitter) {
+    LatencyEstimator estimator(base::Time::fromSeconds(1.0), 0.5);
+    base::Time start = base::Time::fromSeconds(1000.0);
+    for (int i = 0; i < 100; ++i) {
+        base::Time solutionTime = start + ms(100 * i);
+        estimator.update(solutionTime, solutionTime + ms(50));
+    }
+    BOOST_TEST(estimator.getMeanLatency() == ms(50));
+    BOOST_TEST(estimator.getJitter() == base::Time());
+}
+
+BOOST_AUTO_TEST_CASE(LatencyEstimator_returns_a_null_latency_without_samples) {
+    LatencyEstimator estimator;
+    BOOST_TEST(estimator.getLatency().isNull());
+}
@@ -0,0 +1,218 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/RTCMCaster.hpp>
+#include <gps_base/rtcm3.hpp>
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    vector<uint8_t> makeFrame(uint32_t sequence, size_t payloadSize) {
+        vector<uint8_t> frame = {
+            rtcm3::PREAMBLE,
+            static_cast<uint8_t>((payloadSize >> 8) & 0x03),
+            static_cast<uint8_t>(payloadSize & 0xFF)
+        };
+        for (size_t i = 0; i < payloadSize; ++i) {
+            frame.push_back(i < 4 ? (sequence >> (8 * i)) & 0xFF : i & 0xFF);
+        }
+        uint32_t crc = rtcm3::crc(frame.data(), frame.size());
+        frame.push_back((crc >> 16) & 0xFF);
+        frame.push_back((crc >> 8) & 0xFF);
+        frame.push_back(crc & 0xFF);
+        return frame;
+    }
+
+    uint32_t getSequence(uint8_t const* frame) {
+        return frame[3] | frame[4] << 8 | frame[5] << 16 | frame[6] << 24;
+    }
+
+    RTCMCasterConfiguration makeConfiguration(unsigned int reactors = 1) {
+        RTCMCasterConfiguration configuration;
+        configuration.address = "127.0.0.1";
+        configuration.port = 0;
+        configuration.reactors = reactors;
+        return configuration;
+    }
+
+    /** Connect a blocking client, with a receive timeout */
+    int connectClient(uint16_t port, int receiveBuffer = 0) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (receiveBuffer) {
+            setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+        }
+        timeval timeout = { 1, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        BOOST_REQUIRE(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+        return fd;
+    }
+
+    /** Read until the connection stays silent for the receive timeout, or
+     * until @a size bytes have been received
+     */
+    vector<uint8_t> receive(int fd, size_t size) {
+        vector<uint8_t> result;
+        uint8_t buffer[4096];
+        while (result.size() < size) {
+            ssize_t received = read(fd, buffer, sizeof(buffer));
+            if (received <= 0) {
+                break;
+            }
+            result.insert(result.end(), buffer, buffer + received);
+        }
+        return result;
+    }
+
+    void waitFor(RTCMCaster const& caster,
+                 function<bool(RTCMCasterStatistics const&)> predicate) {
+        auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+        while (!predicate(caster.getStatistics())) {
+            BOOST_REQUIRE(chrono::steady_clock::now() < deadline);
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(the_caster_binds_to_a_free_port_if_given_port_zero)
+{
+    RTCMCaster caster(makeConfiguration());
+    BOOST_TEST(caster.getPort() != 0);
+}
+
+BOOST_AUTO_TEST_CASE(the_caster_rejects_invalid_configurations)
+{
+    auto configuration = makeConfiguration(0);
+    BOOST_REQUIRE_THROW(RTCMCaster caster(configuration), std::invalid_argument);
+
+    configuration = makeConfiguration();
+    configuration.maxQueuedBytes = RTCMCaster::MAX_FRAME_SIZE - 1;
+    BOOST_REQUIRE_THROW(RTCMCaster caster(configuration), std::invalid_argument);
+
+    configuration = makeConfiguration();
+    configuration.address = "not an address";
+    BOOST_REQUIRE_THROW(RTCMCaster caster(configuration), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(the_caster_sends_the_pushed_frames_to_all_clients)
+{
+    for (unsigned int reactors : { 1, 3 }) {
+        RTCMCaster caster(makeConfiguration(reactors));
+        vector<int> clients;
+        for (int i = 0; i < 5; ++i) {
+            clients.push_back(connectClient(caster.getPort()));
+        }
+        waitFor(caster, [](RTCMCasterStatistics const& s) { return s.clients == 5; });
+
+        vector<uint8_t> expected;
+        vector<uint8_t> stream = { 0x00, 0x42 };
+        for (int i = 0; i < 3; ++i) {
+            auto frame = makeFrame(i, 10 + i * 100);
+            expected.insert(expected.end(), frame.begin(), frame.end());
+            stream.insert(stream.end(), frame.begin(), frame.end());
+        }
+        // Frames split across calls are reassembled
+        BOOST_TEST(caster.push(stream.data(), 10) == 0);
+        BOOST_TEST(caster.push(stream.data() + 10, stream.size() - 10) == 3);
+
+        for (int fd : clients) {
+            BOOST_TEST(receive(fd, expected.size()) == expected);
+            close(fd);
+        }
+        // The counters are updated after the data is sent
+        size_t sentBytes = 5 * expected.size();
+        waitFor(caster, [sentBytes](RTCMCasterStatistics const& s) {
+            return s.sentBytes == sentBytes;
+        });
+        auto statistics = caster.getStatistics();
+        BOOST_TEST(statistics.frames == 3);
+        BOOST_TEST(statistics.acceptedClients == 5);
+        BOOST_TEST(statistics.droppedFrames == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(the_caster_drops_whole_frames_for_clients_that_do_not_keep_up)
+{
+    auto configuration = makeConfiguration();
+    configuration.maxQueuedBytes = RTCMCaster::MAX_FRAME_SIZE;
+    RTCMCaster caster(configuration);
+    int fd = connectClient(caster.getPort(), 4096);
+    waitFor(caster, [](RTCMCasterStatistics const& s) { return s.clients == 1; });
+
+    // The client does not read, so the socket buffers end up full
+    uint32_t frames = 0;
+    while (caster.getStatistics().droppedFrames < 10) {
+        BOOST_REQUIRE(frames < 100000);
+        caster.broadcast(make_shared<vector<uint8_t> const>(makeFrame(frames++, 1023)));
+        this_thread::sleep_for(chrono::microseconds(100));
+    }
+
+    // Once the client catches up, it receives the new frames again
+    auto data = receive(fd, numeric_limits<size_t>::max());
+    for (int i = 0; i < 5; ++i) {
+        caster.broadcast(make_shared<vector<uint8_t> const>(makeFrame(frames++, 1023)));
+    }
+    auto last = receive(fd, 5 * RTCMCaster::MAX_FRAME_SIZE);
+    data.insert(data.end(), last.begin(), last.end());
+    close(fd);
+    size_t received = data.size();
+    waitFor(caster, [received](RTCMCasterStatistics const& s) {
+        return s.sentBytes == received;
+    });
+    auto statistics = caster.getStatistics();
+    BOOST_TEST(statistics.frames == frames);
+    BOOST_TEST(data.size() == (frames - statistics.droppedFrames) * RTCMCaster::MAX_FRAME_SIZE);
+
+    // The client received only complete frames, in order, with gaps
+    uint32_t lastSequence = 0;
+    bool hasGap = false;
+    for (size_t offset = 0; offset < data.size(); offset += RTCMCaster::MAX_FRAME_SIZE) {
+        int size = rtcm3::extractPacket(data.data() + offset, data.size() - offset);
+        BOOST_REQUIRE(size == static_cast<int>(RTCMCaster::MAX_FRAME_SIZE));
+        uint32_t sequence = getSequence(data.data() + offset);
+        if (offset != 0) {
+            BOOST_REQUIRE(sequence > lastSequence);
+            hasGap = hasGap || (sequence != lastSequence + 1);
+        }
+        lastSequence = sequence;
+    }
+    BOOST_TEST(hasGap);
+}
+
+BOOST_AUTO_TEST_CASE(the_caster_tracks_the_disconnections)
+{
+    RTCMCaster caster(makeConfiguration(2));
+    int first = connectClient(caster.getPort());
+    int second = connectClient(caster.getPort());
+    waitFor(caster, [](RTCMCasterStatistics const& s) { return s.clients == 2; });
+
+    close(first);
+    waitFor(caster, [](RTCMCasterStatistics const& s) { return s.disconnectedClients == 1; });
+    BOOST_TEST(caster.getStatistics().clients == 1);
+
+    // The remaining client is disconnected when the caster stops
+    caster.stop();
+    caster.stop();
+    BOOST_TEST(receive(second, 1).empty());
+    close(second);
+    auto statistics = caster.getStatistics();
+    BOOST_TEST(statistics.clients == 0);
+    BOOST_TEST(statistics.disconnectedClients == 2);
+
+    // Frames broadcast after stop() are ignored
+    caster.broadcast(make_shared<vector<uint8_t> const>(makeFrame(0, 10)));
+    BOOST_TEST(caster.getStatistics().frames == 0);
+}
@@ -0,0 +1,162 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/SolutionHistory.hpp>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    base::Time at(int ms) {
+        return base::Time::fromMilliseconds(1000000 + ms);
+    }
+
+    Solution makeSolution(int ms, double latitude, double longitude) {
+        Solution solution;
+        solution.time = at(ms);
+        solution.positionType = RTK_FIXED;
+        solution.noOfSatellites = 12;
+        solution.latitude = latitude;
+        solution.longitude = longitude;
+        solution.altitude = 2;
+        solution.geoidalSeparation = -10;
+        solution.ageOfDifferentialCorrections = 1;
+        solution.deviationLatitude = 0.1;
+        solution.deviationLongitude = 0.2;
+        solution.deviationAltitude = 0.3;
+        return solution;
+    }
+
+    SolutionHistory fixtureHistory() {
+        SolutionHistory history(10);
+        history.push(makeSolution(0, -13.0, -38.6));
+        history.push(makeSolution(100, -13.1, -38.8));
+        history.push(makeSolution(200, -13.2, -38.6));
+        return history;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SolutionHistory_drops_the_oldest_solutions_once_full) {
+    SolutionHistory history(3);
+    for (int i = 0; i < 5; ++i) {
+        BOOST_TEST(history.push(makeSolution(i * 100, i, 0)));
+    }
+    BOOST_REQUIRE_EQUAL(3, history.size());
+    BOOST_TEST(history[0].latitude == 2);
+    BOOST_TEST(history[2].latitude == 4);
+}
+
+BOOST_AUTO_TEST_CASE(SolutionHistory_rejects_solutions_that_are_not_newer_than_the_last) {
+    auto history = fixtureHistory();
+    BOOST_TEST(!history.push(makeSolution(200, 0, 0)));
+    BOOST_TEST(!history.push(makeSolution(150, 0, 0)));
+    BOOST_TEST(history.size() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(SolutionHistory_interpolates_between_the_neighbouring_solutions) {
+    auto history = fixtureHistory();
+    auto second = makeSolution(100, -13.1, -38.8);
+    second.deviationLatitude = 0.3;
+    second.positionType = RTK_FLOAT;
+    history.clear();
+    history.push(makeSolution(0, -13.0, -38.6));
+    history.push(second);
+
+    Solution result = history.interpolate(at(25));
+    BOOST_TEST(result.time == at(25));
+    BOOST_REQUIRE_CLOSE(result.latitude, -13.025, 1e-9);
+    BOOST_REQUIRE_CLOSE(result.longitude, -38.65, 1e-9);
+    BOOST_REQUIRE_CLOSE(result.deviationLatitude, 0.15, 1e-9);
+    BOOST_TEST(result.positionType == RTK_FLOAT);
+}
+
+BOOST_AUTO_TEST_CASE(SolutionHistory_returns_the_solution_itself_on_an_exact_match) {
+    auto history = fixtureHistory();
+    Solution result = history.interpolate(at(200));
+    BOOST_TEST(result.latitude == -13.2);
+    BOOST_TEST(result.positionType == RTK_FIXED);
+}
+
+BOOST_AUTO_TEST_CASE(SolutionHistory_interpolates_across_the_antimeridian) {
+    SolutionHistory history(2);
+    history.push(makeSolution(0, 0, 179.9));
+    history.push(makeSolution(100, 0, -179.9));
+    BOOST_REQUIRE_CLOSE(history.interpolate(at(25)).longitude, 179.95, 1e-9);
+    BOOST_REQUIRE_CLOSE(history.interpolate(at(75)).longitude, -179.95, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(SolutionHistory_does_not_extrapolate) {
+    auto history = fixtureHistory();
+    BOOST_TEST(history.interpolate(at(-1)).positionType == INVALID);
+    BOOST_TEST(history.interpolate(at(201)).positionType == INVALID);
+    BOOST_TEST(history.interpolate(at(201)).time == at(201));
+}
+
+BOOST_AUTO_TEST_CASE(SolutionHistory_does_not_interpolate_across_invalid_solutions) {
+    SolutionHistory history(10);
+    history.push(makeSolution(0, 0, 0));
+    auto noSolution = makeSolution(100, 0, 0);
+    noSolution.positionType = NO_SOLUTION;
+    history.push(noSolution);
+    history.push(makeSolution(200, 0, 0));
+    auto invalid = makeSolution(300, 0, 0);
+    invalid.positionType = INVALID;
+    history.push(invalid);
+    history.push(makeSolution(400, 0, 0));
+
+    BOOST_TEST(history.interpolate(at(50)).positionType == INVALID);
+    BOOST_TEST(history.interpolate(at(100)).positionType == INVALID);
+    BOOST_TEST(history.interpolate(at(150)).positionType == INVALID);
+    BOOST_TEST(history.interpolate(at(200)).positionType == RTK_FIXED);
+    BOOST_TEST(history.interpolate(at(350)).positionType == INVALID);
+}
+
+BOOST_AUTO_TEST_CASE(SolutionHistory_does_not_interpolate_across_gaps_larger_than_the_maximum) {
+    auto history = fixtureHistory();
+    history.push(makeSolution(1000, 0, 0));
+    history.setMaxGap(base::Time::fromMilliseconds(500));
+    BOOST_TEST(history.interpolate(at(150)).positionType == RTK_FIXED);
+    BOOST_TEST(history.interpolate(at(500)).positionType == INVALID);
+}
+
+BOOST_AUTO_TEST_CASE(SolutionHistory_interpolates_many_timestamps) {
+    auto history = fixtureHistory();
+    vector<base::Time> times = { at(-10), at(50), at(150), at(120), at(300) };
+    auto results = history.interpolate(times);
+    BOOST_REQUIRE_EQUAL(5, results.size());
+    BOOST_TEST(results[0].positionType == INVALID);
+    BOOST_REQUIRE_CLOSE(results[1].latitude, -13.05, 1e-9);
+    BOOST_REQUIRE_CLOSE(results[2].latitude, -13.15, 1e-9);
+    BOOST_REQUIRE_CLOSE(results[3].latitude, -13.12, 1e-9);
+    BOOST_TEST(results[4].positionType == INVALID);
+    for (size_t i = 0; i < times.size(); ++i) {
+        BOOST_TEST(results[i].time == times[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SolutionHistory_interpolates_in_NWU_through_the_converter) {
+    UTMConverter converter;
+    converter.setUTMZone(24);
+    converter.setUTMNorth(false);
+    converter.setNWUOrigin(base::Position(8550000, 400000, 0));
+
+    auto history = fixtureHistory();
+    history.setConverter(converter);
+
+    auto a = converter.convertToNWU(history[0]);
+    auto b = converter.convertToNWU(history[1]);
+    auto result = history.interpolateNWU(at(25));
+    BOOST_TEST(result.time == at(25));
+    for (int i = 0; i < 3; ++i) {
+        BOOST_REQUIRE_CLOSE(result.position(i), 0.75 * a.position(i) + 0.25 * b.position(i), 1e-9);
+    }
+    BOOST_REQUIRE_CLOSE(result.cov_position(0, 0), a.cov_position(0, 0), 1e-9);
+
+    auto invalid = history.interpolateNWU(vector<base::Time> { at(300) });
+    BOOST_REQUIRE_EQUAL(1, invalid.size());
+    BOOST_TEST(!invalid[0].hasValidPosition());
+    BOOST_TEST(invalid[0].time == at(300));
+}
+
+BOOST_AUTO_TEST_CASE(SolutionHistory_interpolateNWU_throws_without_a_converter) {
+    auto history = fixtureHistory();
+    BOOST_REQUIRE_THROW(history.interpolateNWU(at(50)), std::logic_error);
+}
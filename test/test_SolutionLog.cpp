@@ -0,0 +1,154 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/SolutionLog.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    struct SolutionLogFixture {
+        string path;
+
+        SolutionLogFixture() {
+            char tmpl[] = "/tmp/gps_base_test_SolutionLog_XXXXXX";
+            int fd = mkstemp(tmpl);
+            ::close(fd);
+            path = tmpl;
+        }
+
+        ~SolutionLogFixture() {
+            remove(path.c_str());
+        }
+    };
+
+    Solution makeSolution(int i) {
+        Solution solution;
+        solution.time = base::Time::fromMicroseconds(1600000000000000LL + i * 100000);
+        solution.latitude = -13.057361 + i * 1e-6;
+        solution.longitude = -38.649902 - i * 2e-6;
+        solution.positionType = (i % 3) ? RTK_FIXED : RTK_FLOAT;
+        solution.noOfSatellites = 10 + i % 5;
+        solution.altitude = 2.0 + i * 0.01;
+        solution.geoidalSeparation = -10.5;
+        solution.ageOfDifferentialCorrections = 0.5 + (i % 10) * 0.1;
+        solution.deviationLatitude = 0.02;
+        solution.deviationLongitude = 0.03;
+        solution.deviationAltitude = 0.05;
+        return solution;
+    }
+
+    void requireEquivalent(Solution const& expected, Solution const& actual) {
+        BOOST_REQUIRE_EQUAL(expected.time, actual.time);
+        BOOST_REQUIRE_SMALL(expected.latitude - actual.latitude, 1e-9);
+        BOOST_REQUIRE_SMALL(expected.longitude - actual.longitude, 1e-9);
+        BOOST_REQUIRE_SMALL(expected.altitude - actual.altitude, 1e-4);
+        BOOST_REQUIRE_EQUAL(expected.positionType, actual.positionType);
+        BOOST_REQUIRE_EQUAL(expected.noOfSatellites, actual.noOfSatellites);
+        BOOST_REQUIRE_CLOSE(expected.geoidalSeparation, actual.geoidalSeparation, 1e-4);
+        BOOST_REQUIRE_CLOSE(expected.ageOfDifferentialCorrections,
+                            actual.ageOfDifferentialCorrections, 1e-4);
+        BOOST_REQUIRE_CLOSE(expected.deviationLatitude, actual.deviationLatitude, 1e-4);
+        BOOST_REQUIRE_CLOSE(expected.deviationLongitude, actual.deviationLongitude, 1e-4);
+        BOOST_REQUIRE_CLOSE(expected.deviationAltitude, actual.deviationAltitude, 1e-4);
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE(SolutionLog, SolutionLogFixture)
+
+BOOST_AUTO_TEST_CASE(it_reads_back_the_written_solutions) {
+    {
+        SolutionLogWriter writer(path, 16);
+        for (int i = 0; i < 100; ++i) {
+            writer.write(makeSolution(i));
+        }
+    }
+
+    SolutionLogReader reader(path);
+    BOOST_REQUIRE_EQUAL(100, reader.getSolutionCount());
+    BOOST_REQUIRE_EQUAL(7, reader.getBlockCount());
+    BOOST_REQUIRE_EQUAL(4, reader.getBlockInfo(6).count);
+
+    auto solutions = reader.readAll();
+    BOOST_REQUIRE_EQUAL(100, solutions.size());
+    for (int i = 0; i < 100; ++i) {
+        requireEquivalent(makeSolution(i), solutions[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(it_stores_less_than_half_of_the_in_memory_size) {
+    {
+        SolutionLogWriter writer(path);
+        for (int i = 0; i < 1000; ++i) {
+            writer.write(makeSolution(i));
+        }
+    }
+
+    ifstream file(path, ios::binary | ios::ate);
+    BOOST_TEST(file.tellg() < 1000 * sizeof(Solution) / 2);
+}
+
+BOOST_AUTO_TEST_CASE(it_preserves_unknown_values) {
+    Solution solution = makeSolution(0);
+    solution.latitude = base::unknown<double>();
+    solution.altitude = base::unknown<double>();
+    solution.ageOfDifferentialCorrections = base::unknown<double>();
+    solution.noOfSatellites = -1;
+    {
+        SolutionLogWriter writer(path);
+        writer.write(makeSolution(1));
+        writer.write(solution);
+        writer.write(makeSolution(2));
+    }
+
+    auto solutions = SolutionLogReader(path).readAll();
+    BOOST_REQUIRE_EQUAL(3, solutions.size());
+    BOOST_TEST(base::isUnknown(solutions[1].latitude));
+    BOOST_TEST(base::isUnknown(solutions[1].altitude));
+    BOOST_TEST(base::isUnknown(solutions[1].ageOfDifferentialCorrections));
+    BOOST_TEST(solutions[1].noOfSatellites == -1);
+    requireEquivalent(makeSolution(2), solutions[2]);
+}
+
+BOOST_AUTO_TEST_CASE(it_decodes_blocks_into_columns) {
+    {
+        SolutionLogWriter writer(path, 10);
+        for (int i = 0; i < 20; ++i) {
+            writer.write(makeSolution(i));
+        }
+    }
+
+    SolutionLogReader reader(path);
+    SolutionColumns columns;
+    reader.readBlock(1, columns);
+    BOOST_REQUIRE_EQUAL(10, columns.size());
+    BOOST_REQUIRE_SMALL(columns.latitude[0] - makeSolution(10).latitude, 1e-9);
+    requireEquivalent(makeSolution(15), columns.get(5));
+}
+
+BOOST_AUTO_TEST_CASE(it_finds_the_block_of_a_given_time) {
+    {
+        SolutionLogWriter writer(path, 10);
+        for (int i = 0; i < 30; ++i) {
+            writer.write(makeSolution(i));
+        }
+    }
+
+    SolutionLogReader reader(path);
+    BOOST_TEST(reader.findBlock(base::Time()) == 0);
+    BOOST_TEST(reader.findBlock(makeSolution(9).time) == 0);
+    BOOST_TEST(reader.findBlock(makeSolution(9).time + base::Time::fromMicroseconds(1)) == 1);
+    BOOST_TEST(reader.findBlock(makeSolution(25).time) == 2);
+    BOOST_TEST(reader.findBlock(makeSolution(30).time) == 3);
+}
+
+BOOST_AUTO_TEST_CASE(it_refuses_to_open_a_log_that_was_not_closed) {
+    SolutionLogWriter writer(path);
+    writer.write(makeSolution(0));
+    writer.flush();
+    BOOST_REQUIRE_THROW(SolutionLogReader reader(path), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,196 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/SpatialIndex.hpp>
+#include <base/Float.hpp>
+#include <algorithm>
+#include <random>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    UTMConverter fixtureConverter() {
+        UTMConversionParameters parameters;
+        parameters.utm_zone = 24;
+        parameters.utm_north = false;
+        parameters.nwu_origin = base::Position(8550000, 400000, 0);
+        return UTMConverter(parameters);
+    }
+
+    Solution makeSolution(double latitude, double longitude) {
+        Solution solution;
+        solution.positionType = AUTONOMOUS;
+        solution.latitude = latitude;
+        solution.longitude = longitude;
+        solution.altitude = 0;
+        return solution;
+    }
+
+    /** Random solutions within a few kilometers */
+    vector<Solution> fixtureSolutions(size_t count) {
+        mt19937 rng(42);
+        uniform_real_distribution<double> offset(-0.02, 0.02);
+        vector<Solution> solutions;
+        for (size_t i = 0; i < count; ++i) {
+            solutions.push_back(makeSolution(-13.05 + offset(rng), -38.65 + offset(rng)));
+        }
+        return solutions;
+    }
+
+    vector<SpatialIndex::Match> bruteForce(vector<base::Position> const& nwu,
+                                           base::Position const& query) {
+        vector<SpatialIndex::Match> result;
+        for (size_t i = 0; i < nwu.size(); ++i) {
+            double d = (nwu[i] - query).head<2>().norm();
+            result.push_back(SpatialIndex::Match { i, d });
+        }
+        sort(result.begin(), result.end(),
+             [](SpatialIndex::Match const& a, SpatialIndex::Match const& b) {
+                 return a.distance < b.distance;
+             });
+        return result;
+    }
+
+    vector<base::Position> toNWU(vector<Solution> const& solutions) {
+        UTMConverter converter = fixtureConverter();
+        vector<base::Position> result;
+        for (auto const& s : solutions) {
+            result.push_back(converter.convertToNWU(s).position);
+        }
+        return result;
+    }
+
+    void requireSameMatches(vector<SpatialIndex::Match> const& expected,
+                            vector<SpatialIndex::Match> const& actual) {
+        BOOST_REQUIRE_EQUAL(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            BOOST_TEST(expected[i].index == actual[i].index);
+            BOOST_TEST(expected[i].distance == actual[i].distance,
+                       boost::test_tools::tolerance(1e-9));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(spatial_index_returns_the_k_nearest_positions) {
+    auto solutions = fixtureSolutions(1000);
+    auto nwu = toNWU(solutions);
+    SpatialIndex index(fixtureConverter());
+    index.build(solutions);
+    BOOST_TEST(index.size() == 1000);
+
+    for (size_t i = 0; i < 20; ++i) {
+        auto query = nwu[i * 37] + base::Position(3, -5, 0);
+        auto expected = bruteForce(nwu, query);
+        expected.resize(10);
+        requireSameMatches(expected, index.nearest(query, 10));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(spatial_index_accepts_solutions_as_queries) {
+    auto solutions = fixtureSolutions(100);
+    SpatialIndex index(fixtureConverter());
+    index.build(solutions);
+
+    auto matches = index.nearest(solutions[42], 1);
+    BOOST_REQUIRE_EQUAL(1, matches.size());
+    BOOST_TEST(matches[0].index == 42);
+    BOOST_REQUIRE_SMALL(matches[0].distance, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(spatial_index_returns_all_positions_within_a_radius) {
+    auto solutions = fixtureSolutions(1000);
+    auto nwu = toNWU(solutions);
+    SpatialIndex index(fixtureConverter());
+    index.build(solutions);
+
+    auto query = nwu[10];
+    auto expected = bruteForce(nwu, query);
+    expected.erase(
+        find_if(expected.begin(), expected.end(),
+                [](SpatialIndex::Match const& m) { return m.distance > 300; }),
+        expected.end());
+    BOOST_REQUIRE(expected.size() > 1);
+    requireSameMatches(expected, index.radius(solutions[10], 300));
+}
+
+BOOST_AUTO_TEST_CASE(spatial_index_returns_all_positions_if_k_is_bigger_than_the_index) {
+    auto solutions = fixtureSolutions(5);
+    SpatialIndex index(fixtureConverter());
+    index.build(solutions);
+    BOOST_TEST(index.nearest(solutions[0], 10).size() == 5);
+    BOOST_TEST(index.nearest(solutions[0], 0).empty());
+}
+
+BOOST_AUTO_TEST_CASE(spatial_index_gives_an_index_to_invalid_solutions_but_never_returns_them) {
+    auto solutions = fixtureSolutions(10);
+    solutions[3].positionType = NO_SOLUTION;
+    solutions[5].positionType = INVALID;
+    solutions[7].latitude = base::unknown<double>();
+    SpatialIndex index(fixtureConverter());
+    index.build(solutions);
+    BOOST_TEST(index.size() == 10);
+
+    auto matches = index.nearest(solutions[0], 10);
+    BOOST_REQUIRE_EQUAL(7, matches.size());
+    for (auto const& m : matches) {
+        BOOST_TEST(m.index != 3);
+        BOOST_TEST(m.index != 5);
+        BOOST_TEST(m.index != 7);
+    }
+
+    Solution invalid = makeSolution(-13.05, -38.65);
+    invalid.positionType = NO_SOLUTION;
+    BOOST_TEST(index.insert(invalid) == 10);
+    BOOST_TEST(index.nearest(invalid, 1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(spatial_index_incremental_insertions_give_the_same_results_as_a_bulk_build) {
+    auto solutions = fixtureSolutions(3000);
+    auto nwu = toNWU(solutions);
+
+    SpatialIndex bulk(fixtureConverter());
+    bulk.build(vector<Solution>(solutions.begin(), solutions.begin() + 1000));
+    SpatialIndex incremental(fixtureConverter());
+    for (size_t i = 0; i < 1000; ++i) {
+        BOOST_TEST(incremental.insert(solutions[i]) == i);
+    }
+    for (size_t i = 1000; i < solutions.size(); ++i) {
+        BOOST_TEST(bulk.insert(solutions[i]) == i);
+        BOOST_TEST(incremental.insert(nwu[i]) == i);
+    }
+    BOOST_TEST(incremental.getTreeCount() > 1);
+
+    for (size_t i = 0; i < 20; ++i) {
+        auto query = nwu[i * 131] + base::Position(-2, 7, 0);
+        auto expected = bruteForce(nwu, query);
+        expected.resize(5);
+        requireSameMatches(expected, bulk.nearest(query, 5));
+        requireSameMatches(expected, incremental.nearest(query, 5));
+    }
+
+    incremental.optimize();
+    BOOST_TEST(incremental.getTreeCount() == 1);
+    auto query = nwu[17];
+    auto expected = bruteForce(nwu, query);
+    expected.resize(5);
+    requireSameMatches(expected, incremental.nearest(query, 5));
+}
+
+BOOST_AUTO_TEST_CASE(spatial_index_bounds_the_number_of_trees) {
+    auto solutions = fixtureSolutions(20000);
+    SpatialIndex index(fixtureConverter());
+    for (auto const& s : solutions) {
+        index.insert(s);
+    }
+    // 20000 / INSERT_BUFFER_SIZE flushes, with trees sizes more than
+    // doubling
+    BOOST_TEST(index.getTreeCount() <= 8);
+}
+
+BOOST_AUTO_TEST_CASE(spatial_index_clear_removes_all_positions) {
+    auto solutions = fixtureSolutions(100);
+    SpatialIndex index(fixtureConverter());
+    index.build(solutions);
+    index.clear();
+    BOOST_TEST(index.size() == 0);
+    BOOST_TEST(index.nearest(solutions[0], 1).empty());
+}
@@ -0,0 +1,234 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/TrajectoryPipeline.hpp>
+
+#include <cstdio>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    UTMConverter fixtureConverter() {
+        UTMConversionParameters parameters;
+        parameters.utm_zone = 24;
+        parameters.utm_north = false;
+        parameters.nwu_origin = base::Position(8550000, 400000, 0);
+        return UTMConverter(parameters);
+    }
+
+    Solution makeSolution(int i) {
+        Solution solution;
+        solution.time = base::Time::fromMicroseconds(1600000000000000LL + i * 100000);
+        solution.latitude = -13.057361 + i * 1e-6;
+        solution.longitude = -38.649902 - i * 2e-6;
+        solution.positionType = (i % 3) ? RTK_FIXED : RTK_FLOAT;
+        solution.noOfSatellites = 10;
+        solution.altitude = 2.0 + i * 0.01;
+        solution.geoidalSeparation = -10.5;
+        solution.ageOfDifferentialCorrections = (i % 10) * 0.5;
+        solution.deviationLatitude = 0.02;
+        solution.deviationLongitude = 0.03;
+        solution.deviationAltitude = (i % 7) ? 0.05 : 0.5;
+        return solution;
+    }
+
+    vector<Solution> fixtureSolutions(int count) {
+        vector<Solution> solutions;
+        for (int i = 0; i < count; ++i) {
+            solutions.push_back(makeSolution(i));
+        }
+        return solutions;
+    }
+
+    struct Collector {
+        TrajectoryColumns result;
+
+        TrajectoryPipeline::Sink sink() {
+            return [this](TrajectoryColumns const& columns) {
+                size_t offset = result.size();
+                result.resize(offset + columns.size());
+                for (size_t i = 0; i < columns.size(); ++i) {
+                    result.time[offset + i] = columns.time[i];
+                    result.x[offset + i] = columns.x[i];
+                    result.y[offset + i] = columns.y[i];
+                    result.z[offset + i] = columns.z[i];
+                    result.deviationX[offset + i] = columns.deviationX[i];
+                    result.deviationY[offset + i] = columns.deviationY[i];
+                    result.deviationZ[offset + i] = columns.deviationZ[i];
+                    result.positionType[offset + i] = columns.positionType[i];
+                }
+            };
+        }
+    };
+
+    TrajectoryPipelineConfiguration fixtureConfiguration() {
+        TrajectoryPipelineConfiguration configuration;
+        configuration.threads = 4;
+        configuration.chunkSize = 7;
+        return configuration;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(trajectory_pipeline_converts_all_solutions_in_order) {
+    auto solutions = fixtureSolutions(1000);
+    TrajectoryPipeline pipeline(fixtureConverter(), fixtureConfiguration());
+    Collector collector;
+    auto statistics = pipeline.run(solutions, collector.sink());
+
+    BOOST_REQUIRE_EQUAL(1000, collector.result.size());
+    auto converter = fixtureConverter();
+    for (size_t i = 0; i < solutions.size(); ++i) {
+        auto expected = converter.convertToNWU(solutions[i]);
+        BOOST_TEST(collector.result.time[i] == solutions[i].time);
+        BOOST_REQUIRE_SMALL(collector.result.x[i] - expected.position.x(), 1e-6);
+        BOOST_REQUIRE_SMALL(collector.result.y[i] - expected.position.y(), 1e-6);
+        BOOST_REQUIRE_SMALL(collector.result.z[i] - expected.position.z(), 1e-6);
+        BOOST_TEST(collector.result.deviationX[i] == solutions[i].deviationLatitude);
+        BOOST_TEST(collector.result.deviationY[i] == solutions[i].deviationLongitude);
+        BOOST_TEST(collector.result.positionType[i] == solutions[i].positionType);
+    }
+
+    BOOST_TEST(statistics.chunks == 143);
+    BOOST_TEST(statistics.decode.input == 1000);
+    BOOST_TEST(statistics.filter.output == 1000);
+    BOOST_TEST(statistics.convert.output == 1000);
+    BOOST_TEST(statistics.output.output == 1000);
+}
+
+BOOST_AUTO_TEST_CASE(trajectory_pipeline_filters_the_solutions) {
+    auto solutions = fixtureSolutions(1000);
+    solutions[1].positionType = NO_SOLUTION;
+    auto configuration = fixtureConfiguration();
+    configuration.filter.positionTypes =
+        TrajectoryFilter::positionTypeBit(RTK_FIXED) |
+        TrajectoryFilter::positionTypeBit(NO_SOLUTION);
+    configuration.filter.maxCorrectionAge = 2;
+    configuration.filter.maxVerticalDeviation = 0.1;
+    solutions[2].ageOfDifferentialCorrections = base::unknown<double>();
+
+    TrajectoryPipeline pipeline(fixtureConverter(), configuration);
+    Collector collector;
+    auto statistics = pipeline.run(solutions, collector.sink());
+
+    vector<base::Time> expected;
+    for (auto const& s : solutions) {
+        if (s.positionType == RTK_FIXED && s.ageOfDifferentialCorrections <= 2 &&
+            s.deviationAltitude <= 0.1) {
+            expected.push_back(s.time);
+        }
+    }
+    BOOST_REQUIRE(!expected.empty());
+    BOOST_TEST(collector.result.time == expected, boost::test_tools::per_element());
+    BOOST_TEST(statistics.filter.input == 1000);
+    BOOST_TEST(statistics.filter.output == expected.size());
+    BOOST_TEST(statistics.convert.output == expected.size());
+}
+
+BOOST_AUTO_TEST_CASE(trajectory_pipeline_filters_on_the_horizontal_deviation) {
+    auto solutions = fixtureSolutions(10);
+    solutions[4].deviationLatitude = 0.4;
+    solutions[4].deviationLongitude = 0.4;
+    auto configuration = fixtureConfiguration();
+    configuration.filter.maxHorizontalDeviation = 0.5;
+
+    TrajectoryPipeline pipeline(fixtureConverter(), configuration);
+    Collector collector;
+    pipeline.run(solutions, collector.sink());
+    BOOST_REQUIRE_EQUAL(9, collector.result.size());
+    BOOST_TEST(collector.result.time[4] == solutions[5].time);
+}
+
+BOOST_AUTO_TEST_CASE(trajectory_pipeline_decimates_across_chunks) {
+    auto solutions = fixtureSolutions(1000);
+    auto configuration = fixtureConfiguration();
+    configuration.decimation.minPeriod = base::Time::fromMilliseconds(1000);
+
+    TrajectoryPipeline pipeline(fixtureConverter(), configuration);
+    Collector collector;
+    auto statistics = pipeline.run(solutions, collector.sink());
+    BOOST_REQUIRE_EQUAL(100, collector.result.size());
+    for (size_t i = 0; i < 100; ++i) {
+        BOOST_TEST(collector.result.time[i] == solutions[i * 10].time);
+    }
+    BOOST_TEST(statistics.decimate.input == 1000);
+    BOOST_TEST(statistics.decimate.output == 100);
+}
+
+BOOST_AUTO_TEST_CASE(trajectory_pipeline_decimates_on_distance) {
+    auto solutions = fixtureSolutions(100);
+    auto configuration = fixtureConfiguration();
+    configuration.decimation.minDistance = 1;
+
+    TrajectoryPipeline pipeline(fixtureConverter(), configuration);
+    Collector collector;
+    pipeline.run(solutions, collector.sink());
+    BOOST_REQUIRE(collector.result.size() > 1);
+    BOOST_REQUIRE(collector.result.size() < 100);
+    for (size_t i = 1; i < collector.result.size(); ++i) {
+        double dx = collector.result.x[i] - collector.result.x[i - 1];
+        double dy = collector.result.y[i] - collector.result.y[i - 1];
+        BOOST_TEST(dx * dx + dy * dy >= 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(trajectory_pipeline_reads_logs_block_by_block) {
+    char tmpl[] = "/tmp/gps_base_test_TrajectoryPipeline_XXXXXX";
+    int fd = mkstemp(tmpl);
+    ::close(fd);
+    string path = tmpl;
+
+    auto solutions = fixtureSolutions(1000);
+    {
+        SolutionLogWriter writer(path, 64);
+        for (auto const& s : solutions) {
+            writer.write(s);
+        }
+    }
+
+    SolutionLogReader log(path);
+    TrajectoryPipeline pipeline(fixtureConverter(), fixtureConfiguration());
+    Collector collector;
+    auto statistics = pipeline.run(log, collector.sink());
+    remove(path.c_str());
+
+    BOOST_TEST(statistics.chunks == 16);
+    BOOST_REQUIRE_EQUAL(1000, collector.result.size());
+    for (size_t i = 0; i < solutions.size(); ++i) {
+        BOOST_TEST(collector.result.time[i] == solutions[i].time);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(trajectory_pipeline_bounds_the_number_of_chunks_in_flight) {
+    auto solutions = fixtureSolutions(1000);
+    auto configuration = fixtureConfiguration();
+    configuration.maxChunksInFlight = 1;
+    configuration.chunkSize = 10;
+
+    TrajectoryPipeline pipeline(fixtureConverter(), configuration);
+    Collector collector;
+    pipeline.run(solutions, collector.sink());
+    BOOST_TEST(collector.result.size() == 1000);
+}
+
+BOOST_AUTO_TEST_CASE(trajectory_pipeline_propagates_exceptions_from_the_sink) {
+    auto solutions = fixtureSolutions(1000);
+    TrajectoryPipeline pipeline(fixtureConverter(), fixtureConfiguration());
+    int calls = 0;
+    BOOST_REQUIRE_THROW(
+        pipeline.run(solutions, [&calls](TrajectoryColumns const&) {
+            if (++calls == 3) {
+                throw runtime_error("sink failure");
+            }
+        }),
+        runtime_error);
+    BOOST_TEST(calls == 3);
+}
+
+BOOST_AUTO_TEST_CASE(trajectory_pipeline_handles_an_empty_input) {
+    TrajectoryPipeline pipeline(fixtureConverter(), fixtureConfiguration());
+    Collector collector;
+    auto statistics = pipeline.run(vector<Solution>(), collector.sink());
+    BOOST_TEST(statistics.chunks == 0);
+    BOOST_TEST(collector.result.size() == 0);
+}
@@ -280,3 +280,377 @@ BOOST_AUTO_TEST_CASE(the_convertion_methods_return_an_invalid_RBS_with_timestamp
     BOOST_REQUIRE(!pos.hasValidPosition());
 }
 
+
+BOOST_AUTO_TEST_CASE(it_converts_a_set_of_solutions_at_once)
+{
+    vector<Solution> solutions;
+    solutions.push_back(fixtureSolution(base::Time::fromMicroseconds(1)));
+    solutions.push_back(fixtureSolution(base::Time::fromMicroseconds(2)));
+    solutions.back().positionType = gps_base::NO_SOLUTION;
+    solutions.push_back(fixtureSolution(base::Time::fromMicroseconds(3)));
+    solutions.back().latitude += 0.01;
+
+    gps_base::UTMConverter converter;
+    converter.setUTMZone(24);
+    converter.setUTMNorth(false);
+    converter.setNWUOrigin(base::Position(8550000, 400000, 0));
+
+    auto utm = converter.convertToUTM(solutions);
+    auto nwu = converter.convertToNWU(solutions);
+    BOOST_REQUIRE_EQUAL(3, utm.size());
+    BOOST_REQUIRE_EQUAL(3, nwu.size());
+    for (size_t i = 0; i < solutions.size(); ++i) {
+        auto expectedUTM = converter.convertToUTM(solutions[i]);
+        auto expectedNWU = converter.convertToNWU(solutions[i]);
+        BOOST_REQUIRE_EQUAL(solutions[i].time, utm[i].time);
+        BOOST_REQUIRE_EQUAL(solutions[i].time, nwu[i].time);
+        if (i == 1) {
+            BOOST_REQUIRE(!utm[i].hasValidPosition());
+            BOOST_REQUIRE(!nwu[i].hasValidPosition());
+            continue;
+        }
+        for (int j = 0; j < 3; ++j) {
+            BOOST_REQUIRE_CLOSE(expectedUTM.position(j), utm[i].position(j), 1e-9);
+            BOOST_REQUIRE_CLOSE(expectedNWU.position(j), nwu[i].position(j), 1e-9);
+            BOOST_REQUIRE_CLOSE(expectedUTM.cov_position(j, j), utm[i].cov_position(j, j), 1e-9);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(it_converts_arrays_of_coordinates)
+{
+    auto solution = fixtureSolution();
+    double latitudes[2] = { solution.latitude, solution.latitude };
+    double longitudes[2] = { solution.longitude, solution.longitude };
+    double altitudes[2] = { solution.altitude, solution.altitude + 1 };
+    double eastings[2], northings[2], heights[2];
+
+    gps_base::UTMConverter converter;
+    converter.setUTMZone(24);
+    converter.setUTMNorth(false);
+    converter.convertToUTM(2, latitudes, longitudes, altitudes,
+                           eastings, northings, heights);
+    for (int i = 0; i < 2; ++i) {
+        BOOST_REQUIRE_CLOSE(eastings[i], 537956.57943, 0.0001);
+        BOOST_REQUIRE_CLOSE(northings[i], 8556494.7274, 0.0001);
+    }
+    BOOST_REQUIRE_CLOSE(heights[0], 2, 0.0001);
+    BOOST_REQUIRE_CLOSE(heights[1], 3, 0.0001);
+}
+
+BOOST_AUTO_TEST_CASE(it_converts_arrays_of_coordinates_into_floats_relative_to_an_anchor)
+{
+    auto solution = fixtureSolution();
+    size_t count = 2500;
+    vector<double> latitudes, longitudes, altitudes;
+    for (size_t i = 0; i < count; ++i) {
+        latitudes.push_back(solution.latitude + 1e-6 * i);
+        longitudes.push_back(solution.longitude - 2e-6 * i);
+        altitudes.push_back(solution.altitude + 0.01 * i);
+    }
+
+    gps_base::UTMConverter converter;
+    converter.setUTMZone(24);
+    converter.setUTMNorth(false);
+    converter.setNWUOrigin(base::Position(8556000, -537000, 0));
+    vector<double> x(count), y(count), z(count);
+    converter.convertToNWU(count, latitudes.data(), longitudes.data(), altitudes.data(),
+                           x.data(), y.data(), z.data());
+
+    base::Position anchor(x[count / 2], y[count / 2], 0);
+    vector<float> xyz(3 * count);
+    auto report = converter.convertToNWUFloat(
+        count, latitudes.data(), longitudes.data(), altitudes.data(),
+        xyz.data(), 1e-3, anchor);
+    BOOST_TEST(report.count == count);
+    BOOST_TEST(report.range == 1e-3 * (1 << 24));
+    BOOST_TEST(report.invalid == 0);
+    BOOST_TEST(report.outOfRange == 0);
+    BOOST_TEST(report.firstOutOfRange == count);
+    BOOST_TEST(report.isWithinTolerance());
+    BOOST_TEST(report.maxCoordinate > 100);
+    for (size_t i = 0; i < count; ++i) {
+        BOOST_TEST(fabs(xyz[3 * i] - (x[i] - anchor.x())) < 1e-3);
+        BOOST_TEST(fabs(xyz[3 * i + 1] - (y[i] - anchor.y())) < 1e-3);
+        BOOST_TEST(fabs(xyz[3 * i + 2] - z[i]) < 1e-3);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(the_float_conversion_reports_the_points_beyond_its_range)
+{
+    auto solution = fixtureSolution();
+    double latitudes[4] = { solution.latitude, solution.latitude + 0.5,
+                            NAN, solution.latitude + 1 };
+    double longitudes[4] = { solution.longitude, solution.longitude,
+                             solution.longitude, solution.longitude };
+    double altitudes[4] = { 0, 0, 0, 0 };
+    float xyz[12];
+
+    gps_base::UTMConverter converter;
+    converter.setUTMZone(24);
+    converter.setUTMNorth(false);
+    auto utm = converter.convertToUTM(solution);
+    base::Position anchor = converter.convertToNWU(utm).position;
+
+    // A 1mm tolerance gives a range of about 16.7km, the second and last
+    // points are 55km and 110km away
+    auto report = converter.convertToNWUFloat(
+        4, latitudes, longitudes, altitudes, xyz, 1e-3, anchor);
+    BOOST_TEST(report.invalid == 1);
+    BOOST_TEST(report.outOfRange == 2);
+    BOOST_TEST(report.firstOutOfRange == 1);
+    BOOST_TEST(!report.isWithinTolerance());
+    BOOST_TEST(report.maxCoordinate > 100000);
+    BOOST_TEST(std::isnan(xyz[6]));
+    BOOST_TEST(fabs(xyz[0]) < 1e-3);
+
+    report = converter.convertToNWUFloat(
+        4, latitudes, longitudes, altitudes, xyz, 0.01, anchor);
+    BOOST_TEST(report.outOfRange == 0);
+    BOOST_TEST(report.firstOutOfRange == 4);
+}
+
+BOOST_AUTO_TEST_CASE(the_float_conversion_rejects_a_non_positive_tolerance)
+{
+    double latitude = -13, longitude = -38, altitude = 0;
+    float xyz[3];
+    gps_base::UTMConverter converter;
+    BOOST_REQUIRE_THROW(converter.convertToNWUFloat(1, &latitude, &longitude, &altitude,
+                                                    xyz, 0),
+                        std::invalid_argument);
+    BOOST_REQUIRE_THROW(converter.convertToNWUFloat(1, &latitude, &longitude, &altitude,
+                                                    xyz, NAN),
+                        std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(it_computes_the_grid_convergence_and_scale)
+{
+    auto solution = fixtureSolution();
+
+    gps_base::UTMConverter converter;
+    converter.setUTMZone(24);
+    converter.setUTMNorth(false);
+
+    // Reference values from PROJ's factors
+    auto grid = converter.getGridProperties(solution.latitude, solution.longitude);
+    BOOST_TEST(grid.convergence * 180 / M_PI == -0.07909734019005563,
+               boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(grid.scale == 0.9996178218087347,
+               boost::test_tools::tolerance(1e-12));
+
+    auto central = converter.getGridProperties(solution.latitude, -39);
+    BOOST_TEST(central.convergence == 0, boost::test_tools::tolerance(1e-15));
+    BOOST_TEST(central.scale == 0.9996, boost::test_tools::tolerance(1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(the_grid_conversion_matches_the_legacy_conversion)
+{
+    vector<Solution> solutions;
+    for (int i = 0; i < 10; ++i) {
+        auto solution = fixtureSolution();
+        solution.latitude = -79 + 17 * i;
+        solution.longitude = -41.9 + 0.6 * i;
+        solutions.push_back(solution);
+    }
+
+    for (int north = 0; north < 2; ++north) {
+        gps_base::UTMConverter converter;
+        converter.setUTMZone(24);
+        converter.setUTMNorth(north);
+        for (auto const& solution : solutions) {
+            auto expected = converter.convertToUTM(solution);
+            auto actual = converter.convertToUTMWithGrid(solution);
+            BOOST_TEST(actual.position.x() == expected.position.x(),
+                       boost::test_tools::tolerance(1e-12));
+            BOOST_TEST(actual.position.y() == expected.position.y(),
+                       boost::test_tools::tolerance(1e-12));
+            BOOST_TEST(actual.position.z() == expected.position.z());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(the_grid_conversion_rotates_and_scales_the_covariance)
+{
+    auto solution = fixtureSolution();
+
+    gps_base::UTMConverter converter;
+    converter.setUTMZone(24);
+    converter.setUTMNorth(false);
+
+    auto grid = converter.getGridProperties(solution.latitude, solution.longitude);
+    Eigen::Matrix3d local = Eigen::Vector3d(0.33 * 0.33, 0.2 * 0.2, 0.27 * 0.27).asDiagonal();
+    Eigen::Matrix3d jacobian = grid.getJacobian();
+    Eigen::Matrix3d expected = jacobian * local * jacobian.transpose();
+
+    auto pos = converter.convertToUTMWithGrid(solution);
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            BOOST_TEST(pos.cov_position(i, j) == expected(i, j),
+                       boost::test_tools::tolerance(1e-12));
+        }
+    }
+    BOOST_TEST(pos.cov_position(0, 1) != 0);
+    BOOST_TEST(pos.cov_position(0, 1) == pos.cov_position(1, 0));
+
+    auto back = converter.convertUTMToGPSWithGrid(pos);
+    BOOST_TEST(back.latitude == solution.latitude, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(back.longitude == solution.longitude, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(back.altitude == solution.altitude);
+    BOOST_TEST(back.deviationLatitude == 0.2, boost::test_tools::tolerance(1e-6));
+    BOOST_TEST(back.deviationLongitude == 0.33, boost::test_tools::tolerance(1e-6));
+    BOOST_TEST(back.deviationAltitude == 0.27, boost::test_tools::tolerance(1e-6));
+}
+
+BOOST_AUTO_TEST_CASE(the_grid_conversion_rotates_the_orientation)
+{
+    auto solution = fixtureSolution();
+
+    gps_base::UTMConverter converter;
+    converter.setUTMZone(24);
+    converter.setUTMNorth(false);
+    auto grid = converter.getGridProperties(solution.latitude, solution.longitude);
+
+    // A heading of 30 degrees from east in the local ENU frame
+    base::Orientation heading(Eigen::AngleAxisd(M_PI / 6, Eigen::Vector3d::UnitZ()));
+    auto utm = converter.convertToUTMWithGrid(solution, heading);
+    BOOST_TEST(base::getYaw(utm.orientation) == M_PI / 6 + grid.convergence,
+               boost::test_tools::tolerance(1e-12));
+
+    // The same heading is 30 - 90 degrees from north in NWU
+    base::Orientation nwuHeading(Eigen::AngleAxisd(-M_PI / 3, Eigen::Vector3d::UnitZ()));
+    auto nwu = converter.convertToNWUWithGrid(solution, nwuHeading);
+    BOOST_TEST(base::getYaw(nwu.orientation) == -M_PI / 3 + grid.convergence,
+               boost::test_tools::tolerance(1e-12));
+
+    base::Orientation local;
+    converter.convertUTMToGPSWithGrid(utm, &local);
+    BOOST_TEST(local.angularDistance(heading) == 0, boost::test_tools::tolerance(1e-12));
+    converter.convertNWUToGPSWithGrid(nwu, &local);
+    BOOST_TEST(local.angularDistance(nwuHeading) == 0, boost::test_tools::tolerance(1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(the_grid_conversion_returns_the_timestamp_only_if_there_is_no_solution)
+{
+    auto time = base::Time::now();
+    auto solution = fixtureSolution(time);
+    solution.positionType = gps_base::NO_SOLUTION;
+
+    gps_base::UTMConverter converter;
+    auto pos = converter.convertToUTMWithGrid(solution);
+    BOOST_REQUIRE_EQUAL(time, pos.time);
+    BOOST_REQUIRE(!pos.hasValidPosition());
+    pos = converter.convertToNWUWithGrid(solution);
+    BOOST_REQUIRE_EQUAL(time, pos.time);
+    BOOST_REQUIRE(!pos.hasValidPosition());
+}
+
+BOOST_AUTO_TEST_CASE(the_grid_conversion_handles_arrays_of_coordinates)
+{
+    auto solution = fixtureSolution();
+    double latitudes[2] = { solution.latitude, solution.latitude + 1 };
+    double longitudes[2] = { solution.longitude, solution.longitude };
+    double altitudes[2] = { solution.altitude, solution.altitude + 1 };
+    double eastings[2], northings[2], heights[2], convergences[2], scales[2];
+
+    gps_base::UTMConverter converter;
+    converter.setUTMZone(24);
+    converter.setUTMNorth(false);
+    converter.convertToUTMWithGrid(2, latitudes, longitudes, altitudes,
+                                   eastings, northings, heights,
+                                   convergences, scales);
+    for (int i = 0; i < 2; ++i) {
+        solution.latitude = latitudes[i];
+        solution.altitude = altitudes[i];
+        auto expected = converter.convertToUTMWithGrid(solution);
+        auto grid = converter.getGridProperties(latitudes[i], longitudes[i]);
+        BOOST_TEST(eastings[i] == expected.position.x());
+        BOOST_TEST(northings[i] == expected.position.y());
+        BOOST_TEST(heights[i] == expected.position.z());
+        BOOST_TEST(convergences[i] == grid.convergence);
+        BOOST_TEST(scales[i] == grid.scale);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(the_NWU_conversion_rotates_the_full_state)
+{
+    base::samples::RigidBodyState utm;
+    utm.position = base::Position(500000, 100000, 0);
+    utm.velocity = base::Vector3d(1, 2, 3);
+    utm.orientation = base::Orientation(Eigen::AngleAxisd(0.1, Eigen::Vector3d::UnitZ()));
+    utm.cov_position << 1, 2, 3,
+                        2, 4, 5,
+                        3, 5, 6;
+    utm.cov_velocity = utm.cov_position * 2;
+
+    gps_base::UTMConverter converter;
+    auto nwu = converter.convertToNWU(utm);
+    BOOST_TEST(nwu.velocity.x() == 2);
+    BOOST_TEST(nwu.velocity.y() == -1);
+    BOOST_TEST(nwu.velocity.z() == 3);
+    BOOST_TEST(base::getYaw(nwu.orientation) == 0.1 - M_PI / 2,
+               boost::test_tools::tolerance(1e-12));
+
+    Eigen::Matrix3d rotation = Eigen::AngleAxisd(-M_PI / 2, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+    Eigen::Matrix3d expected = rotation * utm.cov_position * rotation.transpose();
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            BOOST_TEST(nwu.cov_position(i, j) == expected(i, j),
+                       boost::test_tools::tolerance(1e-12));
+            BOOST_TEST(nwu.cov_velocity(i, j) == 2 * expected(i, j),
+                       boost::test_tools::tolerance(1e-12));
+        }
+    }
+
+    auto back = converter.convertNWUToUTM(nwu);
+    BOOST_REQUIRE(back.velocity == utm.velocity);
+    BOOST_REQUIRE(back.cov_position == utm.cov_position);
+    BOOST_REQUIRE(back.cov_velocity == utm.cov_velocity);
+    BOOST_TEST(back.orientation.angularDistance(utm.orientation) == 0,
+               boost::test_tools::tolerance(1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(it_reports_the_instrumentation_counters)
+{
+    gps_base::UTMConverter converter;
+    UTMConverter::resetStatistics();
+
+    auto solution = fixtureSolution();
+    converter.convertToUTM(solution);
+    auto nwu = converter.convertToNWU(solution);
+    converter.convertNWUToGPS(nwu);
+    converter.convertUTMToGPSWithGrid(converter.convertToUTMWithGrid(solution));
+    converter.convertToUTM(vector<Solution>(3, solution));
+    solution.positionType = gps_base::NO_SOLUTION;
+    converter.convertToNWU(solution);
+    converter.setUTMZone(24);
+    gps_base::UTMConverter copy(converter);
+    for (unsigned int i = 0; i < 2 * UTMConverter::COST_SAMPLING_PERIOD; ++i) {
+        copy.convertToUTM(fixtureSolution());
+    }
+
+    auto statistics = UTMConverter::getStatistics(true);
+    BOOST_TEST(statistics.costHistogram.size() == UTMConverter::COST_HISTOGRAM_SIZE);
+    if (!statistics.enabled) {
+        BOOST_TEST(statistics.gpsToUTM == 0);
+        BOOST_TEST(statistics.sampledCalls == 0);
+        return;
+    }
+
+    BOOST_TEST(statistics.gpsToUTM == 1 + 1 + 3 + 2 * UTMConverter::COST_SAMPLING_PERIOD);
+    BOOST_TEST(statistics.gpsToNWU == 2);
+    BOOST_TEST(statistics.utmToGPS == 1);
+    BOOST_TEST(statistics.nwuToGPS == 1);
+    BOOST_TEST(statistics.transformRebuilds == 2);
+    BOOST_TEST(statistics.transformFailures == 0);
+    BOOST_TEST(statistics.invalidSamples == 1);
+    BOOST_TEST(statistics.sampledCalls >= 2);
+    uint64_t histogramTotal = 0;
+    for (auto count : statistics.costHistogram) {
+        histogramTotal += count;
+    }
+    BOOST_TEST(histogramTotal == statistics.sampledCalls);
+
+    statistics = UTMConverter::getStatistics();
+    BOOST_TEST(statistics.gpsToUTM == 0);
+    BOOST_TEST(statistics.sampledCalls == 0);
+}
@@ -0,0 +1,87 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/demux.hpp>
+
+#include <vector>
+
+using namespace gps_base;
+using namespace std;
+
+namespace {
+    const std::vector<uint8_t> RTCM =
+    {
+        0xd3, 0x00, 0x13, 0x3e, 0xd0, 0x00, 0x02, 0x36,
+        0xfd, 0xb8, 0x0d, 0xde, 0x08, 0x00, 0x5b, 0x2b,
+        0xc1, 0x08, 0xa7, 0xb9, 0x8d, 0x3d, 0xd8, 0xab, 0x37
+    };
+    const std::vector<uint8_t> UBX =
+    {
+        0xB5, 0x62, 0x01, 0x07, 0x04, 0x00, 0x10, 0x20, 0x30, 0x40, 0xAC, 0x91
+    };
+    const std::vector<uint8_t> SBF =
+    {
+        0x24, 0x40, 0x43, 0xa5, 0xa7, 0x0f, 0x10, 0x00,
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08
+    };
+
+    void append(std::vector<uint8_t>& buffer, std::vector<uint8_t> const& data) {
+        buffer.insert(buffer.end(), data.begin(), data.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(demux_getProtocol_maps_the_sync_bytes_to_their_protocol) {
+    BOOST_TEST(demux::getProtocol(0xD3) == demux::PROTOCOL_RTCM3);
+    BOOST_TEST(demux::getProtocol(0xB5) == demux::PROTOCOL_UBX);
+    BOOST_TEST(demux::getProtocol(0x24) == demux::PROTOCOL_SBF);
+    BOOST_TEST(demux::getProtocol(0x42) == demux::PROTOCOL_NONE);
+}
+
+BOOST_AUTO_TEST_CASE(demux_extractPacket_skips_up_to_the_next_possible_frame_start) {
+    std::vector<uint8_t> buffer = { 0x01, 0x02, 0x03, 0x04 };
+    append(buffer, UBX);
+    BOOST_TEST(demux::extractPacket(buffer.data(), buffer.size()) == -4);
+}
+
+BOOST_AUTO_TEST_CASE(demux_extractPacket_skips_the_whole_buffer_if_it_has_no_frame_start) {
+    std::vector<uint8_t> buffer = { 0x01, 0x02, 0x03, 0x04 };
+    BOOST_TEST(demux::extractPacket(buffer.data(), buffer.size()) == -4);
+}
+
+BOOST_AUTO_TEST_CASE(demux_extractPacket_skips_an_invalid_frame_up_to_the_next_possible_frame_start) {
+    std::vector<uint8_t> buffer = { 0xB5, 0x42, 0x01, 0x02 };
+    append(buffer, RTCM);
+    BOOST_TEST(demux::extractPacket(buffer.data(), buffer.size()) == -4);
+}
+
+BOOST_AUTO_TEST_CASE(demux_extractPacket_returns_0_on_an_incomplete_frame) {
+    BOOST_TEST(demux::extractPacket(SBF.data(), SBF.size() - 1) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(demux_extractPacket_returns_the_frame_size_and_protocol) {
+    demux::Protocol protocol = demux::PROTOCOL_NONE;
+    BOOST_TEST(demux::extractPacket(UBX.data(), UBX.size(), &protocol) ==
+               static_cast<int>(UBX.size()));
+    BOOST_TEST(protocol == demux::PROTOCOL_UBX);
+}
+
+BOOST_AUTO_TEST_CASE(demux_demultiplex_sorts_a_mixed_stream_into_tagged_frames) {
+    std::vector<uint8_t> buffer = { 0x01, 0x02 };
+    append(buffer, RTCM);
+    append(buffer, { '$', 'G', 'P', 'G', 'G', 'A', '\r', '\n' });
+    append(buffer, SBF);
+    append(buffer, UBX);
+    append(buffer, { 0xD3, 0x00 });
+
+    std::vector<demux::Frame> frames;
+    size_t consumed = demux::demultiplex(buffer.data(), buffer.size(), frames);
+    BOOST_TEST(consumed == buffer.size() - 2);
+    BOOST_REQUIRE(frames.size() == 3);
+    BOOST_TEST(frames[0].protocol == demux::PROTOCOL_RTCM3);
+    BOOST_TEST(frames[0].offset == 2);
+    BOOST_TEST(frames[0].size == RTCM.size());
+    BOOST_TEST(frames[1].protocol == demux::PROTOCOL_SBF);
+    BOOST_TEST(frames[1].offset == 2 + RTCM.size() + 8);
+    BOOST_TEST(frames[1].size == SBF.size());
+    BOOST_TEST(frames[2].protocol == demux::PROTOCOL_UBX);
+    BOOST_TEST(frames[2].offset == 2 + RTCM.size() + 8 + SBF.size());
+    BOOST_TEST(frames[2].size == UBX.size());
+}
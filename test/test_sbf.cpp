@@ -0,0 +1,58 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/sbf.hpp>
+
+#include <vector>
+
+using namespace gps_base;
+using namespace std;
+
+const std::vector<uint8_t> VALID_SBF =
+{
+    0x24, 0x40, 0x43, 0xa5, 0xa7, 0x0f, 0x10, 0x00,
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08
+};
+
+BOOST_AUTO_TEST_CASE(sbf_isPreamble_returns_true_if_the_buffer_starts_with_the_sync_sequence) {
+    BOOST_TEST(sbf::isPreamble(VALID_SBF.data(), 2));
+}
+
+BOOST_AUTO_TEST_CASE(sbf_isPreamble_returns_false_for_a_NMEA_sentence) {
+    std::vector<uint8_t> buffer = { '$', 'G', 'P' };
+    BOOST_TEST(!sbf::isPreamble(buffer.data(), 3));
+}
+
+BOOST_AUTO_TEST_CASE(sbf_isPreamble_throws_if_the_buffer_is_empty) {
+    uint8_t* buffer = nullptr;
+    BOOST_REQUIRE_THROW(sbf::isPreamble(buffer, 0), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(sbf_getLength_returns_the_block_length) {
+    BOOST_TEST(sbf::getLength(VALID_SBF.data(), 8) == 16);
+}
+
+BOOST_AUTO_TEST_CASE(sbf_getLength_throws_if_the_buffer_is_smaller_than_the_header) {
+    BOOST_REQUIRE_THROW(sbf::getLength(VALID_SBF.data(), 7), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(sbf_crc_computes_the_CCITT_crc) {
+    BOOST_TEST(sbf::crc(VALID_SBF.data() + 4, 12) == 0xA543);
+}
+
+BOOST_AUTO_TEST_CASE(sbf_extractPacket_returns_0_if_the_buffer_is_smaller_than_the_block_length) {
+    BOOST_TEST(sbf::extractPacket(VALID_SBF.data(), 15) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(sbf_extractPacket_returns_minus_one_if_the_length_is_not_a_multiple_of_4) {
+    std::vector<uint8_t> buffer = { 0x24, 0x40, 0x43, 0xa5, 0xa7, 0x0f, 0x11, 0x00 };
+    BOOST_TEST(sbf::extractPacket(buffer.data(), 8) == -1);
+}
+
+BOOST_AUTO_TEST_CASE(sbf_extractPacket_returns_minus_one_if_the_crc_fails) {
+    std::vector<uint8_t> buffer = VALID_SBF;
+    buffer[10] = 0x42;
+    BOOST_TEST(sbf::extractPacket(buffer.data(), 16) == -1);
+}
+
+BOOST_AUTO_TEST_CASE(sbf_extractPacket_returns_the_full_packet_length_if_the_crc_passes) {
+    BOOST_TEST(sbf::extractPacket(VALID_SBF.data(), 16) == 16);
+}
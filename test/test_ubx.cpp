@@ -0,0 +1,72 @@
+#include <boost/test/unit_test.hpp>
+#include <gps_base/ubx.hpp>
+
+#include <vector>
+
+using namespace gps_base;
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(ubx_isPreamble_returns_true_if_the_buffer_starts_with_the_sync_sequence) {
+    std::vector<uint8_t> buffer = { 0xB5, 0x62 };
+    BOOST_TEST(ubx::isPreamble(buffer.data(), 2));
+}
+
+BOOST_AUTO_TEST_CASE(ubx_isPreamble_returns_true_if_the_buffer_only_has_the_first_sync_byte) {
+    uint8_t sync = 0xB5;
+    BOOST_TEST(ubx::isPreamble(&sync, 1));
+}
+
+BOOST_AUTO_TEST_CASE(ubx_isPreamble_returns_false_if_the_second_sync_byte_does_not_match) {
+    std::vector<uint8_t> buffer = { 0xB5, 0x42 };
+    BOOST_TEST(!ubx::isPreamble(buffer.data(), 2));
+}
+
+BOOST_AUTO_TEST_CASE(ubx_isPreamble_throws_if_the_buffer_is_empty) {
+    uint8_t* buffer = nullptr;
+    BOOST_REQUIRE_THROW(ubx::isPreamble(buffer, 0), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(ubx_getLength_returns_the_little_endian_payload_length) {
+    std::vector<uint8_t> buffer = { 0xB5, 0x62, 0x01, 0x07, 0x13, 0x02 };
+    BOOST_TEST(ubx::getLength(buffer.data(), 6) == 531);
+}
+
+BOOST_AUTO_TEST_CASE(ubx_getLength_throws_if_the_buffer_is_smaller_than_the_header) {
+    std::vector<uint8_t> buffer = { 0xB5, 0x62, 0x01, 0x07, 0x13 };
+    BOOST_REQUIRE_THROW(ubx::getLength(buffer.data(), 5), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(ubx_checksum_computes_the_fletcher_checksum) {
+    std::vector<uint8_t> buffer = { 0x05, 0x01, 0x02, 0x00, 0x06, 0x01 };
+    BOOST_TEST(ubx::checksum(buffer.data(), 6) == 0x380F);
+}
+
+BOOST_AUTO_TEST_CASE(ubx_extractPacket_returns_0_if_the_buffer_is_empty) {
+    uint8_t* buffer = nullptr;
+    BOOST_TEST(ubx::extractPacket(buffer, 0) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(ubx_extractPacket_returns_minus_one_if_the_buffer_does_not_start_with_the_sync_sequence) {
+    std::vector<uint8_t> buffer = { 0xB5, 0x42, 0x05, 0x01 };
+    BOOST_TEST(ubx::extractPacket(buffer.data(), 4) == -1);
+}
+
+BOOST_AUTO_TEST_CASE(ubx_extractPacket_returns_0_if_the_buffer_is_smaller_than_the_packet_length) {
+    std::vector<uint8_t> buffer = { 0xB5, 0x62, 0x01, 0x07, 0x04, 0x00, 0x10, 0x20 };
+    BOOST_TEST(ubx::extractPacket(buffer.data(), 8) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(ubx_extractPacket_returns_minus_one_if_the_checksum_fails) {
+    std::vector<uint8_t> buffer = {
+        0xB5, 0x62, 0x01, 0x07, 0x04, 0x00, 0x10, 0x20, 0x30, 0x40, 0xAC, 0x92
+    };
+    BOOST_TEST(ubx::extractPacket(buffer.data(), 12) == -1);
+}
+
+BOOST_AUTO_TEST_CASE(ubx_extractPacket_returns_the_full_packet_length_if_the_checksum_passes) {
+    std::vector<uint8_t> buffer = {
+        0xB5, 0x62, 0x01, 0x07, 0x04, 0x00, 0x10, 0x20, 0x30, 0x40, 0xAC, 0x91,
+        0x00
+    };
+    BOOST_TEST(ubx::extractPacket(buffer.data(), 13) == 12);
+}